@@ -35,6 +35,7 @@
 #endif
 #endif
 #include <qt-wrappers.hpp>
+#include <util/source-profiler.h>
 
 #include <QCheckBox>
 #include <QDesktopServices>
@@ -74,6 +75,8 @@ extern bool opt_disable_updater;
 extern bool opt_disable_missing_files_check;
 extern string opt_starting_collection;
 extern string opt_starting_profile;
+extern string opt_telemetry_path;
+extern bool opt_telemetry_json;
 
 // GPU hint exports for AMD/NVIDIA laptops
 #ifdef _MSC_VER
@@ -352,6 +355,7 @@ void OBSApp::InitUserConfigDefaults()
 	config_set_default_string(userConfig, "General", "HotkeyFocusType", "NeverDisableHotkeys");
 
 	config_set_default_bool(userConfig, "BasicWindow", "PreviewEnabled", true);
+	config_set_default_double(userConfig, "BasicWindow", "PreviewMaxFPS", 0.0);
 	config_set_default_bool(userConfig, "BasicWindow", "PreviewProgramMode", false);
 	config_set_default_bool(userConfig, "BasicWindow", "SceneDuplicationMode", true);
 	config_set_default_bool(userConfig, "BasicWindow", "SwapScenesMode", true);
@@ -1138,7 +1142,15 @@ static bool StartupOBS(const char *locale, profiler_name_store_t *store)
 	if (GetAppConfigPath(path, sizeof(path), "obs-studio/plugin_config") <= 0)
 		return false;
 
-	return obs_startup(locale, path, store);
+	if (!obs_startup(locale, path, store))
+		return false;
+
+	if (!opt_telemetry_path.empty()) {
+		auto format = opt_telemetry_json ? PROFILER_EXPORT_JSON : PROFILER_EXPORT_PROMETHEUS;
+		source_profiler_export_start(opt_telemetry_path.c_str(), format, 1000);
+	}
+
+	return true;
 }
 
 inline void OBSApp::ResetHotkeyState(bool inFocus)
@@ -323,7 +323,6 @@ VolumeMeter::VolumeMeter(QWidget *parent, obs_source_t *source)
 	meterThickness = 3;                      // Bar thickness in pixels
 	channels = (int)audio_output_get_channels(obs_get_audio());
 
-	obs_volmeter_add_callback(obsVolumeMeter, obsVolMeterChanged, this);
 	obs_volmeter_attach_source(obsVolumeMeter, source);
 
 	destroyedSignal =
@@ -335,7 +334,15 @@ VolumeMeter::VolumeMeter(QWidget *parent, obs_source_t *source)
 		updateTimer->start(16);
 	}
 
+	// Levels are polled on redraw rather than pushed for every audio packet
 	connect(updateTimer, &QTimer::timeout, this, [this]() {
+		float magnitude[MAX_AUDIO_CHANNELS];
+		float peak[MAX_AUDIO_CHANNELS];
+		float inputPeak[MAX_AUDIO_CHANNELS];
+
+		if (obs_volmeter_get_levels(obsVolumeMeter, magnitude, peak, inputPeak))
+			setLevels(magnitude, peak, inputPeak);
+
 		if (needLayoutChange()) {
 			doLayout();
 			update();
@@ -357,7 +364,6 @@ VolumeMeter::VolumeMeter(QWidget *parent, obs_source_t *source)
 
 VolumeMeter::~VolumeMeter()
 {
-	obs_volmeter_remove_callback(obsVolumeMeter, obsVolMeterChanged, this);
 	obs_volmeter_detach_source(obsVolumeMeter);
 }
 
@@ -386,14 +392,6 @@ void VolumeMeter::setLevels(const float magnitude[MAX_AUDIO_CHANNELS], const flo
 	calculateBallistics(ts);
 }
 
-void VolumeMeter::obsVolMeterChanged(void *data, const float magnitude[MAX_AUDIO_CHANNELS],
-				     const float peak[MAX_AUDIO_CHANNELS], const float inputPeak[MAX_AUDIO_CHANNELS])
-{
-	VolumeMeter *meter = static_cast<VolumeMeter *>(data);
-
-	meter->setLevels(magnitude, peak, inputPeak);
-}
-
 inline void VolumeMeter::resetLevels()
 {
 	currentLastUpdateTime = 0;
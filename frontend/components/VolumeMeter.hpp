@@ -49,9 +49,6 @@ private:
 
 	static QPointer<QTimer> updateTimer;
 
-	static void obsVolMeterChanged(void *data, const float magnitude[MAX_AUDIO_CHANNELS],
-				       const float peak[MAX_AUDIO_CHANNELS], const float inputPeak[MAX_AUDIO_CHANNELS]);
-
 	OBSSignal destroyedSignal;
 	static void obsSourceDestroyed(void *data, calldata_t *);
 
@@ -77,6 +77,8 @@ bool opt_disable_missing_files_check = false;
 string opt_starting_collection;
 string opt_starting_profile;
 string opt_starting_scene;
+string opt_telemetry_path;
+bool opt_telemetry_json = false;
 
 bool restart = false;
 bool restart_safe = false;
@@ -989,6 +991,16 @@ int main(int argc, char *argv[])
 		} else if (arg_is(argv[i], "--disable-missing-files-check", nullptr)) {
 			opt_disable_missing_files_check = true;
 
+		} else if (arg_is(argv[i], "--telemetry", nullptr)) {
+			if (++i < argc)
+				opt_telemetry_path = argv[i];
+
+		} else if (arg_is(argv[i], "--telemetry-json", nullptr)) {
+			if (++i < argc) {
+				opt_telemetry_path = argv[i];
+				opt_telemetry_json = true;
+			}
+
 		} else if (arg_is(argv[i], "--steam", nullptr)) {
 			steam = true;
 
@@ -1015,7 +1027,9 @@ int main(int argc, char *argv[])
 				"--always-on-top: Start in 'always on top' mode.\n\n"
 				"--unfiltered_log: Make log unfiltered.\n\n"
 				"--disable-updater: Disable built-in updater (Windows/Mac only)\n\n"
-				"--disable-missing-files-check: Disable the missing files dialog which can appear on startup.\n\n";
+				"--disable-missing-files-check: Disable the missing files dialog which can appear on startup.\n\n"
+				"--telemetry <file>: Write per-source costs to a Prometheus text file every second.\n"
+				"--telemetry-json <file>: Append per-source costs to an NDJSON file every second.\n\n";
 
 #ifdef _WIN32
 			MessageBoxA(NULL, help.c_str(), "Help", MB_OK | MB_ICONASTERISK);
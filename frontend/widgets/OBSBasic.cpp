@@ -1138,6 +1138,8 @@ void OBSBasic::OBSInit()
 
 	auto addDisplay = [this](OBSQTDisplay *window) {
 		obs_display_add_draw_callback(window->GetDisplay(), OBSBasic::RenderMain, this);
+		obs_display_set_max_fps(window->GetDisplay(),
+					config_get_double(App()->GetUserConfig(), "BasicWindow", "PreviewMaxFPS"));
 
 		struct obs_video_info ovi;
 		if (obs_get_video_info(&ovi))
@@ -80,6 +80,8 @@ OBSBasicStats::OBSBasicStats(QWidget *parent, bool closable)
 	hddSpace = new QLabel(this);
 	recordTimeLeft = new QLabel(this);
 	memUsage = new QLabel(this);
+	outputRenderTime = new QLabel(this);
+	displayRenderTime = new QLabel(this);
 
 	QString str = MakeTimeLeftText(99999, 59);
 	int textWidth = recordTimeLeft->fontMetrics().boundingRect(str).width();
@@ -89,6 +91,8 @@ OBSBasicStats::OBSBasicStats(QWidget *parent, bool closable)
 	newStat("HDDSpaceAvailable", hddSpace, 0);
 	newStat("DiskFullIn", recordTimeLeft, 0);
 	newStat("MemoryUsage", memUsage, 0);
+	newStat("AverageTimeToRenderOutput", outputRenderTime, 0);
+	newStat("AverageTimeToRenderDisplays", displayRenderTime, 0);
 
 	fps = new QLabel(this);
 	renderTime = new QLabel(this);
@@ -351,6 +355,16 @@ void OBSBasicStats::Update()
 	else
 		setClasses(renderTime, "");
 
+	num = (long double)obs_get_average_output_render_time_ns() / 1000000.0l;
+	outputRenderTime->setText(QString::number(num, 'f', 1) + QStringLiteral(" ms"));
+
+	num = (long double)obs_get_average_display_render_time_ns() / 1000000.0l;
+	str = QString::number(num, 'f', 1) + QStringLiteral(" ms");
+	if (uint32_t skipped = obs_get_skipped_display_frames())
+		str += QStringLiteral(" (") + QTStr("Basic.Stats.DisplayFramesSkipped").arg(skipped) +
+		       QStringLiteral(")");
+	displayRenderTime->setText(str);
+
 	/* ------------------ */
 
 	video_t *video = obs_get_video();
@@ -21,6 +21,8 @@ class OBSBasicStats : public QFrame {
 	QLabel *memUsage = nullptr;
 
 	QLabel *renderTime = nullptr;
+	QLabel *outputRenderTime = nullptr;
+	QLabel *displayRenderTime = nullptr;
 	QLabel *skippedFrames = nullptr;
 	QLabel *missedFrames = nullptr;
 
@@ -72,6 +72,8 @@ OBSProjector::OBSProjector(QWidget *widget, obs_source_t *source_, int monitor,
 		bool isMultiview = type == ProjectorType::Multiview;
 		obs_display_add_draw_callback(GetDisplay(), isMultiview ? OBSRenderMultiview : OBSRender, this);
 		obs_display_set_background_color(GetDisplay(), 0x000000);
+		obs_display_set_max_fps(GetDisplay(),
+					config_get_double(App()->GetUserConfig(), "BasicWindow", "PreviewMaxFPS"));
 	};
 
 	connect(this, &OBSQTDisplay::DisplayCreated, this, addDrawCallback);
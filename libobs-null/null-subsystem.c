@@ -0,0 +1,1011 @@
+/******************************************************************************
+    Copyright (C) 2026 by agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <util/base.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <graphics/vec2.h>
+#include <graphics/vec3.h>
+#include <graphics/vec4.h>
+#include "null-subsystem.h"
+
+const char *device_get_name(void)
+{
+	return "Null";
+}
+
+int device_get_type(void)
+{
+	return GS_DEVICE_NULL;
+}
+
+const char *device_preprocessor_name(void)
+{
+	return "_NULL";
+}
+
+int device_create(gs_device_t **p_device, uint32_t adapter)
+{
+	struct gs_device *device = bzalloc(sizeof(struct gs_device));
+
+	blog(LOG_INFO, "---------------------------------");
+	blog(LOG_INFO, "Initializing null renderer, only sprites will be drawn");
+
+	const char *latency = getenv("OBS_NULL_READBACK_LATENCY_MS");
+	if (latency && *latency) {
+		device->readback_latency_ns = (uint64_t)(strtod(latency, NULL) * 1000000.0);
+		blog(LOG_INFO, "Simulating %g ms of readback latency", (double)device->readback_latency_ns / 1000000.0);
+	}
+
+	device->cur_color_space = GS_CS_SRGB;
+	device->cur_blend_enabled = true;
+	device->cur_blend_src_c = GS_BLEND_ONE;
+	device->cur_blend_dest_c = GS_BLEND_ZERO;
+	device->cur_blend_src_a = GS_BLEND_ONE;
+	device->cur_blend_dest_a = GS_BLEND_ZERO;
+	matrix4_identity(&device->cur_proj);
+	matrix4_identity(&device->cur_view);
+	matrix4_identity(&device->cur_viewproj);
+
+	*p_device = device;
+	UNUSED_PARAMETER(adapter);
+	return GS_SUCCESS;
+}
+
+void device_destroy(gs_device_t *device)
+{
+	if (!device)
+		return;
+
+	const struct gs_null_stats *stats = &device->stats;
+
+	blog(LOG_INFO,
+	     "Null renderer: %" PRIu64 " frames, %" PRIu64 " draw calls (%" PRIu64 " sprites rasterized), %" PRIu64
+	     " vertices, %" PRIu64 " clears, %" PRIu64 " texture copies (%" PRIu64 " bytes), %" PRIu64
+	     " stages, %" PRIu64 " stage maps (%.1f ms waiting), %" PRIu64 " presents",
+	     stats->frames, stats->draw_calls, stats->sprites_rasterized, stats->vertices, stats->clears,
+	     stats->texture_copies, stats->bytes_copied, stats->texture_stages, stats->stage_maps,
+	     (double)stats->stage_map_wait_ns / 1000000.0, stats->presents);
+
+	da_free(device->proj_stack);
+	bfree(device);
+}
+
+void device_enter_context(gs_device_t *device)
+{
+	UNUSED_PARAMETER(device);
+}
+
+void device_leave_context(gs_device_t *device)
+{
+	UNUSED_PARAMETER(device);
+}
+
+void *device_get_device_obj(gs_device_t *device)
+{
+	return &device->stats;
+}
+
+gs_swapchain_t *device_swapchain_create(gs_device_t *device, const struct gs_init_data *info)
+{
+	struct gs_swap_chain *swap = bzalloc(sizeof(struct gs_swap_chain));
+
+	swap->device = device;
+	swap->info = *info;
+	return swap;
+}
+
+void device_resize(gs_device_t *device, uint32_t cx, uint32_t cy)
+{
+	if (!device->cur_swap) {
+		blog(LOG_WARNING, "device_resize (null): No active swap");
+		return;
+	}
+
+	device->cur_swap->info.cx = cx;
+	device->cur_swap->info.cy = cy;
+}
+
+enum gs_color_space device_get_color_space(gs_device_t *device)
+{
+	return device->cur_color_space;
+}
+
+void device_update_color_space(gs_device_t *device)
+{
+	UNUSED_PARAMETER(device);
+}
+
+void device_get_size(const gs_device_t *device, uint32_t *cx, uint32_t *cy)
+{
+	if (device->cur_swap) {
+		*cx = device->cur_swap->info.cx;
+		*cy = device->cur_swap->info.cy;
+	} else {
+		*cx = 0;
+		*cy = 0;
+	}
+}
+
+uint32_t device_get_width(const gs_device_t *device)
+{
+	return device->cur_swap ? device->cur_swap->info.cx : 0;
+}
+
+uint32_t device_get_height(const gs_device_t *device)
+{
+	return device->cur_swap ? device->cur_swap->info.cy : 0;
+}
+
+gs_samplerstate_t *device_samplerstate_create(gs_device_t *device, const struct gs_sampler_info *info)
+{
+	struct gs_sampler_state *sampler = bzalloc(sizeof(struct gs_sampler_state));
+
+	sampler->device = device;
+	sampler->info = *info;
+	return sampler;
+}
+
+gs_timer_t *device_timer_create(gs_device_t *device)
+{
+	UNUSED_PARAMETER(device);
+	return bzalloc(sizeof(struct gs_timer));
+}
+
+gs_timer_range_t *device_timer_range_create(gs_device_t *device)
+{
+	struct gs_timer_range *range = bzalloc(sizeof(struct gs_timer_range));
+
+	range->device = device;
+	return range;
+}
+
+enum gs_texture_type device_get_texture_type(const gs_texture_t *texture)
+{
+	return texture->type;
+}
+
+void device_load_vertexbuffer(gs_device_t *device, gs_vertbuffer_t *vertbuffer)
+{
+	device->cur_vertex_buffer = vertbuffer;
+}
+
+void device_load_indexbuffer(gs_device_t *device, gs_indexbuffer_t *indexbuffer)
+{
+	device->cur_index_buffer = indexbuffer;
+}
+
+void device_load_texture(gs_device_t *device, gs_texture_t *tex, int unit)
+{
+	device->cur_textures[unit] = tex;
+}
+
+void device_load_texture_srgb(gs_device_t *device, gs_texture_t *tex, int unit)
+{
+	device->cur_textures[unit] = tex;
+}
+
+void device_load_samplerstate(gs_device_t *device, gs_samplerstate_t *samplerstate, int unit)
+{
+	device->cur_samplers[unit] = samplerstate;
+}
+
+void device_load_vertexshader(gs_device_t *device, gs_shader_t *vertshader)
+{
+	if (vertshader && vertshader->type != GS_SHADER_VERTEX) {
+		blog(LOG_ERROR, "device_load_vertexshader (null): Specified shader is not a vertex shader");
+		return;
+	}
+
+	device->cur_vertex_shader = vertshader;
+}
+
+void device_load_pixelshader(gs_device_t *device, gs_shader_t *pixelshader)
+{
+	if (pixelshader && pixelshader->type != GS_SHADER_PIXEL) {
+		blog(LOG_ERROR, "device_load_pixelshader (null): Specified shader is not a pixel shader");
+		return;
+	}
+
+	device->cur_pixel_shader = pixelshader;
+}
+
+void device_load_default_samplerstate(gs_device_t *device, bool b_3d, int unit)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(b_3d);
+	UNUSED_PARAMETER(unit);
+}
+
+gs_shader_t *device_get_vertex_shader(const gs_device_t *device)
+{
+	return device->cur_vertex_shader;
+}
+
+gs_shader_t *device_get_pixel_shader(const gs_device_t *device)
+{
+	return device->cur_pixel_shader;
+}
+
+gs_texture_t *device_get_render_target(const gs_device_t *device)
+{
+	return device->cur_render_target;
+}
+
+gs_zstencil_t *device_get_zstencil_target(const gs_device_t *device)
+{
+	return device->cur_zstencil_buffer;
+}
+
+void device_set_render_target(gs_device_t *device, gs_texture_t *tex, gs_zstencil_t *zstencil)
+{
+	device_set_render_target_with_color_space(device, tex, zstencil, GS_CS_SRGB);
+}
+
+void device_set_render_target_with_color_space(gs_device_t *device, gs_texture_t *tex, gs_zstencil_t *zstencil,
+					       enum gs_color_space space)
+{
+	if (tex && tex->type != GS_TEXTURE_2D) {
+		blog(LOG_ERROR, "device_set_render_target (null): Texture is not a 2D texture");
+		return;
+	}
+
+	if (tex && !tex->is_render_target) {
+		blog(LOG_ERROR, "device_set_render_target (null): Texture is not a render target");
+		return;
+	}
+
+	device->cur_render_target = tex;
+	device->cur_render_side = 0;
+	device->cur_zstencil_buffer = zstencil;
+	device->cur_color_space = space;
+}
+
+void device_set_cube_render_target(gs_device_t *device, gs_texture_t *cubetex, int side, gs_zstencil_t *zstencil)
+{
+	if (cubetex && cubetex->type != GS_TEXTURE_CUBE) {
+		blog(LOG_ERROR, "device_set_cube_render_target (null): Texture is not a cube texture");
+		return;
+	}
+
+	device->cur_render_target = cubetex;
+	device->cur_render_side = side;
+	device->cur_zstencil_buffer = zstencil;
+	device->cur_color_space = GS_CS_SRGB;
+}
+
+void device_enable_framebuffer_srgb(gs_device_t *device, bool enable)
+{
+	device->cur_fb_srgb = enable;
+}
+
+bool device_framebuffer_srgb_enabled(gs_device_t *device)
+{
+	return device->cur_fb_srgb;
+}
+
+void device_begin_frame(gs_device_t *device)
+{
+	device->stats.frames++;
+}
+
+void device_begin_scene(gs_device_t *device)
+{
+	memset(device->cur_textures, 0, sizeof(device->cur_textures));
+}
+
+static void update_viewproj_matrix(struct gs_device *device)
+{
+	struct gs_shader *vs = device->cur_vertex_shader;
+
+	gs_matrix_get(&device->cur_view);
+	matrix4_mul(&device->cur_viewproj, &device->cur_view, &device->cur_proj);
+	matrix4_transpose(&device->cur_viewproj, &device->cur_viewproj);
+
+	if (vs->viewproj)
+		gs_shader_set_matrix4(vs->viewproj, &device->cur_viewproj);
+}
+
+static inline uint32_t get_num_verts(const struct gs_device *device, uint32_t num_verts)
+{
+	if (num_verts)
+		return num_verts;
+	if (device->cur_index_buffer)
+		return (uint32_t)device->cur_index_buffer->num;
+	if (device->cur_vertex_buffer)
+		return (uint32_t)device->cur_vertex_buffer->num;
+	return 0;
+}
+
+static bool get_rgba_layout(enum gs_color_format format, int *r, int *b, bool *alpha)
+{
+	switch (format) {
+	case GS_RGBA:
+	case GS_RGBA_UNORM:
+		*r = 0;
+		*b = 2;
+		*alpha = true;
+		return true;
+	case GS_BGRA:
+	case GS_BGRA_UNORM:
+		*r = 2;
+		*b = 0;
+		*alpha = true;
+		return true;
+	case GS_BGRX:
+	case GS_BGRX_UNORM:
+		*r = 2;
+		*b = 0;
+		*alpha = false;
+		return true;
+	default:
+		return false;
+	}
+}
+
+static float blend_factor(enum gs_blend_type type, const struct vec4 *src, const struct vec4 *dst, int channel)
+{
+	switch (type) {
+	case GS_BLEND_ZERO:
+		return 0.0f;
+	case GS_BLEND_ONE:
+		return 1.0f;
+	case GS_BLEND_SRCCOLOR:
+		return src->ptr[channel];
+	case GS_BLEND_INVSRCCOLOR:
+		return 1.0f - src->ptr[channel];
+	case GS_BLEND_SRCALPHA:
+		return src->w;
+	case GS_BLEND_INVSRCALPHA:
+		return 1.0f - src->w;
+	case GS_BLEND_DSTCOLOR:
+		return dst->ptr[channel];
+	case GS_BLEND_INVDSTCOLOR:
+		return 1.0f - dst->ptr[channel];
+	case GS_BLEND_DSTALPHA:
+		return dst->w;
+	case GS_BLEND_INVDSTALPHA:
+		return 1.0f - dst->w;
+	case GS_BLEND_SRCALPHASAT:
+		return channel == 3 ? 1.0f : fminf(src->w, 1.0f - dst->w);
+	}
+
+	return 1.0f;
+}
+
+static float blend_channel(const struct gs_device *device, const struct vec4 *src, const struct vec4 *dst,
+			   int channel)
+{
+	const bool alpha = channel == 3;
+	const float s = src->ptr[channel];
+	const float d = dst->ptr[channel];
+	const float fs = blend_factor(alpha ? device->cur_blend_src_a : device->cur_blend_src_c, src, dst, channel);
+	const float fd = blend_factor(alpha ? device->cur_blend_dest_a : device->cur_blend_dest_c, src, dst, channel);
+
+	switch (device->cur_blend_op) {
+	case GS_BLEND_OP_ADD:
+		return s * fs + d * fd;
+	case GS_BLEND_OP_SUBTRACT:
+		return s * fs - d * fd;
+	case GS_BLEND_OP_REVERSE_SUBTRACT:
+		return d * fd - s * fs;
+	case GS_BLEND_OP_MIN:
+		return fminf(s, d);
+	case GS_BLEND_OP_MAX:
+		return fmaxf(s, d);
+	}
+
+	return s;
+}
+
+static inline void read_pixel(struct vec4 *color, const uint8_t *pixel, int r, int b, bool alpha)
+{
+	vec4_set(color, (float)pixel[r] / 255.0f, (float)pixel[1] / 255.0f, (float)pixel[b] / 255.0f,
+		 alpha ? (float)pixel[3] / 255.0f : 1.0f);
+}
+
+static inline uint8_t to_unorm8(float val)
+{
+	return (uint8_t)(fminf(fmaxf(val, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+static inline void write_pixel(uint8_t *pixel, const struct vec4 *color, int r, int b, bool alpha)
+{
+	pixel[r] = to_unorm8(color->x);
+	pixel[1] = to_unorm8(color->y);
+	pixel[b] = to_unorm8(color->z);
+	pixel[3] = alpha ? to_unorm8(color->w) : 255;
+}
+
+static gs_texture_t *get_pixel_shader_texture(const struct gs_device *device)
+{
+	const struct gs_shader *ps = device->cur_pixel_shader;
+
+	for (size_t i = 0; i < ps->params.num; i++) {
+		const struct gs_shader_param *param = ps->params.array + i;
+		if (param->type == GS_SHADER_PARAM_TEXTURE)
+			return param->texture;
+	}
+
+	return NULL;
+}
+
+static inline void transform_vert(struct vec2 *dst, const struct vec3 *point, const struct matrix4 *wvp,
+				  const struct gs_rect *viewport)
+{
+	struct vec4 pos;
+
+	vec4_set(&pos, point->x, point->y, point->z, 1.0f);
+	vec4_transform(&pos, &pos, wvp);
+
+	dst->x = (float)viewport->x + (pos.x / pos.w + 1.0f) * 0.5f * (float)viewport->cx;
+	dst->y = (float)viewport->y + (1.0f - pos.y / pos.w) * 0.5f * (float)viewport->cy;
+}
+
+/* Draws a sprite built by gs_draw_sprite and friends: four vertices of a
+ * triangle strip with the texture coordinates in the first texture array.
+ * Pixels whose centers are inside the sprite sample the texture at their
+ * center. */
+static void rasterize_sprite(struct gs_device *device, enum gs_draw_mode draw_mode, uint32_t start_vert,
+			     uint32_t num_verts)
+{
+	gs_texture_t *target = device->cur_render_target;
+	gs_vertbuffer_t *vb = device->cur_vertex_buffer;
+	gs_texture_t *tex = get_pixel_shader_texture(device);
+	int dst_r, dst_b, src_r, src_b;
+	bool dst_alpha, src_alpha;
+
+	if (draw_mode != GS_TRISTRIP || start_vert != 0 || (num_verts && num_verts != 4))
+		return;
+	if (!target || !target->data || target->type != GS_TEXTURE_2D || device->cur_render_side != 0)
+		return;
+	if (!tex || !tex->data || tex->type != GS_TEXTURE_2D)
+		return;
+	if (!vb || vb->num != 4 || device->cur_index_buffer || !vb->data->num_tex || vb->data->tvarray[0].width != 2)
+		return;
+	if (!get_rgba_layout(target->format, &dst_r, &dst_b, &dst_alpha) ||
+	    !get_rgba_layout(tex->format, &src_r, &src_b, &src_alpha))
+		return;
+
+	const struct vec3 *points = vb->data->points;
+	const struct vec2 *uv = vb->data->tvarray[0].array;
+	struct matrix4 wvp;
+	struct vec2 pos[3];
+
+	matrix4_mul(&wvp, &device->cur_view, &device->cur_proj);
+	for (int i = 0; i < 3; i++)
+		transform_vert(&pos[i], &points[i], &wvp, &device->cur_viewport);
+
+	/* the first edge runs along x and the second along y */
+	const float width = pos[1].x - pos[0].x;
+	const float height = pos[2].y - pos[0].y;
+	if (pos[1].y != pos[0].y || pos[2].x != pos[0].x || width == 0.0f || height == 0.0f)
+		return;
+
+	const struct gs_rect *vp = &device->cur_viewport;
+	const float left = fminf(pos[0].x, pos[1].x);
+	const float top = fminf(pos[0].y, pos[2].y);
+	int x0 = (int)ceilf(left - 0.5f);
+	int y0 = (int)ceilf(top - 0.5f);
+	int x1 = (int)ceilf(left + fabsf(width) - 0.5f);
+	int y1 = (int)ceilf(top + fabsf(height) - 0.5f);
+
+	x0 = x0 > vp->x ? x0 : vp->x;
+	y0 = y0 > vp->y ? y0 : vp->y;
+	x1 = x1 < vp->x + vp->cx ? x1 : vp->x + vp->cx;
+	y1 = y1 < vp->y + vp->cy ? y1 : vp->y + vp->cy;
+	x0 = x0 > 0 ? x0 : 0;
+	y0 = y0 > 0 ? y0 : 0;
+	x1 = x1 < (int)target->width ? x1 : (int)target->width;
+	y1 = y1 < (int)target->height ? y1 : (int)target->height;
+
+	for (int y = y0; y < y1; y++) {
+		const float t = ((float)y + 0.5f - pos[0].y) / height;
+		uint8_t *row = target->data + (size_t)y * target->linesize;
+
+		for (int x = x0; x < x1; x++) {
+			const float s = ((float)x + 0.5f - pos[0].x) / width;
+			const float u = uv[0].x + s * (uv[1].x - uv[0].x) + t * (uv[2].x - uv[0].x);
+			const float v = uv[0].y + s * (uv[1].y - uv[0].y) + t * (uv[2].y - uv[0].y);
+			int tx = (int)floorf(u * (float)tex->width);
+			int ty = (int)floorf(v * (float)tex->height);
+
+			tx = tx < 0 ? 0 : (tx >= (int)tex->width ? (int)tex->width - 1 : tx);
+			ty = ty < 0 ? 0 : (ty >= (int)tex->height ? (int)tex->height - 1 : ty);
+
+			const uint8_t *texel = tex->data + (size_t)ty * tex->linesize + (size_t)tx * 4;
+			uint8_t *pixel = row + (size_t)x * 4;
+			struct vec4 src, dst, out;
+
+			read_pixel(&src, texel, src_r, src_b, src_alpha);
+
+			if (device->cur_blend_enabled) {
+				read_pixel(&dst, pixel, dst_r, dst_b, dst_alpha);
+				for (int c = 0; c < 4; c++)
+					out.ptr[c] = blend_channel(device, &src, &dst, c);
+			} else {
+				out = src;
+			}
+
+			write_pixel(pixel, &out, dst_r, dst_b, dst_alpha);
+		}
+	}
+
+	device->stats.sprites_rasterized++;
+}
+
+void device_draw(gs_device_t *device, enum gs_draw_mode draw_mode, uint32_t start_vert, uint32_t num_verts)
+{
+	gs_effect_t *effect = gs_get_effect();
+
+	if (!device->cur_vertex_shader || !device->cur_pixel_shader) {
+		blog(LOG_ERROR, "device_draw (null): No shader loaded");
+		return;
+	}
+
+	/* keep the same per-draw work libobs and the effect system would do
+	 * for a real device so that the CPU cost of a frame is comparable */
+	if (effect)
+		gs_effect_update_params(effect);
+
+	update_viewproj_matrix(device);
+
+	rasterize_sprite(device, draw_mode, start_vert, num_verts);
+
+	device->stats.draw_calls++;
+	device->stats.vertices += get_num_verts(device, num_verts);
+}
+
+void device_end_scene(gs_device_t *device)
+{
+	UNUSED_PARAMETER(device);
+}
+
+void device_load_swapchain(gs_device_t *device, gs_swapchain_t *swapchain)
+{
+	device->cur_swap = swapchain;
+}
+
+void device_clear(gs_device_t *device, uint32_t clear_flags, const struct vec4 *color, float depth, uint8_t stencil)
+{
+	if ((clear_flags & GS_CLEAR_COLOR) != 0 && device->cur_render_target)
+		null_texture_clear(device->cur_render_target, color);
+
+	device->stats.clears++;
+
+	UNUSED_PARAMETER(depth);
+	UNUSED_PARAMETER(stencil);
+}
+
+bool device_is_present_ready(gs_device_t *device)
+{
+	UNUSED_PARAMETER(device);
+	return true;
+}
+
+void device_present(gs_device_t *device)
+{
+	device->stats.presents++;
+}
+
+void device_flush(gs_device_t *device)
+{
+	UNUSED_PARAMETER(device);
+}
+
+void device_set_cull_mode(gs_device_t *device, enum gs_cull_mode mode)
+{
+	device->cur_cull_mode = mode;
+}
+
+enum gs_cull_mode device_get_cull_mode(const gs_device_t *device)
+{
+	return device->cur_cull_mode;
+}
+
+void device_enable_blending(gs_device_t *device, bool enable)
+{
+	device->cur_blend_enabled = enable;
+}
+
+void device_enable_depth_test(gs_device_t *device, bool enable)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(enable);
+}
+
+void device_enable_stencil_test(gs_device_t *device, bool enable)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(enable);
+}
+
+void device_enable_stencil_write(gs_device_t *device, bool enable)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(enable);
+}
+
+void device_enable_color(gs_device_t *device, bool red, bool green, bool blue, bool alpha)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(red);
+	UNUSED_PARAMETER(green);
+	UNUSED_PARAMETER(blue);
+	UNUSED_PARAMETER(alpha);
+}
+
+void device_blend_function(gs_device_t *device, enum gs_blend_type src, enum gs_blend_type dest)
+{
+	device_blend_function_separate(device, src, dest, src, dest);
+}
+
+void device_blend_function_separate(gs_device_t *device, enum gs_blend_type src_c, enum gs_blend_type dest_c,
+				    enum gs_blend_type src_a, enum gs_blend_type dest_a)
+{
+	device->cur_blend_src_c = src_c;
+	device->cur_blend_dest_c = dest_c;
+	device->cur_blend_src_a = src_a;
+	device->cur_blend_dest_a = dest_a;
+}
+
+void device_blend_op(gs_device_t *device, enum gs_blend_op_type op)
+{
+	device->cur_blend_op = op;
+}
+
+void device_depth_function(gs_device_t *device, enum gs_depth_test test)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(test);
+}
+
+void device_stencil_function(gs_device_t *device, enum gs_stencil_side side, enum gs_depth_test test)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(side);
+	UNUSED_PARAMETER(test);
+}
+
+void device_stencil_op(gs_device_t *device, enum gs_stencil_side side, enum gs_stencil_op_type fail,
+		       enum gs_stencil_op_type zfail, enum gs_stencil_op_type zpass)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(side);
+	UNUSED_PARAMETER(fail);
+	UNUSED_PARAMETER(zfail);
+	UNUSED_PARAMETER(zpass);
+}
+
+void device_set_viewport(gs_device_t *device, int x, int y, int width, int height)
+{
+	device->cur_viewport.x = x;
+	device->cur_viewport.y = y;
+	device->cur_viewport.cx = width;
+	device->cur_viewport.cy = height;
+}
+
+void device_get_viewport(const gs_device_t *device, struct gs_rect *rect)
+{
+	*rect = device->cur_viewport;
+}
+
+void device_set_scissor_rect(gs_device_t *device, const struct gs_rect *rect)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(rect);
+}
+
+void device_ortho(gs_device_t *device, float left, float right, float top, float bottom, float near, float far)
+{
+	struct matrix4 *dst = &device->cur_proj;
+
+	float rml = right - left;
+	float bmt = bottom - top;
+	float fmn = far - near;
+
+	vec4_zero(&dst->x);
+	vec4_zero(&dst->y);
+	vec4_zero(&dst->z);
+	vec4_zero(&dst->t);
+
+	dst->x.x = 2.0f / rml;
+	dst->t.x = (left + right) / -rml;
+
+	dst->y.y = 2.0f / -bmt;
+	dst->t.y = (bottom + top) / bmt;
+
+	dst->z.z = -2.0f / fmn;
+	dst->t.z = (far + near) / -fmn;
+
+	dst->t.w = 1.0f;
+}
+
+void device_frustum(gs_device_t *device, float left, float right, float top, float bottom, float near, float far)
+{
+	struct matrix4 *dst = &device->cur_proj;
+
+	float rml = right - left;
+	float tmb = top - bottom;
+	float nmf = near - far;
+	float nearx2 = 2.0f * near;
+
+	vec4_zero(&dst->x);
+	vec4_zero(&dst->y);
+	vec4_zero(&dst->z);
+	vec4_zero(&dst->t);
+
+	dst->x.x = nearx2 / rml;
+	dst->z.x = (left + right) / rml;
+
+	dst->y.y = nearx2 / tmb;
+	dst->z.y = (bottom + top) / tmb;
+
+	dst->z.z = (far + near) / nmf;
+	dst->t.z = 2.0f * (near * far) / nmf;
+
+	dst->z.w = -1.0f;
+}
+
+void device_projection_push(gs_device_t *device)
+{
+	da_push_back(device->proj_stack, &device->cur_proj);
+}
+
+void device_projection_pop(gs_device_t *device)
+{
+	struct matrix4 *end;
+	if (!device->proj_stack.num)
+		return;
+
+	end = da_end(device->proj_stack);
+	device->cur_proj = *end;
+	da_pop_back(device->proj_stack);
+}
+
+void device_debug_marker_begin(gs_device_t *device, const char *markername, const float color[4])
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(markername);
+	UNUSED_PARAMETER(color);
+}
+
+void device_debug_marker_end(gs_device_t *device)
+{
+	UNUSED_PARAMETER(device);
+}
+
+bool device_is_monitor_hdr(gs_device_t *device, void *monitor)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(monitor);
+	return false;
+}
+
+bool device_shared_texture_available(void)
+{
+	return false;
+}
+
+void gs_swapchain_destroy(gs_swapchain_t *swapchain)
+{
+	if (!swapchain)
+		return;
+
+	if (swapchain->device->cur_swap == swapchain)
+		device_load_swapchain(swapchain->device, NULL);
+
+	bfree(swapchain);
+}
+
+void gs_samplerstate_destroy(gs_samplerstate_t *samplerstate)
+{
+	if (!samplerstate)
+		return;
+
+	for (size_t i = 0; i < GS_MAX_TEXTURES; i++) {
+		if (samplerstate->device->cur_samplers[i] == samplerstate)
+			samplerstate->device->cur_samplers[i] = NULL;
+	}
+
+	bfree(samplerstate);
+}
+
+void gs_timer_destroy(gs_timer_t *timer)
+{
+	bfree(timer);
+}
+
+void gs_timer_begin(gs_timer_t *timer)
+{
+	timer->begin_ns = os_gettime_ns();
+}
+
+void gs_timer_end(gs_timer_t *timer)
+{
+	timer->end_ns = os_gettime_ns();
+}
+
+bool gs_timer_get_data(gs_timer_t *timer, uint64_t *ticks)
+{
+	*ticks = timer->end_ns - timer->begin_ns;
+	return true;
+}
+
+void gs_timer_range_destroy(gs_timer_range_t *range)
+{
+	bfree(range);
+}
+
+void gs_timer_range_begin(gs_timer_range_t *range)
+{
+	UNUSED_PARAMETER(range);
+}
+
+void gs_timer_range_end(gs_timer_range_t *range)
+{
+	UNUSED_PARAMETER(range);
+}
+
+bool gs_timer_range_get_data(gs_timer_range_t *range, bool *disjoint, uint64_t *frequency)
+{
+	UNUSED_PARAMETER(range);
+
+	*disjoint = false;
+	*frequency = 1000000000;
+	return true;
+}
+
+#ifdef _WIN32
+
+bool device_gdi_texture_available(void)
+{
+	return false;
+}
+
+#elif defined(__APPLE__)
+
+gs_texture_t *device_texture_create_from_iosurface(gs_device_t *device, void *iosurf)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(iosurf);
+	return NULL;
+}
+
+gs_texture_t *device_texture_open_shared(gs_device_t *device, uint32_t handle)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(handle);
+	return NULL;
+}
+
+bool gs_texture_rebind_iosurface(gs_texture_t *texture, void *iosurf)
+{
+	UNUSED_PARAMETER(texture);
+	UNUSED_PARAMETER(iosurf);
+	return false;
+}
+
+#elif defined(__linux__) || defined(__FreeBSD__) || defined(__DragonFly__)
+
+gs_texture_t *device_texture_create_from_dmabuf(gs_device_t *device, unsigned int width, unsigned int height,
+						uint32_t drm_format, enum gs_color_format color_format,
+						uint32_t n_planes, const int *fds, const uint32_t *strides,
+						const uint32_t *offsets, const uint64_t *modifiers)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(width);
+	UNUSED_PARAMETER(height);
+	UNUSED_PARAMETER(drm_format);
+	UNUSED_PARAMETER(color_format);
+	UNUSED_PARAMETER(n_planes);
+	UNUSED_PARAMETER(fds);
+	UNUSED_PARAMETER(strides);
+	UNUSED_PARAMETER(offsets);
+	UNUSED_PARAMETER(modifiers);
+	return NULL;
+}
+
+bool device_query_dmabuf_capabilities(gs_device_t *device, enum gs_dmabuf_flags *dmabuf_flags,
+				      uint32_t **drm_formats, size_t *n_formats)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(dmabuf_flags);
+	UNUSED_PARAMETER(drm_formats);
+	UNUSED_PARAMETER(n_formats);
+	return false;
+}
+
+bool device_query_dmabuf_modifiers_for_format(gs_device_t *device, uint32_t drm_format, uint64_t **modifiers,
+					      size_t *n_modifiers)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(drm_format);
+	UNUSED_PARAMETER(modifiers);
+	UNUSED_PARAMETER(n_modifiers);
+	return false;
+}
+
+gs_texture_t *device_texture_create_from_pixmap(gs_device_t *device, uint32_t width, uint32_t height,
+						enum gs_color_format color_format, uint32_t target, void *pixmap)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(width);
+	UNUSED_PARAMETER(height);
+	UNUSED_PARAMETER(color_format);
+	UNUSED_PARAMETER(target);
+	UNUSED_PARAMETER(pixmap);
+	return NULL;
+}
+
+bool device_query_sync_capabilities(gs_device_t *device)
+{
+	UNUSED_PARAMETER(device);
+	return false;
+}
+
+gs_sync_t *device_sync_create(gs_device_t *device)
+{
+	UNUSED_PARAMETER(device);
+	return NULL;
+}
+
+gs_sync_t *device_sync_create_from_syncobj_timeline_point(gs_device_t *device, int syncobj_fd,
+							  uint64_t timeline_point)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(syncobj_fd);
+	UNUSED_PARAMETER(timeline_point);
+	return NULL;
+}
+
+void device_sync_destroy(gs_device_t *device, gs_sync_t *sync)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(sync);
+}
+
+bool device_sync_export_syncobj_timeline_point(gs_device_t *device, gs_sync_t *sync, int syncobj_fd,
+					       uint64_t timeline_point)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(sync);
+	UNUSED_PARAMETER(syncobj_fd);
+	UNUSED_PARAMETER(timeline_point);
+	return false;
+}
+
+bool device_sync_signal_syncobj_timeline_point(gs_device_t *device, int syncobj_fd, uint64_t timeline_point)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(syncobj_fd);
+	UNUSED_PARAMETER(timeline_point);
+	return false;
+}
+
+bool device_sync_wait(gs_device_t *device, gs_sync_t *sync)
+{
+	UNUSED_PARAMETER(device);
+	UNUSED_PARAMETER(sync);
+	return false;
+}
+
+#endif
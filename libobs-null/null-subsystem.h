@@ -0,0 +1,205 @@
+/******************************************************************************
+    Copyright (C) 2026 by agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <util/darray.h>
+#include <graphics/graphics.h>
+#include <graphics/device-exports.h>
+#include <graphics/matrix4.h>
+
+/*
+ * Null graphics subsystem
+ *
+ *   Implements the device exports without a GPU so that the libobs render
+ * loop can run headless.  Textures and stage surfaces are backed by system
+ * memory so copies, mapping and readback behave as they would on a real
+ * device.  Every device call is counted, and device_get_device_obj returns a
+ * pointer to the device's gs_null_stats.
+ *
+ *   Shaders are not run.  The only draws that write pixels are axis-aligned
+ * sprites between 8-bit RGBA/BGRA textures, which copy the first texture of
+ * the pixel shader with nearest sampling and the current blend state, so
+ * that tests can check what libobs composites.  Colors are not converted
+ * between sRGB and linear.
+ *
+ *   Setting OBS_NULL_READBACK_LATENCY_MS makes mapping a stage surface wait
+ * until that long after it was staged, to simulate the time a GPU takes to
+ * finish a copy, for benchmarking the readback pipeline.
+ */
+
+struct gs_null_stats {
+	uint64_t frames;
+	uint64_t draw_calls;
+	uint64_t vertices;
+	uint64_t clears;
+	uint64_t presents;
+
+	uint64_t textures_created;
+	uint64_t texture_maps;
+	uint64_t texture_copies;
+	uint64_t texture_stages;
+	uint64_t stage_maps;
+	uint64_t stage_map_wait_ns;
+	uint64_t bytes_copied;
+
+	uint64_t shaders_created;
+	uint64_t buffer_flushes;
+
+	uint64_t sprites_rasterized;
+};
+
+struct gs_sampler_state {
+	gs_device_t *device;
+	struct gs_sampler_info info;
+};
+
+struct gs_timer {
+	uint64_t begin_ns;
+	uint64_t end_ns;
+};
+
+struct gs_timer_range {
+	gs_device_t *device;
+};
+
+struct gs_shader_param {
+	enum gs_shader_param_type type;
+
+	char *name;
+	gs_shader_t *shader;
+	gs_samplerstate_t *next_sampler;
+	int array_count;
+
+	struct gs_texture *texture;
+	bool srgb;
+
+	DARRAY(uint8_t) cur_value;
+	DARRAY(uint8_t) def_value;
+};
+
+struct gs_shader {
+	gs_device_t *device;
+	enum gs_shader_type type;
+
+	struct gs_shader_param *viewproj;
+	struct gs_shader_param *world;
+
+	DARRAY(struct gs_shader_param) params;
+};
+
+struct gs_vertex_buffer {
+	gs_device_t *device;
+	size_t num;
+	bool dynamic;
+	struct gs_vb_data *data;
+};
+
+struct gs_index_buffer {
+	gs_device_t *device;
+	enum gs_index_type type;
+	void *data;
+	size_t num;
+	size_t width;
+	bool dynamic;
+};
+
+struct gs_texture {
+	gs_device_t *device;
+	enum gs_texture_type type;
+	enum gs_color_format format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t depth;
+	uint32_t levels;
+	bool is_dynamic;
+	bool is_render_target;
+
+	uint32_t linesize;
+	size_t size;
+	uint8_t *data;
+};
+
+struct gs_stage_surface {
+	gs_device_t *device;
+
+	enum gs_color_format format;
+	uint32_t width;
+	uint32_t height;
+
+	uint32_t linesize;
+	uint8_t *data;
+
+	uint64_t stage_ts;
+};
+
+struct gs_zstencil_buffer {
+	gs_device_t *device;
+	enum gs_zstencil_format format;
+	uint32_t width;
+	uint32_t height;
+};
+
+struct gs_swap_chain {
+	gs_device_t *device;
+	struct gs_init_data info;
+};
+
+struct gs_device {
+	gs_texture_t *cur_render_target;
+	gs_zstencil_t *cur_zstencil_buffer;
+	int cur_render_side;
+	gs_texture_t *cur_textures[GS_MAX_TEXTURES];
+	gs_samplerstate_t *cur_samplers[GS_MAX_TEXTURES];
+	gs_vertbuffer_t *cur_vertex_buffer;
+	gs_indexbuffer_t *cur_index_buffer;
+	gs_shader_t *cur_vertex_shader;
+	gs_shader_t *cur_pixel_shader;
+	gs_swapchain_t *cur_swap;
+	enum gs_color_space cur_color_space;
+	bool cur_fb_srgb;
+
+	enum gs_cull_mode cur_cull_mode;
+	struct gs_rect cur_viewport;
+
+	bool cur_blend_enabled;
+	enum gs_blend_type cur_blend_src_c;
+	enum gs_blend_type cur_blend_dest_c;
+	enum gs_blend_type cur_blend_src_a;
+	enum gs_blend_type cur_blend_dest_a;
+	enum gs_blend_op_type cur_blend_op;
+
+	struct matrix4 cur_proj;
+	struct matrix4 cur_view;
+	struct matrix4 cur_viewproj;
+
+	DARRAY(struct matrix4) proj_stack;
+
+	struct gs_null_stats stats;
+	uint64_t readback_latency_ns;
+};
+
+static inline size_t null_texture_size(enum gs_color_format format, uint32_t width, uint32_t height,
+				       uint32_t *linesize)
+{
+	uint32_t bpp = gs_get_format_bpp(format);
+
+	*linesize = width * bpp / 8;
+	return (size_t)*linesize * height;
+}
+
+extern void null_texture_clear(gs_texture_t *tex, const struct vec4 *color);
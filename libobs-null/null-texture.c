@@ -0,0 +1,398 @@
+/******************************************************************************
+    Copyright (C) 2026 by agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <util/base.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <graphics/vec4.h>
+#include "null-subsystem.h"
+
+/* Only the top mip level is stored; nothing samples from the lower ones */
+static struct gs_texture *texture_create(gs_device_t *device, enum gs_texture_type type, uint32_t width,
+					 uint32_t height, uint32_t depth, enum gs_color_format color_format,
+					 uint32_t levels, uint32_t flags)
+{
+	struct gs_texture *tex = bzalloc(sizeof(struct gs_texture));
+
+	tex->device = device;
+	tex->type = type;
+	tex->format = color_format;
+	tex->width = width;
+	tex->height = height;
+	tex->depth = depth;
+	tex->levels = levels;
+	tex->is_dynamic = (flags & GS_DYNAMIC) != 0;
+	tex->is_render_target = (flags & GS_RENDER_TARGET) != 0;
+
+	tex->size = null_texture_size(color_format, width, height, &tex->linesize) * depth;
+	if (tex->size)
+		tex->data = bzalloc(tex->size);
+
+	device->stats.textures_created++;
+	return tex;
+}
+
+static void texture_upload(struct gs_texture *tex, const uint8_t *const *data, uint32_t slices)
+{
+	size_t slice_size = tex->size / slices;
+
+	if (!data || !tex->data)
+		return;
+
+	/* each slice (cube face or volume layer) carries its own mip chain,
+	 * so skip over the lower levels to reach the next slice */
+	for (uint32_t i = 0; i < slices; i++) {
+		if (!*data)
+			break;
+
+		memcpy(tex->data + slice_size * i, *data, slice_size);
+		data += tex->levels ? tex->levels : 1;
+	}
+}
+
+gs_texture_t *device_texture_create(gs_device_t *device, uint32_t width, uint32_t height,
+				    enum gs_color_format color_format, uint32_t levels, const uint8_t **data,
+				    uint32_t flags)
+{
+	struct gs_texture *tex = texture_create(device, GS_TEXTURE_2D, width, height, 1, color_format, levels, flags);
+
+	texture_upload(tex, data, 1);
+	return tex;
+}
+
+gs_texture_t *device_cubetexture_create(gs_device_t *device, uint32_t size, enum gs_color_format color_format,
+					uint32_t levels, const uint8_t **data, uint32_t flags)
+{
+	struct gs_texture *tex = texture_create(device, GS_TEXTURE_CUBE, size, size, 6, color_format, levels, flags);
+
+	texture_upload(tex, data, 6);
+	return tex;
+}
+
+gs_texture_t *device_voltexture_create(gs_device_t *device, uint32_t width, uint32_t height, uint32_t depth,
+				       enum gs_color_format color_format, uint32_t levels, const uint8_t *const *data,
+				       uint32_t flags)
+{
+	struct gs_texture *tex =
+		texture_create(device, GS_TEXTURE_3D, width, height, depth, color_format, levels, flags);
+
+	/* volume data is a single block per level rather than per layer */
+	if (data && *data && tex->data)
+		memcpy(tex->data, *data, tex->size);
+	return tex;
+}
+
+static void texture_release(gs_texture_t *tex)
+{
+	gs_device_t *device = tex->device;
+
+	for (size_t i = 0; i < GS_MAX_TEXTURES; i++) {
+		if (device->cur_textures[i] == tex)
+			device->cur_textures[i] = NULL;
+	}
+
+	if (device->cur_render_target == tex)
+		device->cur_render_target = NULL;
+
+	bfree(tex->data);
+	bfree(tex);
+}
+
+void gs_texture_destroy(gs_texture_t *tex)
+{
+	if (tex)
+		texture_release(tex);
+}
+
+uint32_t gs_texture_get_width(const gs_texture_t *tex)
+{
+	return tex->width;
+}
+
+uint32_t gs_texture_get_height(const gs_texture_t *tex)
+{
+	return tex->height;
+}
+
+enum gs_color_format gs_texture_get_color_format(const gs_texture_t *tex)
+{
+	return tex->format;
+}
+
+bool gs_texture_map(gs_texture_t *tex, uint8_t **ptr, uint32_t *linesize)
+{
+	if (tex->type != GS_TEXTURE_2D || !tex->data) {
+		blog(LOG_ERROR, "gs_texture_map (null): texture is not a mappable 2D texture");
+		return false;
+	}
+
+	tex->device->stats.texture_maps++;
+
+	*ptr = tex->data;
+	*linesize = tex->linesize;
+	return true;
+}
+
+void gs_texture_unmap(gs_texture_t *tex)
+{
+	UNUSED_PARAMETER(tex);
+}
+
+void *gs_texture_get_obj(gs_texture_t *tex)
+{
+	return tex->data;
+}
+
+void gs_cubetexture_destroy(gs_texture_t *cubetex)
+{
+	if (cubetex)
+		texture_release(cubetex);
+}
+
+uint32_t gs_cubetexture_get_size(const gs_texture_t *cubetex)
+{
+	return cubetex->width;
+}
+
+enum gs_color_format gs_cubetexture_get_color_format(const gs_texture_t *cubetex)
+{
+	return cubetex->format;
+}
+
+void gs_voltexture_destroy(gs_texture_t *voltex)
+{
+	if (voltex)
+		texture_release(voltex);
+}
+
+uint32_t gs_voltexture_get_width(const gs_texture_t *voltex)
+{
+	return voltex->width;
+}
+
+uint32_t gs_voltexture_get_height(const gs_texture_t *voltex)
+{
+	return voltex->height;
+}
+
+uint32_t gs_voltexture_get_depth(const gs_texture_t *voltex)
+{
+	return voltex->depth;
+}
+
+enum gs_color_format gs_voltexture_get_color_format(const gs_texture_t *voltex)
+{
+	return voltex->format;
+}
+
+void null_texture_clear(gs_texture_t *tex, const struct vec4 *color)
+{
+	uint32_t packed;
+
+	if (!tex->data)
+		return;
+
+	switch (tex->format) {
+	case GS_RGBA:
+	case GS_RGBA_UNORM:
+		packed = vec4_to_rgba(color);
+		break;
+	case GS_BGRA:
+	case GS_BGRX:
+	case GS_BGRA_UNORM:
+	case GS_BGRX_UNORM:
+		packed = vec4_to_bgra(color);
+		break;
+	default:
+		/* other formats are only ever cleared to zero in practice */
+		memset(tex->data, 0, tex->size);
+		return;
+	}
+
+	uint32_t *pixels = (uint32_t *)tex->data;
+	size_t count = tex->size / sizeof(uint32_t);
+
+	for (size_t i = 0; i < count; i++)
+		pixels[i] = packed;
+}
+
+static bool copy_rows(gs_texture_t *dst, uint32_t dst_x, uint32_t dst_y, const gs_texture_t *src, uint32_t src_x,
+		      uint32_t src_y, uint32_t src_w, uint32_t src_h)
+{
+	uint32_t bpp = gs_get_format_bpp(src->format) / 8;
+	size_t row_size = (size_t)src_w * bpp;
+
+	if (!dst->data || !src->data || !bpp)
+		return false;
+
+	for (uint32_t y = 0; y < src_h; y++) {
+		const uint8_t *in = src->data + (size_t)(src_y + y) * src->linesize + (size_t)src_x * bpp;
+		uint8_t *out = dst->data + (size_t)(dst_y + y) * dst->linesize + (size_t)dst_x * bpp;
+		memcpy(out, in, row_size);
+	}
+
+	dst->device->stats.bytes_copied += row_size * src_h;
+	return true;
+}
+
+void device_copy_texture_region(gs_device_t *device, gs_texture_t *dst, uint32_t dst_x, uint32_t dst_y,
+				gs_texture_t *src, uint32_t src_x, uint32_t src_y, uint32_t src_w, uint32_t src_h)
+{
+	if (!src || !dst) {
+		blog(LOG_ERROR, "device_copy_texture_region (null): Source or destination texture is NULL");
+		return;
+	}
+
+	if (src->type != GS_TEXTURE_2D || dst->type != GS_TEXTURE_2D) {
+		blog(LOG_ERROR, "device_copy_texture_region (null): Source and destination textures must be 2D "
+				"textures");
+		return;
+	}
+
+	if (dst->format != src->format) {
+		blog(LOG_ERROR, "device_copy_texture_region (null): Source and destination formats do not match");
+		return;
+	}
+
+	uint32_t copy_w = src_w ? src_w : (src->width - src_x);
+	uint32_t copy_h = src_h ? src_h : (src->height - src_y);
+
+	if (src_x + copy_w > src->width || src_y + copy_h > src->height || dst_x + copy_w > dst->width ||
+	    dst_y + copy_h > dst->height) {
+		blog(LOG_ERROR, "device_copy_texture_region (null): Region is out of bounds");
+		return;
+	}
+
+	copy_rows(dst, dst_x, dst_y, src, src_x, src_y, copy_w, copy_h);
+	device->stats.texture_copies++;
+}
+
+void device_copy_texture(gs_device_t *device, gs_texture_t *dst, gs_texture_t *src)
+{
+	device_copy_texture_region(device, dst, 0, 0, src, 0, 0, 0, 0);
+}
+
+gs_stagesurf_t *device_stagesurface_create(gs_device_t *device, uint32_t width, uint32_t height,
+					   enum gs_color_format color_format)
+{
+	struct gs_stage_surface *surf = bzalloc(sizeof(struct gs_stage_surface));
+	size_t size;
+
+	surf->device = device;
+	surf->format = color_format;
+	surf->width = width;
+	surf->height = height;
+
+	size = null_texture_size(color_format, width, height, &surf->linesize);
+	if (size)
+		surf->data = bzalloc(size);
+
+	return surf;
+}
+
+void gs_stagesurface_destroy(gs_stagesurf_t *stagesurf)
+{
+	if (!stagesurf)
+		return;
+
+	bfree(stagesurf->data);
+	bfree(stagesurf);
+}
+
+uint32_t gs_stagesurface_get_width(const gs_stagesurf_t *stagesurf)
+{
+	return stagesurf->width;
+}
+
+uint32_t gs_stagesurface_get_height(const gs_stagesurf_t *stagesurf)
+{
+	return stagesurf->height;
+}
+
+enum gs_color_format gs_stagesurface_get_color_format(const gs_stagesurf_t *stagesurf)
+{
+	return stagesurf->format;
+}
+
+bool gs_stagesurface_map(gs_stagesurf_t *stagesurf, uint8_t **data, uint32_t *linesize)
+{
+	gs_device_t *device = stagesurf->device;
+
+	if (!stagesurf->data)
+		return false;
+
+	if (device->readback_latency_ns && stagesurf->stage_ts) {
+		uint64_t start = os_gettime_ns();
+		if (os_sleepto_ns(stagesurf->stage_ts + device->readback_latency_ns))
+			device->stats.stage_map_wait_ns += os_gettime_ns() - start;
+	}
+
+	device->stats.stage_maps++;
+
+	*data = stagesurf->data;
+	*linesize = stagesurf->linesize;
+	return true;
+}
+
+void gs_stagesurface_unmap(gs_stagesurf_t *stagesurf)
+{
+	UNUSED_PARAMETER(stagesurf);
+}
+
+void device_stage_texture(gs_device_t *device, gs_stagesurf_t *dst, gs_texture_t *src)
+{
+	if (src->type != GS_TEXTURE_2D) {
+		blog(LOG_ERROR, "device_stage_texture (null): Source texture must be a 2D texture");
+		return;
+	}
+
+	if (src->format != dst->format || src->width != dst->width || src->height != dst->height) {
+		blog(LOG_ERROR, "device_stage_texture (null): Source and destination must match");
+		return;
+	}
+
+	if (src->data && dst->data) {
+		memcpy(dst->data, src->data, src->size);
+		device->stats.bytes_copied += src->size;
+	}
+
+	dst->stage_ts = os_gettime_ns();
+	device->stats.texture_stages++;
+}
+
+gs_zstencil_t *device_zstencil_create(gs_device_t *device, uint32_t width, uint32_t height,
+				      enum gs_zstencil_format format)
+{
+	struct gs_zstencil_buffer *zs = bzalloc(sizeof(struct gs_zstencil_buffer));
+
+	zs->device = device;
+	zs->format = format;
+	zs->width = width;
+	zs->height = height;
+	return zs;
+}
+
+void gs_zstencil_destroy(gs_zstencil_t *zstencil)
+{
+	if (!zstencil)
+		return;
+
+	if (zstencil->device->cur_zstencil_buffer == zstencil)
+		zstencil->device->cur_zstencil_buffer = NULL;
+
+	bfree(zstencil);
+}
@@ -241,6 +241,42 @@ failed:
 	blog(LOG_ERROR, "gs_texture_unmap (GL) failed");
 }
 
+bool gs_texture_set_image_rect(gs_texture_t *tex, const uint8_t *data, uint32_t linesize, uint32_t x, uint32_t y,
+			       uint32_t cx, uint32_t cy)
+{
+	struct gs_texture_2d *tex2d = (struct gs_texture_2d *)tex;
+	uint32_t bytes_per_pixel;
+	bool success;
+
+	if (!is_texture_2d(tex, "gs_texture_set_image_rect"))
+		return false;
+	if (gs_is_compressed_format(tex->format))
+		return false;
+	if (x + cx > tex2d->width || y + cy > tex2d->height)
+		return false;
+
+	bytes_per_pixel = gs_get_format_bpp(tex->format) / 8;
+	if (!bytes_per_pixel || linesize % bytes_per_pixel)
+		return false;
+
+	if (!gl_bind_texture(GL_TEXTURE_2D, tex->texture))
+		return false;
+
+	/* upload straight from client memory rather than the unpack buffer */
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, linesize / bytes_per_pixel);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, cx, cy, tex->gl_format, tex->gl_type, data);
+	success = gl_success("glTexSubImage2D");
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+	gl_bind_texture(GL_TEXTURE_2D, 0);
+
+	if (!success)
+		blog(LOG_ERROR, "gs_texture_set_image_rect (GL) failed");
+	return success;
+}
+
 bool gs_texture_is_rect(const gs_texture_t *tex)
 {
 	if (tex->type == GS_TEXTURE_3D)
@@ -166,7 +166,12 @@ static void upload_shader_params(pass_shaderparam_array_t *pass_params, bool cha
 				continue;
 		}
 
+		if (param->uploaded_val.num == eparam->cur_val.num &&
+		    memcmp(param->uploaded_val.array, eparam->cur_val.array, eparam->cur_val.num) == 0)
+			continue;
+
 		gs_shader_set_val(sparam, eparam->cur_val.array, eparam->cur_val.num);
+		da_copy(param->uploaded_val, eparam->cur_val);
 	}
 }
 
@@ -203,6 +208,12 @@ bool gs_technique_begin_pass(gs_technique_t *tech, size_t idx)
 	passes = tech->passes.array;
 	cur_pass = passes + idx;
 
+	if (cur_pass->device_generation != tech->effect->graphics->device_generation) {
+		pass_shaderparams_invalidate(&cur_pass->vertshader_params);
+		pass_shaderparams_invalidate(&cur_pass->pixelshader_params);
+		cur_pass->device_generation = tech->effect->graphics->device_generation;
+	}
+
 	tech->effect->cur_pass = cur_pass;
 	gs_load_vertexshader(cur_pass->vertshader);
 	gs_load_pixelshader(cur_pass->pixelshader);
@@ -233,11 +244,12 @@ static inline void clear_tex_params(pass_shaderparam_array_t *in_params)
 
 	for (size_t i = 0; i < in_params->num; i++) {
 		struct pass_shaderparam *param = params + i;
-		struct gs_shader_param_info info;
 
-		gs_shader_get_param_info(param->sparam, &info);
-		if (info.type == GS_SHADER_PARAM_TEXTURE)
-			gs_shader_set_texture(param->sparam, NULL);
+		if (param->eparam->type != GS_SHADER_PARAM_TEXTURE || !param->uploaded_val.num)
+			continue;
+
+		gs_shader_set_texture(param->sparam, NULL);
+		da_resize(param->uploaded_val, 0);
 	}
 }
 
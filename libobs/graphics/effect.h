@@ -89,8 +89,24 @@ EXPORT void effect_param_parse_property(gs_eparam_t *param, const char *property
 struct pass_shaderparam {
 	struct gs_effect_param *eparam;
 	gs_sparam_t *sparam;
+
+	/* last value sent to the shader, used to skip redundant uploads */
+	DARRAY(uint8_t) uploaded_val;
 };
 
+static inline void pass_shaderparams_invalidate(pass_shaderparam_array_t *params)
+{
+	for (size_t i = 0; i < params->num; i++)
+		da_resize(params->array[i].uploaded_val, 0);
+}
+
+static inline void pass_shaderparams_free(pass_shaderparam_array_t *params)
+{
+	for (size_t i = 0; i < params->num; i++)
+		da_free(params->array[i].uploaded_val);
+	da_free(*params);
+}
+
 struct gs_effect_pass {
 	char *name;
 	enum effect_section section;
@@ -99,6 +115,8 @@ struct gs_effect_pass {
 	gs_shader_t *pixelshader;
 	pass_shaderparam_array_t vertshader_params;
 	pass_shaderparam_array_t pixelshader_params;
+
+	uint32_t device_generation;
 };
 
 static inline void effect_pass_init(struct gs_effect_pass *pass)
@@ -109,8 +127,8 @@ static inline void effect_pass_init(struct gs_effect_pass *pass)
 static inline void effect_pass_free(struct gs_effect_pass *pass)
 {
 	bfree(pass->name);
-	da_free(pass->vertshader_params);
-	da_free(pass->pixelshader_params);
+	pass_shaderparams_free(&pass->vertshader_params);
+	pass_shaderparams_free(&pass->pixelshader_params);
 
 	gs_shader_destroy(pass->vertshader);
 	gs_shader_destroy(pass->pixelshader);
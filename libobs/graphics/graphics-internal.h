@@ -140,6 +140,8 @@ struct gs_exports {
 	bool (*gs_texture_map)(gs_texture_t *tex, uint8_t **ptr, uint32_t *linesize);
 	void (*gs_texture_unmap)(gs_texture_t *tex);
 	bool (*gs_texture_is_rect)(const gs_texture_t *tex);
+	bool (*gs_texture_set_image_rect)(gs_texture_t *tex, const uint8_t *data, uint32_t linesize, uint32_t x,
+					  uint32_t y, uint32_t cx, uint32_t cy);
 	void *(*gs_texture_get_obj)(const gs_texture_t *tex);
 
 	void (*gs_cubetexture_destroy)(gs_texture_t *cubetex);
@@ -332,4 +334,10 @@ struct graphics_subsystem {
 	DARRAY(struct blend_state) blend_state_stack;
 
 	bool linear_srgb;
+
+	/* device calls since the start of the frame */
+	struct gs_frame_stats frame_stats;
+
+	/* incremented each time the device is rebuilt after a loss */
+	uint32_t device_generation;
 };
@@ -157,6 +157,23 @@ static bool graphics_init_sprite_vbs(struct graphics_subsystem *graphics)
 	return true;
 }
 
+#ifdef _WIN32
+static void graphics_device_loss_release(void *data)
+{
+	UNUSED_PARAMETER(data);
+}
+
+static void graphics_device_loss_rebuild(void *device, void *data)
+{
+	struct graphics_subsystem *graphics = data;
+
+	/* shader parameters are reset to their defaults on rebuild, so any
+	 * values effects cached as uploaded are no longer valid */
+	graphics->device_generation++;
+	UNUSED_PARAMETER(device);
+}
+#endif
+
 static bool graphics_init(struct graphics_subsystem *graphics)
 {
 	struct matrix4 top_mat;
@@ -188,6 +205,17 @@ static bool graphics_init(struct graphics_subsystem *graphics)
 	graphics->cur_blend_state.op = GS_BLEND_OP_ADD;
 	graphics->exports.device_blend_op(graphics->device, graphics->cur_blend_state.op);
 
+#ifdef _WIN32
+	if (graphics->exports.device_register_loss_callbacks) {
+		struct gs_device_loss callbacks = {
+			.device_loss_release = graphics_device_loss_release,
+			.device_loss_rebuild = graphics_device_loss_rebuild,
+			.data = graphics,
+		};
+		graphics->exports.device_register_loss_callbacks(graphics->device, &callbacks);
+	}
+#endif
+
 	graphics->exports.device_leave_context(graphics->device);
 
 	gs_init_image_deps();
@@ -1712,6 +1740,7 @@ void gs_load_texture(gs_texture_t *tex, int unit)
 	if (!gs_valid("gs_load_texture"))
 		return;
 
+	graphics->frame_stats.texture_loads++;
 	graphics->exports.device_load_texture(graphics->device, tex, unit);
 }
 
@@ -1722,6 +1751,7 @@ void gs_load_samplerstate(gs_samplerstate_t *samplerstate, int unit)
 	if (!gs_valid("gs_load_samplerstate"))
 		return;
 
+	graphics->frame_stats.sampler_loads++;
 	graphics->exports.device_load_samplerstate(graphics->device, samplerstate, unit);
 }
 
@@ -1732,6 +1762,7 @@ void gs_load_vertexshader(gs_shader_t *vertshader)
 	if (!gs_valid("gs_load_vertexshader"))
 		return;
 
+	graphics->frame_stats.shader_loads++;
 	graphics->exports.device_load_vertexshader(graphics->device, vertshader);
 }
 
@@ -1742,6 +1773,7 @@ void gs_load_pixelshader(gs_shader_t *pixelshader)
 	if (!gs_valid("gs_load_pixelshader"))
 		return;
 
+	graphics->frame_stats.shader_loads++;
 	graphics->exports.device_load_pixelshader(graphics->device, pixelshader);
 }
 
@@ -1916,9 +1948,20 @@ void gs_begin_frame(void)
 	if (!gs_valid("gs_begin_frame"))
 		return;
 
+	memset(&graphics->frame_stats, 0, sizeof(graphics->frame_stats));
 	graphics->exports.device_begin_frame(graphics->device);
 }
 
+void gs_get_frame_stats(struct gs_frame_stats *stats)
+{
+	graphics_t *graphics = thread_graphics;
+
+	if (!gs_valid_p("gs_get_frame_stats", stats))
+		return;
+
+	*stats = graphics->frame_stats;
+}
+
 void gs_begin_scene(void)
 {
 	graphics_t *graphics = thread_graphics;
@@ -1936,6 +1979,7 @@ void gs_draw(enum gs_draw_mode draw_mode, uint32_t start_vert, uint32_t num_vert
 	if (!gs_valid("gs_draw"))
 		return;
 
+	graphics->frame_stats.draw_calls++;
 	graphics->exports.device_draw(graphics->device, draw_mode, start_vert, num_verts);
 }
 
@@ -2302,6 +2346,7 @@ void gs_shader_set_bool(gs_sparam_t *param, bool val)
 	if (!gs_valid_p("gs_shader_set_bool", param))
 		return;
 
+	graphics->frame_stats.shader_param_uploads++;
 	graphics->exports.gs_shader_set_bool(param, val);
 }
 
@@ -2312,6 +2357,7 @@ void gs_shader_set_float(gs_sparam_t *param, float val)
 	if (!gs_valid_p("gs_shader_set_float", param))
 		return;
 
+	graphics->frame_stats.shader_param_uploads++;
 	graphics->exports.gs_shader_set_float(param, val);
 }
 
@@ -2322,6 +2368,7 @@ void gs_shader_set_int(gs_sparam_t *param, int val)
 	if (!gs_valid_p("gs_shader_set_int", param))
 		return;
 
+	graphics->frame_stats.shader_param_uploads++;
 	graphics->exports.gs_shader_set_int(param, val);
 }
 
@@ -2332,6 +2379,7 @@ void gs_shader_set_matrix3(gs_sparam_t *param, const struct matrix3 *val)
 	if (!gs_valid_p2("gs_shader_set_matrix3", param, val))
 		return;
 
+	graphics->frame_stats.shader_param_uploads++;
 	graphics->exports.gs_shader_set_matrix3(param, val);
 }
 
@@ -2342,6 +2390,7 @@ void gs_shader_set_matrix4(gs_sparam_t *param, const struct matrix4 *val)
 	if (!gs_valid_p2("gs_shader_set_matrix4", param, val))
 		return;
 
+	graphics->frame_stats.shader_param_uploads++;
 	graphics->exports.gs_shader_set_matrix4(param, val);
 }
 
@@ -2352,6 +2401,7 @@ void gs_shader_set_vec2(gs_sparam_t *param, const struct vec2 *val)
 	if (!gs_valid_p2("gs_shader_set_vec2", param, val))
 		return;
 
+	graphics->frame_stats.shader_param_uploads++;
 	graphics->exports.gs_shader_set_vec2(param, val);
 }
 
@@ -2362,6 +2412,7 @@ void gs_shader_set_vec3(gs_sparam_t *param, const struct vec3 *val)
 	if (!gs_valid_p2("gs_shader_set_vec3", param, val))
 		return;
 
+	graphics->frame_stats.shader_param_uploads++;
 	graphics->exports.gs_shader_set_vec3(param, val);
 }
 
@@ -2372,6 +2423,7 @@ void gs_shader_set_vec4(gs_sparam_t *param, const struct vec4 *val)
 	if (!gs_valid_p2("gs_shader_set_vec4", param, val))
 		return;
 
+	graphics->frame_stats.shader_param_uploads++;
 	graphics->exports.gs_shader_set_vec4(param, val);
 }
 
@@ -2382,6 +2434,7 @@ void gs_shader_set_texture(gs_sparam_t *param, gs_texture_t *val)
 	if (!gs_valid_p("gs_shader_set_texture", param))
 		return;
 
+	graphics->frame_stats.shader_param_uploads++;
 	graphics->exports.gs_shader_set_texture(param, val);
 }
 
@@ -2392,6 +2445,7 @@ void gs_shader_set_val(gs_sparam_t *param, const void *val, size_t size)
 	if (!gs_valid_p2("gs_shader_set_val", param, val))
 		return;
 
+	graphics->frame_stats.shader_param_uploads++;
 	graphics->exports.gs_shader_set_val(param, val, size);
 }
 
@@ -2402,6 +2456,7 @@ void gs_shader_set_default(gs_sparam_t *param)
 	if (!gs_valid_p("gs_shader_set_default", param))
 		return;
 
+	graphics->frame_stats.shader_param_uploads++;
 	graphics->exports.gs_shader_set_default(param);
 }
 
@@ -2412,6 +2467,7 @@ void gs_shader_set_next_sampler(gs_sparam_t *param, gs_samplerstate_t *sampler)
 	if (!gs_valid_p("gs_shader_set_next_sampler", param))
 		return;
 
+	graphics->frame_stats.sampler_loads++;
 	graphics->exports.gs_shader_set_next_sampler(param, sampler);
 }
 
@@ -2490,6 +2546,20 @@ bool gs_texture_is_rect(const gs_texture_t *tex)
 		return false;
 }
 
+bool gs_texture_set_image_rect(gs_texture_t *tex, const uint8_t *data, uint32_t linesize, uint32_t x, uint32_t y,
+			       uint32_t cx, uint32_t cy)
+{
+	graphics_t *graphics = thread_graphics;
+
+	if (!gs_valid_p2("gs_texture_set_image_rect", tex, data))
+		return false;
+
+	if (graphics->exports.gs_texture_set_image_rect)
+		return graphics->exports.gs_texture_set_image_rect(tex, data, linesize, x, y, cx, cy);
+	else
+		return false;
+}
+
 void *gs_texture_get_obj(gs_texture_t *tex)
 {
 	graphics_t *graphics = thread_graphics;
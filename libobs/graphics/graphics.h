@@ -202,6 +202,14 @@ struct gs_monitor_info {
 	long cy;
 };
 
+struct gs_frame_stats {
+	uint32_t draw_calls;
+	uint32_t shader_loads;
+	uint32_t shader_param_uploads;
+	uint32_t texture_loads;
+	uint32_t sampler_loads;
+};
+
 struct gs_tvertarray {
 	size_t width;
 	void *array;
@@ -501,6 +509,7 @@ struct gs_init_data {
 #define GS_DEVICE_OPENGL 1
 #define GS_DEVICE_DIRECT3D_11 2
 #define GS_DEVICE_METAL 3
+#define GS_DEVICE_NULL 4
 
 EXPORT const char *gs_get_device_name(void);
 EXPORT const char *gs_get_driver_version(void);
@@ -680,6 +689,8 @@ EXPORT void gs_copy_texture_region(gs_texture_t *dst, uint32_t dst_x, uint32_t d
 EXPORT void gs_stage_texture(gs_stagesurf_t *dst, gs_texture_t *src);
 
 EXPORT void gs_begin_frame(void);
+/** Gets the number of device calls submitted since gs_begin_frame */
+EXPORT void gs_get_frame_stats(struct gs_frame_stats *stats);
 EXPORT void gs_begin_scene(void);
 EXPORT void gs_draw(enum gs_draw_mode draw_mode, uint32_t start_vert, uint32_t num_verts);
 EXPORT void gs_end_scene(void);
@@ -736,6 +747,14 @@ EXPORT void gs_texture_unmap(gs_texture_t *tex);
  * GL_TEXTURE_RECTANGLE type, which doesn't use normalized texture
  * coordinates, doesn't support mipmapping, and requires address clamping */
 EXPORT bool gs_texture_is_rect(const gs_texture_t *tex);
+/**
+ * Updates a region of a texture from memory.  Returns false if the graphics
+ * subsystem does not support partial updates (D3D11 and Metal dynamic
+ * textures must be rewritten entirely), in which case the caller should fall
+ * back to gs_texture_set_image.
+ */
+EXPORT bool gs_texture_set_image_rect(gs_texture_t *tex, const uint8_t *data, uint32_t linesize, uint32_t x, uint32_t y,
+				      uint32_t cx, uint32_t cy);
 /**
  * Gets a pointer to the context-specific object associated with the texture.
  * For example, for GL, this is a GLuint*.  For D3D11, ID3D11Texture2D*.
@@ -0,0 +1,422 @@
+/******************************************************************************
+    Copyright (C) 2026 by agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "image-animation.h"
+#include "srgb.h"
+#include "../util/base.h"
+#include "../util/bmem.h"
+#include "../util/crc32.h"
+#include "../util/platform.h"
+
+#include <inttypes.h>
+
+#define blog(level, format, ...) blog(level, "%s: " format, __FUNCTION__, __VA_ARGS__)
+
+static pthread_mutex_t animations_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct gs_image_animation *animations = NULL;
+
+static void *bi_def_bitmap_create(int width, int height)
+{
+	return bmalloc((size_t)4 * width * height);
+}
+
+static void bi_def_bitmap_set_opaque(void *bitmap, bool opaque)
+{
+	UNUSED_PARAMETER(bitmap);
+	UNUSED_PARAMETER(opaque);
+}
+
+static bool bi_def_bitmap_test_opaque(void *bitmap)
+{
+	UNUSED_PARAMETER(bitmap);
+	return false;
+}
+
+static unsigned char *bi_def_bitmap_get_buffer(void *bitmap)
+{
+	return (unsigned char *)bitmap;
+}
+
+static void bi_def_bitmap_destroy(void *bitmap)
+{
+	bfree(bitmap);
+}
+
+static void bi_def_bitmap_modified(void *bitmap)
+{
+	UNUSED_PARAMETER(bitmap);
+}
+
+static inline size_t frame_size(const struct gs_image_animation *anim)
+{
+	return (size_t)anim->cx * anim->cy * 4;
+}
+
+static void copy_frame(struct gs_image_animation *anim, uint8_t *dst, const uint8_t *src)
+{
+	const size_t area = (size_t)anim->cx * anim->cy;
+
+	if (anim->alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY_SRGB) {
+		gs_premultiply_xyza_srgb_loop_restrict(dst, src, area);
+	} else if (anim->alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY) {
+		gs_premultiply_xyza_loop_restrict(dst, src, area);
+	} else {
+		memcpy(dst, src, area * 4);
+	}
+}
+
+/* Stores the bounding rectangle of the pixels that differ between prev and
+ * cur, along with the pixels of cur inside it */
+static void store_delta(struct gs_image_animation *anim, struct gs_image_animation_frame *frame, const uint8_t *prev,
+			const uint8_t *cur)
+{
+	const size_t linesize = (size_t)anim->cx * 4;
+	uint32_t top = 0;
+	uint32_t bottom = anim->cy;
+	uint32_t left = anim->cx;
+	uint32_t right = 0;
+
+	while (top < bottom && memcmp(prev + top * linesize, cur + top * linesize, linesize) == 0)
+		top++;
+	if (top == bottom)
+		return;
+	while (memcmp(prev + (bottom - 1) * linesize, cur + (bottom - 1) * linesize, linesize) == 0)
+		bottom--;
+
+	for (uint32_t y = top; y < bottom; y++) {
+		const uint32_t *prev_row = (const uint32_t *)(prev + y * linesize);
+		const uint32_t *cur_row = (const uint32_t *)(cur + y * linesize);
+		uint32_t x = 0;
+		uint32_t end = anim->cx;
+
+		while (x < left && prev_row[x] == cur_row[x])
+			x++;
+		while (end > right && prev_row[end - 1] == cur_row[end - 1])
+			end--;
+
+		if (x < left)
+			left = x;
+		if (end > right)
+			right = end;
+	}
+
+	frame->x = left;
+	frame->y = top;
+	frame->cx = right - left;
+	frame->cy = bottom - top;
+	frame->data = bmalloc((size_t)frame->cx * frame->cy * 4);
+
+	for (uint32_t y = 0; y < frame->cy; y++) {
+		memcpy(frame->data + (size_t)y * frame->cx * 4, cur + (top + y) * linesize + (size_t)left * 4,
+		       (size_t)frame->cx * 4);
+	}
+}
+
+static void finish_decoding(struct gs_image_animation *anim)
+{
+	const struct gs_image_animation_frame *first = &anim->frames[0];
+	uint64_t delta_size = 0;
+
+	store_delta(anim, &anim->wrap, anim->prev, first->data);
+	os_atomic_set_bool(&anim->wrap_ready, true);
+
+	gif_finalise(&anim->gif);
+	bfree(anim->prev);
+	bfree(anim->cur);
+	anim->prev = NULL;
+	anim->cur = NULL;
+
+	for (unsigned int i = 1; i < anim->frame_count; i++)
+		delta_size += (uint64_t)anim->frames[i].cx * anim->frames[i].cy * 4;
+
+	blog(LOG_DEBUG, "Decoded %u frames, deltas take %" PRIu64 " of %" PRIu64 " bytes", anim->frame_count,
+	     delta_size, (uint64_t)frame_size(anim) * (anim->frame_count - 1));
+}
+
+/* Decodes the next frame; must be called with the mutex held.  Returns false
+ * once every frame has been decoded. */
+static bool decode_next_frame(struct gs_image_animation *anim)
+{
+	const unsigned int i = (unsigned int)os_atomic_load_long(&anim->decoded);
+	uint8_t *swap;
+
+	if (i >= anim->frame_count)
+		return false;
+
+	if (gif_decode_frame(&anim->gif, i) == GIF_OK) {
+		copy_frame(anim, anim->cur, anim->gif.frame_image);
+	} else {
+		/* keep showing the previous frame */
+		blog(LOG_WARNING, "Couldn't decode frame %u", i);
+		if (i == 0)
+			memset(anim->cur, 0, frame_size(anim));
+		else
+			memcpy(anim->cur, anim->prev, frame_size(anim));
+	}
+
+	if (i == 0) {
+		struct gs_image_animation_frame *first = &anim->frames[0];
+		first->cx = anim->cx;
+		first->cy = anim->cy;
+		first->data = bmemdup(anim->cur, frame_size(anim));
+	} else {
+		store_delta(anim, &anim->frames[i], anim->prev, anim->cur);
+	}
+
+	swap = anim->prev;
+	anim->prev = anim->cur;
+	anim->cur = swap;
+
+	os_atomic_set_long(&anim->decoded, (long)i + 1);
+
+	if (i + 1 == anim->frame_count)
+		finish_decoding(anim);
+	return true;
+}
+
+static void *decode_thread(void *data)
+{
+	struct gs_image_animation *anim = data;
+	bool more = true;
+
+	os_set_thread_name("image: gif decode");
+
+	while (more && !os_atomic_load_bool(&anim->stop)) {
+		pthread_mutex_lock(&anim->mutex);
+		more = decode_next_frame(anim);
+		pthread_mutex_unlock(&anim->mutex);
+	}
+
+	return NULL;
+}
+
+static void animation_destroy(struct gs_image_animation *anim)
+{
+	if (anim->thread_active) {
+		os_atomic_set_bool(&anim->stop, true);
+		pthread_join(anim->thread, NULL);
+	}
+
+	if (!os_atomic_load_bool(&anim->wrap_ready))
+		gif_finalise(&anim->gif);
+
+	for (unsigned int i = 0; i < anim->frame_count; i++)
+		bfree(anim->frames[i].data);
+	bfree(anim->wrap.data);
+	bfree(anim->frames);
+	bfree(anim->delays);
+	bfree(anim->prev);
+	bfree(anim->cur);
+	bfree(anim->file_data);
+	pthread_mutex_destroy(&anim->mutex);
+	bfree(anim);
+}
+
+static struct gs_image_animation *animation_create(const char *path, uint8_t *data, size_t size, uint32_t crc,
+						   enum gs_image_alpha_mode alpha_mode, bool *animated)
+{
+	struct gs_image_animation *anim = bzalloc(sizeof(*anim));
+	gif_result result;
+
+	anim->file_data = data;
+	anim->file_size = size;
+	anim->file_crc = crc;
+	anim->alpha_mode = alpha_mode;
+	anim->refs = 1;
+
+	anim->bitmap_callbacks.bitmap_create = bi_def_bitmap_create;
+	anim->bitmap_callbacks.bitmap_destroy = bi_def_bitmap_destroy;
+	anim->bitmap_callbacks.bitmap_get_buffer = bi_def_bitmap_get_buffer;
+	anim->bitmap_callbacks.bitmap_modified = bi_def_bitmap_modified;
+	anim->bitmap_callbacks.bitmap_set_opaque = bi_def_bitmap_set_opaque;
+	anim->bitmap_callbacks.bitmap_test_opaque = bi_def_bitmap_test_opaque;
+
+	pthread_mutex_init_value(&anim->mutex);
+	if (pthread_mutex_init(&anim->mutex, NULL) != 0)
+		goto fail;
+
+	gif_create(&anim->gif, &anim->bitmap_callbacks);
+
+	do {
+		result = gif_initialise(&anim->gif, size, data);
+		if (result < 0) {
+			blog(LOG_WARNING,
+			     "Failed to initialize gif '%s', "
+			     "possible file corruption",
+			     path);
+			goto fail;
+		}
+	} while (result != GIF_OK);
+
+	if (anim->gif.width > 4096 || anim->gif.height > 4096) {
+		blog(LOG_WARNING, "Bad texture dimensions (%dx%d) in '%s'", anim->gif.width, anim->gif.height, path);
+		goto fail;
+	}
+
+	if (anim->gif.frame_count <= 1) {
+		*animated = false;
+		goto fail;
+	}
+
+	anim->cx = (uint32_t)anim->gif.width;
+	anim->cy = (uint32_t)anim->gif.height;
+	anim->frame_count = anim->gif.frame_count;
+	anim->loop_count = anim->gif.loop_count;
+
+	anim->delays = bmalloc(anim->frame_count * sizeof(uint32_t));
+	for (unsigned int i = 0; i < anim->frame_count; i++)
+		anim->delays[i] = anim->gif.frames[i].frame_delay;
+
+	anim->frames = bzalloc(anim->frame_count * sizeof(struct gs_image_animation_frame));
+	anim->prev = bmalloc(frame_size(anim));
+	anim->cur = bmalloc(frame_size(anim));
+
+	decode_next_frame(anim);
+
+	if (pthread_create(&anim->thread, NULL, decode_thread, anim) == 0)
+		anim->thread_active = true;
+	else
+		blog(LOG_WARNING, "Failed to create decode thread for '%s'", path);
+
+	return anim;
+
+fail:
+	animation_destroy(anim);
+	return NULL;
+}
+
+struct gs_image_animation *gs_image_animation_acquire(const char *path, enum gs_image_alpha_mode alpha_mode,
+						      bool *animated)
+{
+	struct gs_image_animation *anim;
+	uint8_t *data = NULL;
+	size_t size, size_read;
+	uint32_t crc;
+	FILE *file;
+
+	*animated = true;
+
+	file = os_fopen(path, "rb");
+	if (!file) {
+		blog(LOG_WARNING, "Failed to open file '%s'", path);
+		return NULL;
+	}
+
+	fseek(file, 0, SEEK_END);
+	size = (size_t)os_ftelli64(file);
+	fseek(file, 0, SEEK_SET);
+
+	data = bmalloc(size);
+	size_read = fread(data, 1, size, file);
+	fclose(file);
+
+	if (size_read != size) {
+		blog(LOG_WARNING, "Failed to fully read gif file '%s'.", path);
+		bfree(data);
+		return NULL;
+	}
+
+	crc = calc_crc32(0, data, size);
+
+	/* the lock is held while loading so the same file is never decoded
+	 * twice by images loading it at the same time */
+	pthread_mutex_lock(&animations_mutex);
+
+	for (anim = animations; anim; anim = anim->next) {
+		if (anim->file_crc == crc && anim->file_size == size && anim->alpha_mode == alpha_mode &&
+		    memcmp(anim->file_data, data, size) == 0)
+			break;
+	}
+
+	if (anim) {
+		anim->refs++;
+		bfree(data);
+	} else {
+		anim = animation_create(path, data, size, crc, alpha_mode, animated);
+		if (anim) {
+			anim->next = animations;
+			animations = anim;
+		}
+	}
+
+	pthread_mutex_unlock(&animations_mutex);
+	return anim;
+}
+
+void gs_image_animation_release(struct gs_image_animation *anim)
+{
+	bool destroy;
+
+	if (!anim)
+		return;
+
+	pthread_mutex_lock(&animations_mutex);
+
+	destroy = --anim->refs == 0;
+	if (destroy) {
+		struct gs_image_animation **prev = &animations;
+		while (*prev != anim)
+			prev = &(*prev)->next;
+		*prev = anim->next;
+	}
+
+	pthread_mutex_unlock(&animations_mutex);
+
+	if (destroy)
+		animation_destroy(anim);
+}
+
+const struct gs_image_animation_frame *gs_image_animation_get_frame(struct gs_image_animation *anim,
+								    unsigned int frame)
+{
+	if (frame >= anim->frame_count)
+		return NULL;
+
+	if ((unsigned long)os_atomic_load_long(&anim->decoded) <= frame) {
+		pthread_mutex_lock(&anim->mutex);
+		while ((unsigned long)os_atomic_load_long(&anim->decoded) <= frame)
+			decode_next_frame(anim);
+		pthread_mutex_unlock(&anim->mutex);
+	}
+
+	return &anim->frames[frame];
+}
+
+const struct gs_image_animation_frame *gs_image_animation_get_wrap(struct gs_image_animation *anim)
+{
+	return os_atomic_load_bool(&anim->wrap_ready) ? &anim->wrap : NULL;
+}
+
+uint64_t gs_image_animation_get_memory(struct gs_image_animation *anim)
+{
+	const long decoded = os_atomic_load_long(&anim->decoded);
+	uint64_t memory = anim->file_size;
+
+	memory += anim->frame_count * (sizeof(uint32_t) + sizeof(struct gs_image_animation_frame));
+
+	for (long i = 0; i < decoded; i++)
+		memory += (uint64_t)anim->frames[i].cx * anim->frames[i].cy * 4;
+
+	if (os_atomic_load_bool(&anim->wrap_ready)) {
+		memory += (uint64_t)anim->wrap.cx * anim->wrap.cy * 4;
+	} else {
+		/* scratch frames and the decoder's own bitmap */
+		memory += (uint64_t)frame_size(anim) * 3;
+	}
+
+	return memory;
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+    Copyright (C) 2026 by agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include "graphics.h"
+#include "libnsgif/libnsgif.h"
+#include "../util/threading.h"
+
+/*
+ * Decoded animated gifs, shared by every image that loads the same file
+ * contents with the same alpha mode.
+ *
+ * The first frame is kept whole.  Every other frame only keeps the rectangle
+ * that changed since the frame before it, plus one more delta that takes the
+ * last frame back to the first one.  Frames are decoded ahead on a thread per
+ * animation; a frame that is needed before the thread got to it is decoded
+ * right away by the caller.
+ */
+
+struct gs_image_animation_frame {
+	uint32_t x;
+	uint32_t y;
+	uint32_t cx;
+	uint32_t cy;
+	/* cx * 4 bytes per row, NULL if nothing changed */
+	uint8_t *data;
+};
+
+struct gs_image_animation {
+	uint32_t cx;
+	uint32_t cy;
+	unsigned int frame_count;
+	int loop_count;
+	uint32_t *delays;
+
+	struct gs_image_animation_frame *frames;
+	struct gs_image_animation_frame wrap;
+
+	/* frames below this index are ready to read */
+	volatile long decoded;
+	volatile bool wrap_ready;
+
+	/* the rest is private to image-animation.c */
+	struct gs_image_animation *next;
+	long refs;
+
+	uint8_t *file_data;
+	size_t file_size;
+	uint32_t file_crc;
+	enum gs_image_alpha_mode alpha_mode;
+
+	pthread_mutex_t mutex;
+	gif_animation gif;
+	gif_bitmap_callback_vt bitmap_callbacks;
+	uint8_t *prev;
+	uint8_t *cur;
+
+	pthread_t thread;
+	bool thread_active;
+	volatile bool stop;
+};
+
+/* Returns the shared animation for the file, loading it and decoding its
+ * first frame if nobody else has.  Returns NULL if the file fails to load,
+ * in which case *animated is false if the file is a gif with only one frame
+ * and should be loaded as a still image. */
+extern struct gs_image_animation *gs_image_animation_acquire(const char *path, enum gs_image_alpha_mode alpha_mode,
+							      bool *animated);
+extern void gs_image_animation_release(struct gs_image_animation *anim);
+
+/* Returns the frame, decoding it and any frames before it first if the decode
+ * thread has not gotten to them yet. */
+extern const struct gs_image_animation_frame *gs_image_animation_get_frame(struct gs_image_animation *anim,
+									    unsigned int frame);
+
+/* Returns the delta from the last frame back to the first one, or NULL if
+ * the last frame has not been decoded yet. */
+extern const struct gs_image_animation_frame *gs_image_animation_get_wrap(struct gs_image_animation *anim);
+
+/* Memory held by the animation so far, including the file data it decodes
+ * from */
+extern uint64_t gs_image_animation_get_memory(struct gs_image_animation *anim);
@@ -16,6 +16,7 @@
 ******************************************************************************/
 
 #include "image-file.h"
+#include "image-animation.h"
 #include "../util/base.h"
 #include "../util/platform.h"
 #include "../util/dstr.h"
@@ -23,159 +24,35 @@
 
 #define blog(level, format, ...) blog(level, "%s: " format, __FUNCTION__, __VA_ARGS__)
 
-static void *bi_def_bitmap_create(int width, int height)
+static inline uint64_t get_animated_gif_mem_usage(gs_image_file_t *image)
 {
-	return bmalloc((size_t)4 * width * height);
-}
-
-static void bi_def_bitmap_set_opaque(void *bitmap, bool opaque)
-{
-	UNUSED_PARAMETER(bitmap);
-	UNUSED_PARAMETER(opaque);
-}
-
-static bool bi_def_bitmap_test_opaque(void *bitmap)
-{
-	UNUSED_PARAMETER(bitmap);
-	return false;
-}
-
-static unsigned char *bi_def_bitmap_get_buffer(void *bitmap)
-{
-	return (unsigned char *)bitmap;
-}
-
-static void bi_def_bitmap_destroy(void *bitmap)
-{
-	bfree(bitmap);
-}
-
-static void bi_def_bitmap_modified(void *bitmap)
-{
-	UNUSED_PARAMETER(bitmap);
-}
-
-static inline int get_full_decoded_gif_size(gs_image_file_t *image)
-{
-	return image->gif.width * image->gif.height * 4 * image->gif.frame_count;
-}
-
-static inline void *alloc_mem(gs_image_file_t *image, uint64_t *mem_usage, size_t size)
-{
-	UNUSED_PARAMETER(image);
-
-	if (mem_usage)
-		*mem_usage += size;
-	return bzalloc(size);
+	/* the frame kept for the texture, the texture, and the shared frames */
+	return (uint64_t)image->cx * image->cy * 4 * 2 + gs_image_animation_get_memory(image->animation);
 }
 
 static bool init_animated_gif(gs_image_file_t *image, const char *path, uint64_t *mem_usage,
 			      enum gs_image_alpha_mode alpha_mode)
 {
-	bool is_animated_gif = true;
-	gif_result result;
-	uint64_t max_size;
-	size_t size, size_read;
-	FILE *file;
-
-	image->bitmap_callbacks.bitmap_create = bi_def_bitmap_create;
-	image->bitmap_callbacks.bitmap_destroy = bi_def_bitmap_destroy;
-	image->bitmap_callbacks.bitmap_get_buffer = bi_def_bitmap_get_buffer;
-	image->bitmap_callbacks.bitmap_modified = bi_def_bitmap_modified;
-	image->bitmap_callbacks.bitmap_set_opaque = bi_def_bitmap_set_opaque;
-	image->bitmap_callbacks.bitmap_test_opaque = bi_def_bitmap_test_opaque;
-
-	gif_create(&image->gif, &image->bitmap_callbacks);
-
-	file = os_fopen(path, "rb");
-	if (!file) {
-		blog(LOG_WARNING, "Failed to open file '%s'", path);
-		goto fail;
-	}
-
-	fseek(file, 0, SEEK_END);
-	size = (size_t)os_ftelli64(file);
-	fseek(file, 0, SEEK_SET);
-
-	image->gif_data = bmalloc(size);
-	size_read = fread(image->gif_data, 1, size, file);
-	if (size_read != size) {
-		blog(LOG_WARNING, "Failed to fully read gif file '%s'.", path);
-		goto fail;
-	}
-
-	do {
-		result = gif_initialise(&image->gif, size, image->gif_data);
-		if (result < 0) {
-			blog(LOG_WARNING,
-			     "Failed to initialize gif '%s', "
-			     "possible file corruption",
-			     path);
-			goto fail;
-		}
-	} while (result != GIF_OK);
-
-	if (image->gif.width > 4096 || image->gif.height > 4096) {
-		blog(LOG_WARNING, "Bad texture dimensions (%dx%d) in '%s'", image->gif.width, image->gif.height, path);
-		goto fail;
-	}
-
-	max_size = (uint64_t)image->gif.width * (uint64_t)image->gif.height * (uint64_t)image->gif.frame_count * 4LLU;
-
-	if ((uint64_t)get_full_decoded_gif_size(image) != max_size) {
-		blog(LOG_WARNING, "Gif '%s' overflowed maximum pointer size", path);
-		goto fail;
-	}
-
-	image->is_animated_gif = (image->gif.frame_count > 1 && result >= 0);
-	if (image->is_animated_gif) {
-		gif_decode_frame(&image->gif, 0);
-
-		image->animation_frame_cache = alloc_mem(image, mem_usage, image->gif.frame_count * sizeof(uint8_t *));
-		image->animation_frame_data = alloc_mem(image, mem_usage, get_full_decoded_gif_size(image));
-
-		for (unsigned int i = 0; i < image->gif.frame_count; i++) {
-			if (gif_decode_frame(&image->gif, i) != GIF_OK)
-				blog(LOG_WARNING,
-				     "Couldn't decode frame %u "
-				     "of '%s'",
-				     i, path);
-		}
+	const struct gs_image_animation_frame *first;
+	bool is_animated_gif;
 
-		gif_decode_frame(&image->gif, 0);
+	image->animation = gs_image_animation_acquire(path, alpha_mode, &is_animated_gif);
+	if (!image->animation)
+		return is_animated_gif;
 
-		image->cx = (uint32_t)image->gif.width;
-		image->cy = (uint32_t)image->gif.height;
-		image->format = GS_RGBA;
+	image->is_animated_gif = true;
+	image->cx = image->animation->cx;
+	image->cy = image->animation->cy;
+	image->format = GS_RGBA;
 
-		if (mem_usage) {
-			*mem_usage += (size_t)4 * image->cx * image->cy;
-			*mem_usage += size;
-		}
+	first = gs_image_animation_get_frame(image->animation, 0);
+	image->animation_frame_data = bmemdup(first->data, (size_t)image->cx * image->cy * 4);
 
-		if (alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY_SRGB) {
-			gs_premultiply_xyza_srgb_loop(image->gif.frame_image, (size_t)image->cx * image->cy);
-		} else if (alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY) {
-			gs_premultiply_xyza_loop(image->gif.frame_image, (size_t)image->cx * image->cy);
-		}
-	} else {
-		gif_finalise(&image->gif);
-		bfree(image->gif_data);
-		image->gif_data = NULL;
-		is_animated_gif = false;
-		goto not_animated;
-	}
+	if (mem_usage)
+		*mem_usage += get_animated_gif_mem_usage(image);
 
 	image->loaded = true;
-
-fail:
-	if (!image->loaded)
-		gs_image_file_free(image);
-not_animated:
-	if (file)
-		fclose(file);
-
-	return is_animated_gif;
+	return true;
 }
 
 static void gs_image_file_init_internal(gs_image_file_t *image, const char *file, uint64_t *mem_usage,
@@ -226,8 +103,7 @@ void gs_image_file_free(gs_image_file_t *image)
 
 	if (image->loaded) {
 		if (image->is_animated_gif) {
-			gif_finalise(&image->gif);
-			bfree(image->animation_frame_cache);
+			gs_image_animation_release(image->animation);
 			bfree(image->animation_frame_data);
 		}
 
@@ -266,7 +142,7 @@ void gs_image_file_init_texture(gs_image_file_t *image)
 
 	if (image->is_animated_gif) {
 		image->texture = gs_texture_create(image->cx, image->cy, image->format, 1,
-						   (const uint8_t **)&image->gif.frame_image, GS_DYNAMIC);
+						   (const uint8_t **)&image->animation_frame_data, GS_DYNAMIC);
 
 	} else {
 		image->texture = gs_texture_create(image->cx, image->cy, image->format, 1,
@@ -278,7 +154,7 @@ void gs_image_file_init_texture(gs_image_file_t *image)
 
 static inline uint64_t get_time(gs_image_file_t *image, int i)
 {
-	uint64_t val = (uint64_t)image->gif.frames[i].frame_delay * 10000000ULL;
+	uint64_t val = (uint64_t)image->animation->delays[i] * 10000000ULL;
 	if (!val)
 		val = 100000000;
 	return val;
@@ -295,7 +171,7 @@ static inline int calculate_new_frame(gs_image_file_t *image, uint64_t elapsed_t
 			break;
 
 		image->cur_time -= t;
-		if ((unsigned int)++new_frame == image->gif.frame_count) {
+		if ((unsigned int)++new_frame == image->animation->frame_count) {
 			if (!loops || ++image->cur_loop < loops) {
 				new_frame = 0;
 			} else if (image->cur_loop == loops) {
@@ -308,50 +184,14 @@ static inline int calculate_new_frame(gs_image_file_t *image, uint64_t elapsed_t
 	return new_frame;
 }
 
-static void decode_new_frame(gs_image_file_t *image, int new_frame, enum gs_image_alpha_mode alpha_mode)
-{
-	if (!image->animation_frame_cache[new_frame]) {
-		int last_frame;
-
-		/* if looped, decode frame 0 */
-		last_frame = (new_frame < image->last_decoded_frame) ? 0 : image->last_decoded_frame + 1;
-
-		/* decode missed frames */
-		for (int i = last_frame; i < new_frame; i++) {
-			if (gif_decode_frame(&image->gif, i) != GIF_OK)
-				return;
-		}
-
-		/* decode actual desired frame */
-		if (gif_decode_frame(&image->gif, new_frame) == GIF_OK) {
-			const size_t area = (size_t)image->gif.width * image->gif.height;
-			size_t pos = new_frame * area * 4;
-			image->animation_frame_cache[new_frame] = image->animation_frame_data + pos;
-
-			if (alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY_SRGB) {
-				gs_premultiply_xyza_srgb_loop(image->gif.frame_image, area);
-			} else if (alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY) {
-				gs_premultiply_xyza_loop(image->gif.frame_image, area);
-			}
-
-			memcpy(image->animation_frame_cache[new_frame], image->gif.frame_image, area * 4);
-
-			image->last_decoded_frame = new_frame;
-		}
-	}
-
-	image->cur_frame = new_frame;
-}
-
-static bool gs_image_file_tick_internal(gs_image_file_t *image, uint64_t elapsed_time_ns,
-					enum gs_image_alpha_mode alpha_mode)
+static bool gs_image_file_tick_internal(gs_image_file_t *image, uint64_t elapsed_time_ns, uint64_t *mem_usage)
 {
 	int loops;
 
 	if (!image->is_animated_gif || !image->loaded)
 		return false;
 
-	loops = image->gif.loop_count;
+	loops = image->animation->loop_count;
 	if (loops >= 0xFFFF)
 		loops = 0;
 
@@ -359,7 +199,12 @@ static bool gs_image_file_tick_internal(gs_image_file_t *image, uint64_t elapsed
 		int new_frame = calculate_new_frame(image, elapsed_time_ns, loops);
 
 		if (new_frame != image->cur_frame) {
-			decode_new_frame(image, new_frame, alpha_mode);
+			/* frames are decoded ahead, so the shared cache keeps
+			 * growing until the whole animation is decoded */
+			if (mem_usage)
+				*mem_usage = get_animated_gif_mem_usage(image);
+
+			image->cur_frame = new_frame;
 			return true;
 		}
 	}
@@ -369,52 +214,105 @@ static bool gs_image_file_tick_internal(gs_image_file_t *image, uint64_t elapsed
 
 bool gs_image_file_tick(gs_image_file_t *image, uint64_t elapsed_time_ns)
 {
-	return gs_image_file_tick_internal(image, elapsed_time_ns, false);
+	return gs_image_file_tick_internal(image, elapsed_time_ns, NULL);
 }
 
 bool gs_image_file2_tick(gs_image_file2_t *if2, uint64_t elapsed_time_ns)
 {
-	return gs_image_file_tick_internal(&if2->image, elapsed_time_ns, false);
+	return gs_image_file_tick_internal(&if2->image, elapsed_time_ns, &if2->mem_usage);
 }
 
 bool gs_image_file3_tick(gs_image_file3_t *if3, uint64_t elapsed_time_ns)
 {
-	return gs_image_file_tick_internal(&if3->image2.image, elapsed_time_ns, if3->alpha_mode);
+	return gs_image_file2_tick(&if3->image2, elapsed_time_ns);
 }
 
 bool gs_image_file4_tick(gs_image_file4_t *if4, uint64_t elapsed_time_ns)
 {
-	return gs_image_file_tick_internal(&if4->image3.image2.image, elapsed_time_ns, if4->image3.alpha_mode);
+	return gs_image_file3_tick(&if4->image3, elapsed_time_ns);
+}
+
+struct dirty_rect {
+	uint32_t left;
+	uint32_t top;
+	uint32_t right;
+	uint32_t bottom;
+};
+
+static void apply_frame(gs_image_file_t *image, const struct gs_image_animation_frame *frame, struct dirty_rect *dirty)
+{
+	const size_t linesize = (size_t)image->cx * 4;
+
+	if (!frame || !frame->data)
+		return;
+
+	for (uint32_t y = 0; y < frame->cy; y++) {
+		memcpy(image->animation_frame_data + (frame->y + y) * linesize + (size_t)frame->x * 4,
+		       frame->data + (size_t)y * frame->cx * 4, (size_t)frame->cx * 4);
+	}
+
+	if (frame->x < dirty->left)
+		dirty->left = frame->x;
+	if (frame->y < dirty->top)
+		dirty->top = frame->y;
+	if (frame->x + frame->cx > dirty->right)
+		dirty->right = frame->x + frame->cx;
+	if (frame->y + frame->cy > dirty->bottom)
+		dirty->bottom = frame->y + frame->cy;
 }
 
-static void gs_image_file_update_texture_internal(gs_image_file_t *image, enum gs_image_alpha_mode alpha_mode)
+static void gs_image_file_update_texture_internal(gs_image_file_t *image)
 {
+	struct gs_image_animation *anim = image->animation;
+	struct dirty_rect dirty = {image->cx, image->cy, 0, 0};
+	unsigned int frame = (unsigned int)image->last_decoded_frame;
+	unsigned int new_frame = (unsigned int)image->cur_frame;
+	const uint32_t linesize = image->cx * 4;
+
 	if (!image->is_animated_gif || !image->loaded)
 		return;
 
-	if (!image->animation_frame_cache[image->cur_frame])
-		decode_new_frame(image, image->cur_frame, alpha_mode);
+	/* bring the frame kept for the texture up to date, one delta at a
+	 * time, and only upload what changed */
+	if (new_frame < frame) {
+		const struct gs_image_animation_frame *wrap = NULL;
+
+		if (frame == anim->frame_count - 1)
+			wrap = gs_image_animation_get_wrap(anim);
+		apply_frame(image, wrap ? wrap : gs_image_animation_get_frame(anim, 0), &dirty);
+		frame = 0;
+	}
+
+	while (frame < new_frame)
+		apply_frame(image, gs_image_animation_get_frame(anim, ++frame), &dirty);
+
+	image->last_decoded_frame = (int)new_frame;
+
+	if (dirty.right <= dirty.left || dirty.bottom <= dirty.top)
+		return;
 
-	gs_texture_set_image(image->texture, image->animation_frame_cache[image->cur_frame], image->gif.width * 4,
-			     false);
+	if (!gs_texture_set_image_rect(image->texture,
+				       image->animation_frame_data + dirty.top * linesize + dirty.left * 4, linesize,
+				       dirty.left, dirty.top, dirty.right - dirty.left, dirty.bottom - dirty.top))
+		gs_texture_set_image(image->texture, image->animation_frame_data, linesize, false);
 }
 
 void gs_image_file_update_texture(gs_image_file_t *image)
 {
-	gs_image_file_update_texture_internal(image, false);
+	gs_image_file_update_texture_internal(image);
 }
 
 void gs_image_file2_update_texture(gs_image_file2_t *if2)
 {
-	gs_image_file_update_texture_internal(&if2->image, false);
+	gs_image_file_update_texture_internal(&if2->image);
 }
 
 void gs_image_file3_update_texture(gs_image_file3_t *if3)
 {
-	gs_image_file_update_texture_internal(&if3->image2.image, if3->alpha_mode);
+	gs_image_file_update_texture_internal(&if3->image2.image);
 }
 
 void gs_image_file4_update_texture(gs_image_file4_t *if4)
 {
-	gs_image_file_update_texture_internal(&if4->image3.image2.image, if4->image3.alpha_mode);
+	gs_image_file_update_texture_internal(&if4->image3.image2.image);
 }
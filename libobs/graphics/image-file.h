@@ -24,6 +24,8 @@
 extern "C" {
 #endif
 
+struct gs_image_animation;
+
 struct gs_image_file {
 	gs_texture_t *texture;
 	enum gs_color_format format;
@@ -33,9 +35,12 @@ struct gs_image_file {
 	bool frame_updated;
 	bool loaded;
 
+	/* animated gifs are decoded by a cache shared between images, these
+	 * are left unused */
 	gif_animation gif;
 	uint8_t *gif_data;
-	uint8_t **animation_frame_cache;
+
+	struct gs_image_animation *animation;
 	uint8_t *animation_frame_data;
 	uint64_t cur_time;
 	int cur_frame;
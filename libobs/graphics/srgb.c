@@ -0,0 +1,91 @@
+/******************************************************************************
+    Copyright (C) 2026 by agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "srgb.h"
+#include "../util/sse-intrin.h"
+#include "../util/threading.h"
+
+/* Premultiplied sRGB values for every alpha and color, indexed as
+ * [alpha * 256 + color].  Built with the per-texel functions, so the
+ * results are the same as theirs without any powf calls per texel. */
+static uint8_t srgb_premultiply_table[256 * 256];
+static pthread_once_t srgb_premultiply_once = PTHREAD_ONCE_INIT;
+
+static void init_srgb_premultiply_table(void)
+{
+	float linear[256];
+
+	for (int c = 0; c < 256; c++)
+		linear[c] = gs_srgb_nonlinear_to_linear(gs_u8_to_float((uint8_t)c));
+
+	for (int a = 0; a < 256; a++) {
+		const float alpha = gs_u8_to_float((uint8_t)a);
+		uint8_t *row = &srgb_premultiply_table[a * 256];
+
+		for (int c = 0; c < 256; c++)
+			row[c] = gs_float_to_u8(gs_srgb_linear_to_nonlinear(linear[c] * alpha));
+	}
+}
+
+void gs_premultiply_xyza_texels(uint8_t *dst, const uint8_t *src, size_t texel_count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	/* multiply color by alpha, and alpha by 255 to keep it as is */
+	const __m128i color_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	const __m128i alpha_255 = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+	const __m128i round = _mm_set1_epi16(128);
+	size_t i = 0;
+
+	for (; i + 4 <= texel_count; i += 4) {
+		const __m128i texels = _mm_loadu_si128((const __m128i *)(src + i * 4));
+		__m128i lo = _mm_unpacklo_epi8(texels, zero);
+		__m128i hi = _mm_unpackhi_epi8(texels, zero);
+		__m128i alpha_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF);
+		__m128i alpha_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF);
+
+		alpha_lo = _mm_or_si128(_mm_and_si128(alpha_lo, color_mask), alpha_255);
+		alpha_hi = _mm_or_si128(_mm_and_si128(alpha_hi, color_mask), alpha_255);
+
+		/* x / 255 rounded to nearest, exact for x <= 255 * 255 */
+		lo = _mm_add_epi16(_mm_mullo_epi16(lo, alpha_lo), round);
+		hi = _mm_add_epi16(_mm_mullo_epi16(hi, alpha_hi), round);
+		lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+		_mm_storeu_si128((__m128i *)(dst + i * 4), _mm_packus_epi16(lo, hi));
+	}
+
+	for (; i < texel_count; i++)
+		gs_premultiply_xyza_restrict(dst + i * 4, src + i * 4);
+}
+
+void gs_premultiply_xyza_srgb_texels(uint8_t *dst, const uint8_t *src, size_t texel_count)
+{
+	pthread_once(&srgb_premultiply_once, init_srgb_premultiply_table);
+
+	for (size_t i = 0; i < texel_count; i++) {
+		const uint8_t *row = &srgb_premultiply_table[src[3] * 256];
+		const uint8_t alpha = src[3];
+
+		dst[0] = row[src[0]];
+		dst[1] = row[src[1]];
+		dst[2] = row[src[2]];
+		dst[3] = alpha;
+		dst += 4;
+		src += 4;
+	}
+}
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include "../util/c99defs.h"
+
 #include <math.h>
 #include <string.h>
 
@@ -136,40 +138,33 @@ static inline void gs_premultiply_xyza_srgb_restrict(uint8_t *__restrict dst, co
 	memcpy(dst, &u, sizeof(u));
 }
 
+/* Premultiply whole rows of texels at once; dst may be the same as src.
+ * gs_premultiply_xyza_texels uses SSE2 (NEON through SIMDe on ARM), and
+ * gs_premultiply_xyza_srgb_texels looks every value up in a table built from
+ * the per-texel functions above, so the results match them exactly. */
+EXPORT void gs_premultiply_xyza_texels(uint8_t *dst, const uint8_t *src, size_t texel_count);
+EXPORT void gs_premultiply_xyza_srgb_texels(uint8_t *dst, const uint8_t *src, size_t texel_count);
+
 static inline void gs_premultiply_xyza_loop(uint8_t *data, size_t texel_count)
 {
-	for (size_t i = 0; i < texel_count; ++i) {
-		gs_premultiply_xyza(data);
-		data += 4;
-	}
+	gs_premultiply_xyza_texels(data, data, texel_count);
 }
 
 static inline void gs_premultiply_xyza_srgb_loop(uint8_t *data, size_t texel_count)
 {
-	for (size_t i = 0; i < texel_count; ++i) {
-		gs_premultiply_xyza_srgb(data);
-		data += 4;
-	}
+	gs_premultiply_xyza_srgb_texels(data, data, texel_count);
 }
 
 static inline void gs_premultiply_xyza_loop_restrict(uint8_t *__restrict dst, const uint8_t *__restrict src,
 						     size_t texel_count)
 {
-	for (size_t i = 0; i < texel_count; ++i) {
-		gs_premultiply_xyza_restrict(dst, src);
-		dst += 4;
-		src += 4;
-	}
+	gs_premultiply_xyza_texels(dst, src, texel_count);
 }
 
 static inline void gs_premultiply_xyza_srgb_loop_restrict(uint8_t *__restrict dst, const uint8_t *__restrict src,
 							  size_t texel_count)
 {
-	for (size_t i = 0; i < texel_count; ++i) {
-		gs_premultiply_xyza_srgb_restrict(dst, src);
-		dst += 4;
-		src += 4;
-	}
+	gs_premultiply_xyza_srgb_texels(dst, src, texel_count);
 }
 
 #ifdef __cplusplus
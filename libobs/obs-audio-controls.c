@@ -61,9 +61,47 @@ struct meter_cb {
 	void *param;
 };
 
+#define METER_HISTORY 16
+
+struct meter_levels {
+	long index;
+	bool silenced;
+	float magnitude[MAX_AUDIO_CHANNELS];
+	float sample_peak[MAX_AUDIO_CHANNELS];
+	float true_peak[MAX_AUDIO_CHANNELS];
+};
+
+struct meter_slot {
+	/* odd while the levels are being written */
+	volatile long seq;
+	struct meter_levels levels;
+};
+
+/* Levels of a single source.  They are computed once per audio packet no
+ * matter how many volume meters are attached to the source, and the levels
+ * of the last few packets are kept so that meters can be polled without
+ * blocking the audio thread. */
+struct audio_meter {
+	obs_source_t *source;
+	long refs;
+	volatile long true_peak_refs;
+
+	float prev_samples[MAX_AUDIO_CHANNELS][4];
+
+	volatile long count;
+	struct meter_slot history[METER_HISTORY];
+
+	pthread_mutex_t mutex;
+	DARRAY(struct obs_volmeter *) volmeters;
+};
+
+/* Guards audio_meter::refs and obs_source::audio_meter */
+static pthread_mutex_t meter_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 struct obs_volmeter {
 	pthread_mutex_t mutex;
 	obs_source_t *source;
+	struct audio_meter *meter;
 	enum obs_fader_type type;
 	float cur_db;
 
@@ -72,10 +110,7 @@ struct obs_volmeter {
 
 	enum obs_peak_meter_type peak_meter_type;
 	unsigned int update_ms;
-	float prev_samples[MAX_AUDIO_CHANNELS][4];
-
-	float magnitude[MAX_AUDIO_CHANNELS];
-	float peak[MAX_AUDIO_CHANNELS];
+	long read_count;
 };
 
 static float cubic_def_to_db(const float def)
@@ -360,24 +395,38 @@ static float get_true_peak(__m128 previous_samples, const float *samples, size_t
 	return r;
 }
 
-/* points contain the first four samples to calculate the sinc interpolation
- * over. They will have come from a previous iteration.
+/* Calculates the sample peak and the magnitude in a single pass.
+ * previous_samples are the last four samples of the previous packet, and are
+ * included in the peak.
  */
-static float get_sample_peak(__m128 previous_samples, const float *samples, size_t nr_samples)
+static float get_sample_peak_and_magnitude(__m128 previous_samples, const float *samples, size_t nr_samples,
+					   float *magnitude)
 {
 	__m128 peak = previous_samples;
-	for (size_t i = 0; (i + 3) < nr_samples; i += 4) {
+	__m128 sum4 = _mm_setzero_ps();
+	size_t i = 0;
+
+	for (; (i + 3) < nr_samples; i += 4) {
 		__m128 new_work = _mm_load_ps(&samples[i]);
 		peak = _mm_max_ps(peak, abs_ps(new_work));
+		sum4 = _mm_add_ps(sum4, _mm_mul_ps(new_work, new_work));
 	}
 
+	float sum_mem[4];
+	_mm_storeu_ps(sum_mem, sum4);
+	float sum = sum_mem[0] + sum_mem[1] + sum_mem[2] + sum_mem[3];
+	for (; i < nr_samples; i++)
+		sum += samples[i] * samples[i];
+
+	*magnitude = nr_samples ? sqrtf(sum / nr_samples) : 0.0f;
+
 	float r;
 	hmax_ps(r, peak);
 	return r;
 }
 
-static void volmeter_process_peak_last_samples(obs_volmeter_t *volmeter, int channel_nr, float *samples,
-					       size_t nr_samples)
+static void audio_meter_process_last_samples(struct audio_meter *meter, int channel_nr, float *samples,
+					     size_t nr_samples)
 {
 	/* Take the last 4 samples that need to be used for the next peak
 	 * calculation. If there are less than 4 samples in total the new
@@ -387,35 +436,38 @@ static void volmeter_process_peak_last_samples(obs_volmeter_t *volmeter, int cha
 	case 0:
 		break;
 	case 1:
-		volmeter->prev_samples[channel_nr][0] = volmeter->prev_samples[channel_nr][1];
-		volmeter->prev_samples[channel_nr][1] = volmeter->prev_samples[channel_nr][2];
-		volmeter->prev_samples[channel_nr][2] = volmeter->prev_samples[channel_nr][3];
-		volmeter->prev_samples[channel_nr][3] = samples[nr_samples - 1];
+		meter->prev_samples[channel_nr][0] = meter->prev_samples[channel_nr][1];
+		meter->prev_samples[channel_nr][1] = meter->prev_samples[channel_nr][2];
+		meter->prev_samples[channel_nr][2] = meter->prev_samples[channel_nr][3];
+		meter->prev_samples[channel_nr][3] = samples[nr_samples - 1];
 		break;
 	case 2:
-		volmeter->prev_samples[channel_nr][0] = volmeter->prev_samples[channel_nr][2];
-		volmeter->prev_samples[channel_nr][1] = volmeter->prev_samples[channel_nr][3];
-		volmeter->prev_samples[channel_nr][2] = samples[nr_samples - 2];
-		volmeter->prev_samples[channel_nr][3] = samples[nr_samples - 1];
+		meter->prev_samples[channel_nr][0] = meter->prev_samples[channel_nr][2];
+		meter->prev_samples[channel_nr][1] = meter->prev_samples[channel_nr][3];
+		meter->prev_samples[channel_nr][2] = samples[nr_samples - 2];
+		meter->prev_samples[channel_nr][3] = samples[nr_samples - 1];
 		break;
 	case 3:
-		volmeter->prev_samples[channel_nr][0] = volmeter->prev_samples[channel_nr][3];
-		volmeter->prev_samples[channel_nr][1] = samples[nr_samples - 3];
-		volmeter->prev_samples[channel_nr][2] = samples[nr_samples - 2];
-		volmeter->prev_samples[channel_nr][3] = samples[nr_samples - 1];
+		meter->prev_samples[channel_nr][0] = meter->prev_samples[channel_nr][3];
+		meter->prev_samples[channel_nr][1] = samples[nr_samples - 3];
+		meter->prev_samples[channel_nr][2] = samples[nr_samples - 2];
+		meter->prev_samples[channel_nr][3] = samples[nr_samples - 1];
 		break;
 	default:
-		volmeter->prev_samples[channel_nr][0] = samples[nr_samples - 4];
-		volmeter->prev_samples[channel_nr][1] = samples[nr_samples - 3];
-		volmeter->prev_samples[channel_nr][2] = samples[nr_samples - 2];
-		volmeter->prev_samples[channel_nr][3] = samples[nr_samples - 1];
+		meter->prev_samples[channel_nr][0] = samples[nr_samples - 4];
+		meter->prev_samples[channel_nr][1] = samples[nr_samples - 3];
+		meter->prev_samples[channel_nr][2] = samples[nr_samples - 2];
+		meter->prev_samples[channel_nr][3] = samples[nr_samples - 1];
 	}
 }
 
-static void volmeter_process_peak(obs_volmeter_t *volmeter, const struct audio_data *data, int nr_channels)
+static void audio_meter_process_levels(struct audio_meter *meter, struct meter_levels *levels,
+				       const struct audio_data *data, bool true_peak)
 {
-	int nr_samples = data->frames;
+	int nr_channels = get_nr_channels_from_audio_data(data);
+	size_t nr_samples = data->frames;
 	int channel_nr = 0;
+
 	for (int plane_nr = 0; channel_nr < nr_channels; plane_nr++) {
 		float *samples = (float *)data->data[plane_nr];
 		if (!samples) {
@@ -425,92 +477,73 @@ static void volmeter_process_peak(obs_volmeter_t *volmeter, const struct audio_d
 			printf("Audio plane %i is not aligned %p skipping "
 			       "peak volume measurement.\n",
 			       plane_nr, samples);
-			volmeter->peak[channel_nr] = 1.0;
+
+			float sum = 0.0f;
+			for (size_t i = 0; i < nr_samples; i++)
+				sum += samples[i] * samples[i];
+
+			levels->magnitude[channel_nr] = nr_samples ? sqrtf(sum / nr_samples) : 0.0f;
+			levels->sample_peak[channel_nr] = 1.0;
+			levels->true_peak[channel_nr] = 1.0;
 			channel_nr++;
 			continue;
 		}
 
-		/* volmeter->prev_samples may not be aligned to 16 bytes;
+		/* meter->prev_samples may not be aligned to 16 bytes;
 		 * use unaligned load. */
-		__m128 previous_samples = _mm_loadu_ps(volmeter->prev_samples[channel_nr]);
-
-		float peak;
-		switch (volmeter->peak_meter_type) {
-		case TRUE_PEAK_METER:
-			peak = get_true_peak(previous_samples, samples, nr_samples);
-			break;
-
-		case SAMPLE_PEAK_METER:
-		default:
-			peak = get_sample_peak(previous_samples, samples, nr_samples);
-			break;
-		}
+		__m128 previous_samples = _mm_loadu_ps(meter->prev_samples[channel_nr]);
+
+		float sample_peak = get_sample_peak_and_magnitude(previous_samples, samples, nr_samples,
+								  &levels->magnitude[channel_nr]);
 
-		volmeter_process_peak_last_samples(volmeter, channel_nr, samples, nr_samples);
+		/* Only pay for oversampling while a meter shows the true peak */
+		levels->sample_peak[channel_nr] = sample_peak;
+		levels->true_peak[channel_nr] = true_peak ? get_true_peak(previous_samples, samples, nr_samples)
+							  : sample_peak;
 
-		volmeter->peak[channel_nr] = peak;
+		audio_meter_process_last_samples(meter, channel_nr, samples, nr_samples);
 
 		channel_nr++;
 	}
 
-	/* Clear the peak of the channels that have not been handled. */
+	/* Clear the levels of the channels that have not been handled. */
 	for (; channel_nr < MAX_AUDIO_CHANNELS; channel_nr++) {
-		volmeter->peak[channel_nr] = 0.0;
+		levels->magnitude[channel_nr] = 0.0;
+		levels->sample_peak[channel_nr] = 0.0;
+		levels->true_peak[channel_nr] = 0.0;
 	}
 }
 
-static void volmeter_process_magnitude(obs_volmeter_t *volmeter, const struct audio_data *data, int nr_channels)
+static void volmeter_signal_levels(struct obs_volmeter *volmeter, const struct meter_levels *levels)
 {
-	size_t nr_samples = data->frames;
-
-	int channel_nr = 0;
-	for (int plane_nr = 0; channel_nr < nr_channels; plane_nr++) {
-		float *samples = (float *)data->data[plane_nr];
-		if (!samples) {
-			continue;
-		}
-
-		float sum = 0.0;
-		for (size_t i = 0; i < nr_samples; i++) {
-			float sample = samples[i];
-			sum += sample * sample;
-		}
-		volmeter->magnitude[channel_nr] = sqrtf(sum / nr_samples);
-
-		channel_nr++;
-	}
-}
-
-static void volmeter_process_audio_data(obs_volmeter_t *volmeter, const struct audio_data *data)
-{
-	int nr_channels = get_nr_channels_from_audio_data(data);
-
-	volmeter_process_peak(volmeter, data, nr_channels);
-	volmeter_process_magnitude(volmeter, data, nr_channels);
-}
-
-static void volmeter_source_data_received(void *vptr, obs_source_t *source, const struct audio_data *data, bool muted)
-{
-	struct obs_volmeter *volmeter = (struct obs_volmeter *)vptr;
-	float mul;
 	float magnitude[MAX_AUDIO_CHANNELS];
 	float peak[MAX_AUDIO_CHANNELS];
 	float input_peak[MAX_AUDIO_CHANNELS];
+	bool has_callbacks;
+
+	pthread_mutex_lock(&volmeter->callback_mutex);
+	has_callbacks = volmeter->callbacks.num > 0;
+	pthread_mutex_unlock(&volmeter->callback_mutex);
+
+	/* Meters that are polled cost nothing per packet */
+	if (!has_callbacks)
+		return;
 
 	pthread_mutex_lock(&volmeter->mutex);
 
-	volmeter_process_audio_data(volmeter, data);
+	const float *levels_peak = volmeter->peak_meter_type == TRUE_PEAK_METER ? levels->true_peak
+										 : levels->sample_peak;
 
 	// Adjust magnitude/peak based on the volume level set by the user.
 	// And convert to dB.
-	mul = muted && !obs_source_muted(source) ? 0.0f : db_to_mul(volmeter->cur_db);
+	float mul = levels->silenced ? 0.0f : db_to_mul(volmeter->cur_db);
 	for (int channel_nr = 0; channel_nr < MAX_AUDIO_CHANNELS; channel_nr++) {
-		magnitude[channel_nr] = mul_to_db(volmeter->magnitude[channel_nr] * mul);
-		peak[channel_nr] = mul_to_db(volmeter->peak[channel_nr] * mul);
+		magnitude[channel_nr] = mul_to_db(levels->magnitude[channel_nr] * mul);
+		peak[channel_nr] = mul_to_db(levels_peak[channel_nr] * mul);
 
 		/* The input-peak is NOT adjusted with volume, so that the user
 		 * can check the input-gain. */
-		input_peak[channel_nr] = mul_to_db(volmeter->peak[channel_nr]);
+		input_peak[channel_nr] = mul_to_db(levels_peak[channel_nr]);
 	}
 
 	pthread_mutex_unlock(&volmeter->mutex);
@@ -518,6 +551,89 @@ static void volmeter_source_data_received(void *vptr, obs_source_t *source, cons
 	signal_levels_updated(volmeter, magnitude, peak, input_peak);
 }
 
+static void audio_meter_data_received(void *vptr, obs_source_t *source, const struct audio_data *data, bool muted)
+{
+	struct audio_meter *meter = vptr;
+	long index = meter->count;
+	struct meter_slot *slot = &meter->history[(unsigned long)index % METER_HISTORY];
+	bool true_peak = os_atomic_load_long(&meter->true_peak_refs) > 0;
+
+	/* Audio capture callbacks of a source never run concurrently, so this
+	 * is the only writer */
+	os_atomic_inc_long(&slot->seq);
+	slot->levels.index = index;
+	slot->levels.silenced = muted && !obs_source_muted(source);
+	audio_meter_process_levels(meter, &slot->levels, data, true_peak);
+	os_atomic_inc_long(&slot->seq);
+
+	os_atomic_store_long(&meter->count, index + 1);
+
+	pthread_mutex_lock(&meter->mutex);
+	for (size_t i = 0; i < meter->volmeters.num; i++)
+		volmeter_signal_levels(meter->volmeters.array[i], &slot->levels);
+	pthread_mutex_unlock(&meter->mutex);
+}
+
+static bool audio_meter_read(struct audio_meter *meter, long index, struct meter_levels *levels)
+{
+	struct meter_slot *slot = &meter->history[(unsigned long)index % METER_HISTORY];
+	long seq = os_atomic_load_long(&slot->seq);
+
+	if (seq & 1)
+		return false;
+
+	memcpy(levels, &slot->levels, sizeof(*levels));
+
+	/* Used as a full barrier, so the copy can't move past the check */
+	if (!os_atomic_compare_swap_long(&slot->seq, seq, seq))
+		return false;
+
+	/* The slot may have been reused for a later packet already */
+	return levels->index == index;
+}
+
+static struct audio_meter *audio_meter_acquire(obs_source_t *source)
+{
+	struct audio_meter *meter;
+
+	pthread_mutex_lock(&meter_mutex);
+
+	meter = source->audio_meter;
+	if (!meter) {
+		meter = bzalloc(sizeof(struct audio_meter));
+		pthread_mutex_init(&meter->mutex, NULL);
+		meter->source = source;
+		source->audio_meter = meter;
+		obs_source_add_audio_capture_callback(source, audio_meter_data_received, meter);
+	}
+	meter->refs++;
+
+	pthread_mutex_unlock(&meter_mutex);
+
+	return meter;
+}
+
+static void audio_meter_release(struct audio_meter *meter)
+{
+	bool destroy;
+
+	pthread_mutex_lock(&meter_mutex);
+
+	destroy = --meter->refs == 0;
+	if (destroy) {
+		meter->source->audio_meter = NULL;
+		obs_source_remove_audio_capture_callback(meter->source, audio_meter_data_received, meter);
+	}
+
+	pthread_mutex_unlock(&meter_mutex);
+
+	if (destroy) {
+		da_free(meter->volmeters);
+		pthread_mutex_destroy(&meter->mutex);
+		bfree(meter);
+	}
+}
+
 obs_fader_t *obs_fader_create(enum obs_fader_type type)
 {
 	struct obs_fader *fader = bzalloc(sizeof(struct obs_fader));
@@ -764,6 +880,7 @@ void obs_volmeter_destroy(obs_volmeter_t *volmeter)
 
 bool obs_volmeter_attach_source(obs_volmeter_t *volmeter, obs_source_t *source)
 {
+	struct audio_meter *meter;
 	signal_handler_t *sh;
 	float vol;
 
@@ -775,21 +892,30 @@ bool obs_volmeter_attach_source(obs_volmeter_t *volmeter, obs_source_t *source)
 	sh = obs_source_get_signal_handler(source);
 	signal_handler_connect(sh, "volume", volmeter_source_volume_changed, volmeter);
 	signal_handler_connect(sh, "destroy", volmeter_source_destroyed, volmeter);
-	obs_source_add_audio_capture_callback(source, volmeter_source_data_received, volmeter);
+	meter = audio_meter_acquire(source);
 	vol = obs_source_get_volume(source);
 
 	pthread_mutex_lock(&volmeter->mutex);
 
 	volmeter->source = source;
+	volmeter->meter = meter;
 	volmeter->cur_db = mul_to_db(vol);
+	volmeter->read_count = os_atomic_load_long(&meter->count);
+	if (volmeter->peak_meter_type == TRUE_PEAK_METER)
+		os_atomic_inc_long(&meter->true_peak_refs);
 
 	pthread_mutex_unlock(&volmeter->mutex);
 
+	pthread_mutex_lock(&meter->mutex);
+	da_push_back(meter->volmeters, &volmeter);
+	pthread_mutex_unlock(&meter->mutex);
+
 	return true;
 }
 
 void obs_volmeter_detach_source(obs_volmeter_t *volmeter)
 {
+	struct audio_meter *meter;
 	signal_handler_t *sh;
 	obs_source_t *source;
 
@@ -798,7 +924,11 @@ void obs_volmeter_detach_source(obs_volmeter_t *volmeter)
 
 	pthread_mutex_lock(&volmeter->mutex);
 	source = volmeter->source;
+	meter = volmeter->meter;
 	volmeter->source = NULL;
+	volmeter->meter = NULL;
+	if (meter && volmeter->peak_meter_type == TRUE_PEAK_METER)
+		os_atomic_dec_long(&meter->true_peak_refs);
 	pthread_mutex_unlock(&volmeter->mutex);
 
 	if (!source)
@@ -807,13 +937,29 @@ void obs_volmeter_detach_source(obs_volmeter_t *volmeter)
 	sh = obs_source_get_signal_handler(source);
 	signal_handler_disconnect(sh, "volume", volmeter_source_volume_changed, volmeter);
 	signal_handler_disconnect(sh, "destroy", volmeter_source_destroyed, volmeter);
-	obs_source_remove_audio_capture_callback(source, volmeter_source_data_received, volmeter);
+
+	pthread_mutex_lock(&meter->mutex);
+	da_erase_item(meter->volmeters, &volmeter);
+	pthread_mutex_unlock(&meter->mutex);
+
+	audio_meter_release(meter);
 }
 
 void obs_volmeter_set_peak_meter_type(obs_volmeter_t *volmeter, enum obs_peak_meter_type peak_meter_type)
 {
 	pthread_mutex_lock(&volmeter->mutex);
+
+	bool was_true_peak = volmeter->peak_meter_type == TRUE_PEAK_METER;
+	bool true_peak = peak_meter_type == TRUE_PEAK_METER;
+	if (volmeter->meter && true_peak != was_true_peak) {
+		if (true_peak)
+			os_atomic_inc_long(&volmeter->meter->true_peak_refs);
+		else
+			os_atomic_dec_long(&volmeter->meter->true_peak_refs);
+	}
+
 	volmeter->peak_meter_type = peak_meter_type;
+
 	pthread_mutex_unlock(&volmeter->mutex);
 }
 
@@ -862,6 +1008,73 @@ void obs_volmeter_remove_callback(obs_volmeter_t *volmeter, obs_volmeter_updated
 	pthread_mutex_unlock(&volmeter->callback_mutex);
 }
 
+bool obs_volmeter_get_levels(obs_volmeter_t *volmeter, float magnitude[MAX_AUDIO_CHANNELS],
+			     float peak[MAX_AUDIO_CHANNELS], float input_peak[MAX_AUDIO_CHANNELS])
+{
+	float sum[MAX_AUDIO_CHANNELS] = {0};
+	float max_peak[MAX_AUDIO_CHANNELS] = {0};
+	float max_input_peak[MAX_AUDIO_CHANNELS] = {0};
+	struct audio_meter *meter;
+	long count;
+	long start;
+	int read = 0;
+
+	if (!obs_ptr_valid(volmeter, "obs_volmeter_get_levels"))
+		return false;
+
+	pthread_mutex_lock(&volmeter->mutex);
+
+	meter = volmeter->meter;
+	if (!meter) {
+		pthread_mutex_unlock(&volmeter->mutex);
+		return false;
+	}
+
+	count = os_atomic_load_long(&meter->count);
+	start = volmeter->read_count;
+	if (count - start > METER_HISTORY)
+		start = count - METER_HISTORY;
+	volmeter->read_count = count;
+
+	float mul = db_to_mul(volmeter->cur_db);
+	bool true_peak = volmeter->peak_meter_type == TRUE_PEAK_METER;
+
+	/* Combine every packet since the last poll: the magnitudes are
+	 * averaged and the highest peak is kept. */
+	for (long i = start; i < count; i++) {
+		struct meter_levels levels;
+
+		if (!audio_meter_read(meter, i, &levels))
+			continue;
+
+		const float *levels_peak = true_peak ? levels.true_peak : levels.sample_peak;
+		float packet_mul = levels.silenced ? 0.0f : mul;
+
+		for (int channel_nr = 0; channel_nr < MAX_AUDIO_CHANNELS; channel_nr++) {
+			float packet_magnitude = levels.magnitude[channel_nr] * packet_mul;
+
+			sum[channel_nr] += packet_magnitude * packet_magnitude;
+			max_peak[channel_nr] = fmaxf(max_peak[channel_nr], levels_peak[channel_nr] * packet_mul);
+			max_input_peak[channel_nr] = fmaxf(max_input_peak[channel_nr], levels_peak[channel_nr]);
+		}
+
+		read++;
+	}
+
+	pthread_mutex_unlock(&volmeter->mutex);
+
+	if (!read)
+		return false;
+
+	for (int channel_nr = 0; channel_nr < MAX_AUDIO_CHANNELS; channel_nr++) {
+		magnitude[channel_nr] = mul_to_db(sqrtf(sum[channel_nr] / (float)read));
+		peak[channel_nr] = mul_to_db(max_peak[channel_nr]);
+		input_peak[channel_nr] = mul_to_db(max_input_peak[channel_nr]);
+	}
+
+	return true;
+}
+
 float obs_mul_to_db(float mul)
 {
 	return mul_to_db(mul);
@@ -235,9 +235,27 @@ typedef void (*obs_volmeter_updated_t)(void *param, const float magnitude[MAX_AU
 				       const float peak[MAX_AUDIO_CHANNELS],
 				       const float input_peak[MAX_AUDIO_CHANNELS]);
 
+/**
+ * Callbacks are called from the audio thread for every audio packet of the
+ * source.  User interfaces should prefer polling with obs_volmeter_get_levels.
+ */
 EXPORT void obs_volmeter_add_callback(obs_volmeter_t *volmeter, obs_volmeter_updated_t callback, void *param);
 EXPORT void obs_volmeter_remove_callback(obs_volmeter_t *volmeter, obs_volmeter_updated_t callback, void *param);
 
+/**
+ * @brief Get the levels of the audio received since the last call
+ * @param volmeter pointer to the volume meter object
+ * @return false if no audio has been received since the last call
+ *
+ * Levels are computed once per source, however many volume meters are
+ * attached to it, and kept for the last few audio packets.  Magnitudes are
+ * averaged over the packets since the last call and the highest peak is
+ * returned, so meters can be polled at their refresh rate without missing
+ * peaks.  Does not block the audio thread.
+ */
+EXPORT bool obs_volmeter_get_levels(obs_volmeter_t *volmeter, float magnitude[MAX_AUDIO_CHANNELS],
+				    float peak[MAX_AUDIO_CHANNELS], float input_peak[MAX_AUDIO_CHANNELS]);
+
 EXPORT float obs_mul_to_db(float mul);
 EXPORT float obs_db_to_mul(float db);
 
@@ -421,6 +421,26 @@ bool obs_canvas_get_video_info(const obs_canvas_t *canvas, struct obs_video_info
 	return true;
 }
 
+void obs_canvas_get_render_stats(obs_canvas_t *canvas, struct obs_canvas_render_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+
+	pthread_mutex_lock(&obs->video.mixes_mutex);
+
+	struct obs_core_video_mix *mix = canvas->mix;
+	if (mix) {
+		stats->frames = mix->render_frames;
+		stats->max_render_ns = mix->render_ns_max;
+		stats->shared_renders = mix->shared_renders;
+		if (mix->render_frames) {
+			stats->avg_render_ns = mix->render_ns_total / mix->render_frames;
+			stats->avg_download_ns = mix->download_ns_total / mix->render_frames;
+		}
+	}
+
+	pthread_mutex_unlock(&obs->video.mixes_mutex);
+}
+
 signal_handler_t *obs_canvas_get_signal_handler(obs_canvas_t *canvas)
 {
 	return canvas->context.signals;
@@ -234,23 +234,43 @@ static inline void render_display_end()
 	gs_end_scene();
 }
 
-void render_display(struct obs_display *display)
+/* Displays that have not been rendered for this long are rendered even when
+ * the output frame is over budget, so they never freeze completely */
+#define MAX_DISPLAY_SKIP_NS 100000000ULL
+
+/* Returns false if the display was skipped because the output frame took up
+ * most of the frame budget already */
+bool render_display(struct obs_display *display, uint64_t video_time, bool over_budget)
 {
 	uint32_t cx, cy;
 	bool update_color_space;
+	uint64_t elapsed;
 
 	if (!display || !display->enabled)
-		return;
+		return true;
 
 	/* -------------------------------------------- */
 
 	pthread_mutex_lock(&display->draw_info_mutex);
 
+	elapsed = video_time - display->last_render_ts;
+
+	if (display->render_interval_ns &&
+	    elapsed + obs->video.video_half_frame_interval_ns < display->render_interval_ns) {
+		pthread_mutex_unlock(&display->draw_info_mutex);
+		return true;
+	}
+	if (over_budget && elapsed < MAX_DISPLAY_SKIP_NS) {
+		pthread_mutex_unlock(&display->draw_info_mutex);
+		return false;
+	}
+
 	cx = display->next_cx;
 	cy = display->next_cy;
 	update_color_space = display->update_color_space;
 
 	display->update_color_space = false;
+	display->last_render_ts = video_time;
 
 	pthread_mutex_unlock(&display->draw_info_mutex);
 
@@ -276,6 +296,8 @@ void render_display(struct obs_display *display)
 
 		gs_present();
 	}
+
+	return true;
 }
 
 void obs_display_set_enabled(obs_display_t *display, bool enable)
@@ -289,6 +311,16 @@ bool obs_display_enabled(obs_display_t *display)
 	return display ? display->enabled : false;
 }
 
+void obs_display_set_max_fps(obs_display_t *display, double fps)
+{
+	if (!display)
+		return;
+
+	pthread_mutex_lock(&display->draw_info_mutex);
+	display->render_interval_ns = fps > 0.0 ? (uint64_t)(1000000000.0 / fps) : 0;
+	pthread_mutex_unlock(&display->draw_info_mutex);
+}
+
 void obs_display_set_background_color(obs_display_t *display, uint32_t color)
 {
 	if (display)
@@ -464,6 +464,8 @@ static inline void create_binding(obs_hotkey_t *hotkey, obs_key_combination_t co
 	binding->key = combo;
 	binding->hotkey_id = hotkey->id;
 	binding->hotkey = hotkey;
+
+	obs->hotkeys.key_index_dirty = true;
 }
 
 static inline void load_binding(obs_hotkey_t *hotkey, obs_data_t *data)
@@ -811,6 +813,7 @@ static inline bool remove_bindings(obs_hotkey_id id)
 			release_pressed_binding(binding);
 
 		da_erase(obs->hotkeys.bindings, idx);
+		obs->hotkeys.key_index_dirty = true;
 		removed = true;
 	}
 
@@ -958,6 +961,16 @@ void obs_hotkeys_free(void)
 	}
 
 	da_free(obs->hotkeys.bindings);
+	da_free(obs->hotkeys.key_index);
+
+	if (obs->hotkeys.events_handled) {
+		blog(LOG_INFO,
+		     "Hotkeys: %" PRIu64 " key events (%.2f ms average latency, %.2f ms max), %" PRIu64
+		     " bindings evaluated",
+		     obs->hotkeys.events_handled,
+		     (double)obs->hotkeys.event_latency_ns_total / (double)obs->hotkeys.events_handled / 1000000.0,
+		     (double)obs->hotkeys.event_latency_ns_max / 1000000.0, obs->hotkeys.bindings_evaluated);
+	}
 
 	for (size_t i = 0; i < OBS_KEY_LAST_VALUE; i++) {
 		if (obs->hotkeys.translations[i]) {
@@ -1001,12 +1014,16 @@ static inline bool modifiers_match(obs_hotkey_binding_t *binding, uint32_t modif
 
 static inline bool is_pressed(obs_key_t key)
 {
+	if (obs->hotkeys.event_driven)
+		return obs->hotkeys.key_state[key];
+
 	return obs_hotkeys_platform_is_pressed(obs->hotkeys.platform_context, key);
 }
 
 static inline void press_released_binding(obs_hotkey_binding_t *binding)
 {
 	binding->pressed = true;
+	obs->hotkeys.pressed_bindings++;
 
 	obs_hotkey_t *hotkey = binding->hotkey;
 	if (hotkey->pressed++)
@@ -1021,6 +1038,7 @@ static inline void press_released_binding(obs_hotkey_binding_t *binding)
 static inline void release_pressed_binding(obs_hotkey_binding_t *binding)
 {
 	binding->pressed = false;
+	obs->hotkeys.pressed_bindings--;
 
 	obs_hotkey_t *hotkey = binding->hotkey;
 	if (--hotkey->pressed)
@@ -1104,6 +1122,11 @@ void obs_hotkey_inject_event(obs_key_combination_t hotkey, bool pressed)
 		obs->hotkeys.strict_modifiers,
 	};
 	enum_bindings(inject_hotkey, &event);
+
+	/* Have the hotkey thread check for the release of the binding */
+	if (obs->hotkeys.event_driven)
+		os_event_signal(obs->hotkeys.event_ready);
+
 	unlock();
 }
 
@@ -1129,10 +1152,11 @@ static inline bool query_hotkey(void *data, size_t idx, obs_hotkey_binding_t *bi
 	struct obs_query_hotkeys_helper *param = (struct obs_query_hotkeys_helper *)data;
 	handle_binding(binding, param->modifiers, param->no_press, param->strict_modifiers, NULL);
 
+	obs->hotkeys.bindings_evaluated++;
 	return true;
 }
 
-static inline void query_hotkeys()
+static inline uint32_t get_modifiers(void)
 {
 	uint32_t modifiers = 0;
 	if (is_pressed(OBS_KEY_SHIFT))
@@ -1143,16 +1167,141 @@ static inline void query_hotkeys()
 		modifiers |= INTERACT_ALT_KEY;
 	if (is_pressed(OBS_KEY_META))
 		modifiers |= INTERACT_COMMAND_KEY;
+	return modifiers;
+}
 
+static inline void query_hotkeys()
+{
 	struct obs_query_hotkeys_helper param = {
-		modifiers,
+		get_modifiers(),
 		obs->hotkeys.thread_disable_press,
 		obs->hotkeys.strict_modifiers,
 	};
 	enum_bindings(query_hotkey, &param);
 }
 
+static int cmp_key_index(const void *a, const void *b)
+{
+	const struct obs_hotkey_key_index *index_a = a;
+	const struct obs_hotkey_key_index *index_b = b;
+
+	if (index_a->key != index_b->key)
+		return index_a->key < index_b->key ? -1 : 1;
+	if (index_a->idx != index_b->idx)
+		return index_a->idx < index_b->idx ? -1 : 1;
+	return 0;
+}
+
+static void update_key_index(void)
+{
+	const size_t num = obs->hotkeys.bindings.num;
+
+	if (!obs->hotkeys.key_index_dirty)
+		return;
+
+	da_resize(obs->hotkeys.key_index, num);
+	for (size_t i = 0; i < num; i++) {
+		obs->hotkeys.key_index.array[i].key = obs->hotkeys.bindings.array[i].key.key;
+		obs->hotkeys.key_index.array[i].idx = i;
+	}
+
+	if (num)
+		qsort(obs->hotkeys.key_index.array, num, sizeof(struct obs_hotkey_key_index), cmp_key_index);
+
+	obs->hotkeys.key_index_dirty = false;
+}
+
+/* Only evaluates the bindings of a single key */
+static void query_key_hotkeys(obs_key_t key)
+{
+	struct obs_query_hotkeys_helper param = {
+		get_modifiers(),
+		obs->hotkeys.thread_disable_press,
+		obs->hotkeys.strict_modifiers,
+	};
+
+	update_key_index();
+
+	const struct obs_hotkey_key_index *index = obs->hotkeys.key_index.array;
+	const size_t num = obs->hotkeys.key_index.num;
+	size_t first = 0;
+	size_t last = num;
+
+	while (first < last) {
+		size_t mid = first + (last - first) / 2;
+		if (index[mid].key < key)
+			first = mid + 1;
+		else
+			last = mid;
+	}
+
+	for (size_t i = first; i < num && index[i].key == key; i++) {
+		size_t idx = index[i].idx;
+		query_hotkey(&param, idx, &obs->hotkeys.bindings.array[idx]);
+
+		/* A hotkey callback changed the bindings */
+		if (obs->hotkeys.key_index_dirty)
+			break;
+	}
+}
+
+static inline bool is_modifier(obs_key_t key)
+{
+	return key == OBS_KEY_SHIFT || key == OBS_KEY_CONTROL || key == OBS_KEY_ALT || key == OBS_KEY_META;
+}
+
+static void handle_key_events(void)
+{
+	struct obs_hotkey_key_event event;
+
+	for (;;) {
+		bool have_event = false;
+
+		pthread_mutex_lock(&obs->hotkeys.event_mutex);
+		if (obs->hotkeys.key_events.size) {
+			deque_pop_front(&obs->hotkeys.key_events, &event, sizeof(event));
+			have_event = true;
+		}
+		pthread_mutex_unlock(&obs->hotkeys.event_mutex);
+
+		if (!have_event)
+			break;
+
+		if (obs->hotkeys.key_state[event.key] == event.pressed)
+			continue;
+
+		obs->hotkeys.key_state[event.key] = event.pressed;
+
+		/* Modifiers take part in every binding */
+		if (is_modifier(event.key))
+			query_hotkeys();
+		else
+			query_key_hotkeys(event.key);
+
+		uint64_t latency = os_gettime_ns() - event.ts;
+		obs->hotkeys.events_handled++;
+		obs->hotkeys.event_latency_ns_total += latency;
+		if (latency > obs->hotkeys.event_latency_ns_max)
+			obs->hotkeys.event_latency_ns_max = latency;
+	}
+}
+
+void obs_hotkeys_key_event(obs_key_t key, bool pressed)
+{
+	struct obs_hotkey_key_event event = {key, pressed, os_gettime_ns()};
+
+	if (!obs || key <= OBS_KEY_NONE || key >= OBS_KEY_LAST_VALUE)
+		return;
+
+	pthread_mutex_lock(&obs->hotkeys.event_mutex);
+	deque_push_back(&obs->hotkeys.key_events, &event, sizeof(event));
+	pthread_mutex_unlock(&obs->hotkeys.event_mutex);
+
+	os_event_signal(obs->hotkeys.event_ready);
+}
+
 #define NBSP "\xC2\xA0"
+#define POLL_INTERVAL_MS 25
 
 void *obs_hotkey_thread(void *arg)
 {
@@ -1160,16 +1309,45 @@ void *obs_hotkey_thread(void *arg)
 
 	os_set_thread_name("libobs: hotkey thread");
 
-	const char *hotkey_thread_name =
-		profile_store_name(obs_get_profiler_name_store(), "obs_hotkey_thread(%g" NBSP "ms)", 25.);
-	profile_register_root(hotkey_thread_name, (uint64_t)25000000);
+	const char *hotkey_thread_name = profile_store_name(obs_get_profiler_name_store(),
+							   "obs_hotkey_thread(%g" NBSP "ms)", (double)POLL_INTERVAL_MS);
+	profile_register_root(hotkey_thread_name, (uint64_t)POLL_INTERVAL_MS * 1000000);
+
+	uint64_t last_poll = 0;
+	bool held = false;
+
+	for (;;) {
+		bool poll = true;
+
+		if (obs->hotkeys.event_driven) {
+			/* Bindings are still polled while any is held, as the
+			 * frontend may inject a press after the platform has
+			 * reported the release of its key already. */
+			if (held)
+				os_event_timedwait(obs->hotkeys.event_ready, POLL_INTERVAL_MS);
+			else
+				os_event_wait(obs->hotkeys.event_ready);
+
+			if (os_event_try(obs->hotkeys.stop_event) != EAGAIN)
+				break;
+
+			poll = held && os_gettime_ns() - last_poll >= (uint64_t)POLL_INTERVAL_MS * 1000000;
+
+		} else if (os_event_timedwait(obs->hotkeys.stop_event, POLL_INTERVAL_MS) != ETIMEDOUT) {
+			break;
+		}
 
-	while (os_event_timedwait(obs->hotkeys.stop_event, 25) == ETIMEDOUT) {
 		if (!lock())
 			continue;
 
 		profile_start(hotkey_thread_name);
-		query_hotkeys();
+		if (obs->hotkeys.event_driven)
+			handle_key_events();
+		if (poll) {
+			query_hotkeys();
+			last_poll = os_gettime_ns();
+		}
+		held = obs->hotkeys.pressed_bindings > 0;
 		profile_end(hotkey_thread_name);
 
 		unlock();
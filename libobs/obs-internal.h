@@ -47,6 +47,7 @@
 #define HASH_ADD_UUID(head, uuid_field, add) HASH_ADD(hh_uuid, head, uuid_field[0], UUID_STR_LENGTH, add)
 
 #define NUM_TEXTURES 2
+#define MAX_READBACK_DEPTH 4
 #define NUM_CHANNELS 3
 #define MICROSECOND_DEN 1000000
 #define NUM_ENCODE_TEXTURES 10
@@ -247,6 +248,11 @@ bool obs_hotkeys_platform_init(struct obs_core_hotkeys *hotkeys);
 void obs_hotkeys_platform_free(struct obs_core_hotkeys *hotkeys);
 bool obs_hotkeys_platform_is_pressed(obs_hotkeys_platform_t *context, obs_key_t key);
 
+/* Queues a key state change for the hotkey thread.  Platforms that set
+ * obs_core_hotkeys::event_driven report keys through this (from any thread)
+ * and are no longer polled with obs_hotkeys_platform_is_pressed. */
+void obs_hotkeys_key_event(obs_key_t key, bool pressed);
+
 const char *obs_get_hotkey_translation(obs_key_t key, const char *def);
 
 struct obs_context_data;
@@ -263,6 +269,18 @@ struct obs_hotkey_binding {
 	obs_hotkey_t *hotkey;
 };
 
+struct obs_hotkey_key_event {
+	obs_key_t key;
+	bool pressed;
+	uint64_t ts;
+};
+
+/* Bindings sorted by key, so a key event only evaluates its own bindings */
+struct obs_hotkey_key_index {
+	obs_key_t key;
+	size_t idx;
+};
+
 struct obs_hotkey_name_map_item;
 void obs_hotkey_name_map_free(void);
 
@@ -299,6 +317,10 @@ struct obs_display {
 	DARRAY(struct draw_callback) draw_callbacks;
 	bool use_clear_workaround;
 
+	/* 0 renders the display on every output frame */
+	uint64_t render_interval_ns;
+	uint64_t last_render_ts;
+
 	struct obs_display *next;
 	struct obs_display **prev_next;
 };
@@ -332,25 +354,34 @@ struct obs_task_info {
 struct obs_core_video_mix {
 	struct obs_view *view;
 
-	gs_stagesurf_t *active_copy_surfaces[NUM_TEXTURES][NUM_CHANNELS];
-	gs_stagesurf_t *copy_surfaces[NUM_TEXTURES][NUM_CHANNELS];
+	gs_stagesurf_t *active_copy_surfaces[MAX_READBACK_DEPTH][NUM_CHANNELS];
+	gs_stagesurf_t *copy_surfaces[MAX_READBACK_DEPTH][NUM_CHANNELS];
 	gs_texture_t *convert_textures[NUM_CHANNELS];
 	gs_texture_t *convert_textures_encode[NUM_CHANNELS];
 #ifdef _WIN32
-	gs_stagesurf_t *copy_surfaces_encode[NUM_TEXTURES];
+	gs_stagesurf_t *copy_surfaces_encode[MAX_READBACK_DEPTH];
 #endif
 	gs_texture_t *render_texture;
 	gs_texture_t *output_texture;
 	enum gs_color_space render_space;
 	bool texture_rendered;
-	bool textures_copied[NUM_TEXTURES];
+	bool textures_copied[MAX_READBACK_DEPTH];
 	bool texture_converted;
 	bool using_nv12_tex;
 	bool using_p010_tex;
 	struct deque vframe_info_buffer;
 	struct deque vframe_info_buffer_gpu;
-	gs_stagesurf_t *mapped_surfaces[NUM_CHANNELS];
+	gs_stagesurf_t *mapped_surfaces[MAX_READBACK_DEPTH][NUM_CHANNELS];
 	int cur_texture;
+
+	/* Number of staging surface sets.  A frame is mapped readback_depth - 1
+	 * frames after it was staged.  Beyond the default depth, mapped frames
+	 * are copied into video-io on the readback thread, and copying is set
+	 * until that is done. */
+	int readback_depth;
+	uint64_t stage_ts[MAX_READBACK_DEPTH];
+	volatile bool copying[MAX_READBACK_DEPTH];
+	os_event_t *copy_done;
 	volatile long raw_active;
 	volatile long gpu_encoder_active;
 	bool gpu_was_active;
@@ -381,11 +412,54 @@ struct obs_core_video_mix {
 	long encoder_refs;
 
 	bool mix_audio;
+
+	/* frame mapped this interval, output once every mix has been
+	 * rendered */
+	struct video_data pending_frame;
+	bool pending_frame_ready;
+
+	/* render stats, guarded by mixes_mutex */
+	uint64_t render_frames;
+	uint64_t render_ns_total;
+	uint64_t render_ns_max;
+	uint64_t download_ns_total;
+	uint64_t shared_renders;
 };
 
 extern struct obs_core_video_mix *obs_create_video_mix(struct obs_video_info *ovi);
 extern void obs_free_video_mix(struct obs_core_video_mix *video);
 
+
+struct obs_readback_job {
+	struct obs_core_video_mix *mix;
+	int texture;
+	int count;
+	struct video_data frame;
+};
+
+/* Copies mapped frames of mixes with a deep readback pipeline into video-io,
+ * off the graphics thread */
+struct obs_readback_thread {
+	pthread_t thread;
+	bool initialized;
+	bool stop;
+	os_sem_t *sem;
+	pthread_mutex_t mutex;
+	struct deque jobs;
+
+	/* protected by mutex */
+	uint64_t frames;
+	uint64_t latency_ns_total;
+	uint64_t latency_ns_max;
+	uint64_t map_ns_total;
+	uint64_t copy_ns_total;
+	uint64_t wait_ns_total;
+};
+
+extern bool obs_readback_thread_init(struct obs_readback_thread *readback);
+extern void obs_readback_thread_stop(struct obs_readback_thread *readback);
+extern void obs_readback_wait(struct obs_core_video_mix *video, int texture);
+
 struct obs_core_video {
 	graphics_t *graphics;
 	gs_effect_t *default_effect;
@@ -405,12 +479,20 @@ struct obs_core_video {
 	uint64_t video_frame_interval_ns;
 	uint64_t video_half_frame_interval_ns;
 	uint64_t video_avg_frame_time_ns;
+	uint64_t video_avg_output_time_ns;
+	uint64_t video_avg_display_time_ns;
+	uint32_t video_avg_draw_calls;
 	double video_fps;
 	pthread_t video_thread;
 	uint32_t total_frames;
 	uint32_t lagged_frames;
+	uint32_t skipped_display_frames;
 	bool thread_initialized;
 
+	/* depth of mixes created from now on, 0 for the default */
+	uint32_t readback_depth;
+	struct obs_readback_thread readback;
+
 	gs_texture_t *transparent_texture;
 
 	gs_effect_t *deinterlace_discard_effect;
@@ -433,6 +515,11 @@ struct obs_core_video {
 
 	pthread_mutex_t mixes_mutex;
 	DARRAY(struct obs_core_video_mix *) mixes;
+
+	/* the mix being rendered on the graphics thread, and a counter of
+	 * the frames rendered for the mixes, for sharing source renders */
+	struct obs_core_video_mix *rendering_mix;
+	uint64_t render_frame;
 };
 
 extern void add_ready_encoder_group(obs_encoder_t *encoder);
@@ -463,6 +550,42 @@ struct obs_core_audio {
 	struct obs_source *monitoring_duplicating_source;
 };
 
+struct threaded_tick {
+	struct obs_source *source;
+	/* profiler start of the tick on the graphics thread, and time measured
+	 * on the graphics thread and on the worker */
+	uint64_t profiler_start;
+	uint64_t tick_ns;
+};
+
+/* Runs the video_tick callbacks of sources with OBS_SOURCE_THREADSAFE_TICK on
+ * worker threads.  The graphics thread hands out sources through next_tick
+ * and works alongside the workers. */
+struct obs_tick_pool {
+	pthread_t *threads;
+	size_t num_threads;
+	os_sem_t *start_sem;
+	os_sem_t *done_sem;
+	volatile bool stop;
+
+	DARRAY(struct threaded_tick) ticks;
+	volatile long next_tick;
+	float seconds;
+	bool started;
+};
+
+/* per-frame tick time buckets: < 0.25 ms, doubling up to >= 16 ms */
+#define OBS_TICK_HISTOGRAM_BUCKETS 8
+
+struct obs_tick_stats {
+	uint64_t frames;
+	uint64_t total_ns;
+	uint64_t max_ns;
+	uint64_t sources_ticked;
+	uint64_t sources_threaded;
+	uint64_t histogram[OBS_TICK_HISTOGRAM_BUCKETS];
+};
+
 /* user sources, output channels, and displays */
 struct obs_core_data {
 	/* Hash tables (uthash) */
@@ -502,6 +625,15 @@ struct obs_core_data {
 
 	DARRAY(char *) protocols;
 	DARRAY(obs_source_t *) sources_to_tick;
+
+	/* Sources with work to do every frame, plus sources that were woken
+	 * up to apply a show/activate change or a deferred update.  Sources
+	 * that have nothing left to do are dropped after their tick. */
+	pthread_mutex_t tick_mutex;
+	DARRAY(obs_source_t *) tick_set;
+
+	struct obs_tick_pool tick_pool;
+	struct obs_tick_stats tick_stats;
 };
 
 /* user hotkeys */
@@ -520,6 +652,21 @@ struct obs_core_hotkeys {
 	bool reroute_hotkeys;
 	DARRAY(obs_hotkey_binding_t) bindings;
 
+	DARRAY(struct obs_hotkey_key_index) key_index;
+	bool key_index_dirty;
+
+	bool event_driven;
+	pthread_mutex_t event_mutex;
+	os_event_t *event_ready;
+	struct deque key_events;
+	bool key_state[OBS_KEY_LAST_VALUE];
+	size_t pressed_bindings;
+
+	uint64_t events_handled;
+	uint64_t event_latency_ns_total;
+	uint64_t event_latency_ns_max;
+	uint64_t bindings_evaluated;
+
 	obs_hotkey_callback_router_func router_func;
 	void *router_func_data;
 
@@ -584,8 +731,11 @@ struct obs_graphics_context {
 	uint64_t last_time;
 	uint64_t interval;
 	uint64_t frame_time_total_ns;
+	uint64_t output_time_total_ns;
+	uint64_t display_time_total_ns;
 	uint64_t fps_total_ns;
 	uint32_t fps_total_frames;
+	uint64_t draw_calls_total;
 	const char *video_thread_name;
 };
 
@@ -601,6 +751,9 @@ extern gs_effect_t *obs_load_effect(gs_effect_t **effect, const char *file);
 extern bool audio_callback(void *param, uint64_t start_ts_in, uint64_t end_ts_in, uint64_t *out_ts, uint32_t mixers,
 			   struct audio_output_data *mixes);
 
+extern void obs_tick_pool_free(struct obs_tick_pool *pool);
+extern void obs_log_tick_stats(const struct obs_tick_stats *stats);
+
 extern struct obs_core_video_mix *get_mix_for_video(video_t *video);
 
 extern void start_raw_video(video_t *video, const struct video_scale_info *conversion, uint32_t frame_rate_divisor,
@@ -803,6 +956,13 @@ struct media_action {
 	};
 };
 
+/* Cumulative cost of one kind of work done by a source, only written by the
+ * thread doing that work and read as is by the telemetry export */
+struct source_telemetry_counter {
+	uint64_t count;
+	uint64_t ns;
+};
+
 struct obs_source {
 	struct obs_context_data context;
 	struct obs_source_info info;
@@ -818,6 +978,9 @@ struct obs_source {
 	/* signals to call the source update in the video thread */
 	long defer_update_count;
 
+	/* source is in obs->data.tick_set, protected by tick_mutex */
+	bool in_tick_set;
+
 	/* ensures show/hide are only called once */
 	volatile long show_refs;
 
@@ -876,6 +1039,9 @@ struct obs_source {
 	pthread_mutex_t audio_mutex;
 	pthread_mutex_t audio_cb_mutex;
 	DARRAY(struct audio_cb_info) audio_cb_list;
+	/* levels shared by the volume meters attached to the source, guarded
+	 * by the meter mutex in obs-audio-controls.c */
+	struct audio_meter *audio_meter;
 	struct obs_audio_data audio_data;
 	size_t audio_storage_size;
 	uint32_t audio_mixers;
@@ -886,6 +1052,9 @@ struct obs_source {
 	float balance;
 	/* audio_is_duplicated: tracks whether a source appears multiple times in the audio tree during this tick */
 	bool audio_is_duplicated;
+	/* time spent in filter_audio, written by the thread outputting the
+	 * audio of the source being filtered (filters only) */
+	struct source_telemetry_counter audio_filter_telemetry;
 
 	/* async video data */
 	gs_texture_t *async_textures[MAX_AV_PLANES];
@@ -987,6 +1156,31 @@ struct obs_source {
 	/* color space */
 	gs_texrender_t *color_space_texrender;
 
+	/* cached filter output for OBS_SOURCE_CACHEABLE sources */
+	gs_texrender_t *render_cache;
+	enum gs_color_space render_cache_space;
+	bool render_cache_linear_srgb;
+	uint32_t render_cache_cx;
+	uint32_t render_cache_cy;
+	volatile bool render_cache_valid;
+
+	/* output of a shareable source reused by every render of it within
+	 * one frame, once it has been rendered for more than one mix per
+	 * frame */
+	gs_texrender_t *shared_render;
+	enum gs_color_space shared_render_space;
+	const struct obs_core_video_mix *shared_render_mix;
+	uint64_t shared_render_frame;
+	uint32_t shared_render_mixes;
+	bool shared_render_linear_srgb;
+	bool shared_render_wanted;
+	bool shared_render_valid;
+
+	/* telemetry, written by the graphics thread */
+	struct source_telemetry_counter tick_telemetry;
+	struct source_telemetry_counter render_telemetry;
+	struct source_telemetry_counter async_upload_telemetry;
+
 	/* audio monitoring */
 	struct audio_monitor *monitor;
 	enum obs_monitoring_type monitoring_type;
@@ -1119,7 +1313,9 @@ static inline enum gs_color_space convert_video_space(enum video_format format,
 extern void obs_source_set_texcoords_centered(obs_source_t *source, bool centered);
 extern void obs_source_activate(obs_source_t *source, enum view_type type);
 extern void obs_source_deactivate(obs_source_t *source, enum view_type type);
-extern void obs_source_video_tick(obs_source_t *source, float seconds);
+extern bool obs_source_video_tick(obs_source_t *source, float seconds);
+extern bool obs_source_needs_tick(const obs_source_t *source);
+extern void obs_source_wake_tick(obs_source_t *source);
 extern float obs_source_get_target_volume(obs_source_t *source, obs_source_t *target);
 extern uint64_t obs_source_get_last_async_ts(const obs_source_t *source);
 
@@ -1514,6 +1710,8 @@ extern void source_profiler_async_frame_received(obs_source_t *source);
 extern uint64_t source_profiler_source_tick_start(void);
 /* Submit start timestamp for source */
 extern void source_profiler_source_tick_end(obs_source_t *source, uint64_t start);
+/* Submit tick time for source, for ticks measured in several parts */
+extern void source_profiler_source_tick_time(obs_source_t *source, uint64_t delta);
 
 /* Obtain GPU timer and start timestamp for render start of a source. */
 extern uint64_t source_profiler_source_render_begin(gs_timer_t **timer);
@@ -1522,3 +1720,18 @@ extern void source_profiler_source_render_end(obs_source_t *source, uint64_t sta
 
 /* Remove source from profiler hashmaps */
 extern void source_profiler_remove_source(obs_source_t *source);
+
+/* Record number of scene item transforms recomputed for a scene/group */
+extern void source_profiler_scene_transforms_updated(obs_source_t *source, uint64_t count);
+/* Record number of scene items that were culled instead of rendered */
+extern void source_profiler_scene_items_culled(obs_source_t *source, uint64_t count);
+/* Record whether cached filter output could be reused for a source */
+extern void source_profiler_render_cache_used(obs_source_t *source, bool hit);
+
+/* Get timestamp for start of an async texture upload or audio filter, 0 if
+ * nothing is being measured */
+extern uint64_t source_profiler_telemetry_start(void);
+/* Submit start timestamp of async texture upload for source */
+extern void source_profiler_async_upload_end(obs_source_t *source, uint64_t start);
+/* Submit start timestamp of filter_audio call for filter */
+extern void source_profiler_audio_filter_end(obs_source_t *filter, uint64_t start);
@@ -41,6 +41,7 @@ struct obs_hotkeys_platform {
 	xkb_keysym_t key_to_sym[MAX_SHIFT_LEVELS][MAX_KEYCODES];
 	xkb_keysym_t obs_to_key[OBS_KEY_LAST_VALUE];
 	uint32_t current_layout;
+	bool key_pressed[OBS_KEY_LAST_VALUE];
 };
 
 static obs_key_t obs_nix_wayland_key_from_virtual_key(int sym);
@@ -100,6 +101,21 @@ static void platform_keyboard_keymap(void *data, struct wl_keyboard *keyboard, u
 	rebuild_keymap_data(plat);
 }
 
+static void set_key_state(obs_hotkeys_platform_t *plat, obs_key_t key, bool pressed)
+{
+	if (key == OBS_KEY_NONE || plat->key_pressed[key] == pressed)
+		return;
+
+	plat->key_pressed[key] = pressed;
+	obs_hotkeys_key_event(key, pressed);
+}
+
+static void update_modifier(obs_hotkeys_platform_t *plat, obs_key_t key, const char *name)
+{
+	bool pressed = xkb_state_mod_name_is_active(plat->xkb_state, name, XKB_STATE_MODS_DEPRESSED) > 0;
+	set_key_state(plat, key, pressed);
+}
+
 static void platform_keyboard_modifiers(void *data, struct wl_keyboard *keyboard, uint32_t serial,
 					uint32_t mods_depressed, uint32_t mods_latched, uint32_t mods_locked,
 					uint32_t group)
@@ -107,8 +123,16 @@ static void platform_keyboard_modifiers(void *data, struct wl_keyboard *keyboard
 	UNUSED_PARAMETER(keyboard);
 	UNUSED_PARAMETER(serial);
 	obs_hotkeys_platform_t *plat = (obs_hotkeys_platform_t *)data;
+	if (!plat->xkb_state)
+		return;
+
 	xkb_state_update_mask(plat->xkb_state, mods_depressed, mods_latched, mods_locked, 0, 0, group);
 
+	update_modifier(plat, OBS_KEY_SHIFT, XKB_MOD_NAME_SHIFT);
+	update_modifier(plat, OBS_KEY_CONTROL, XKB_MOD_NAME_CTRL);
+	update_modifier(plat, OBS_KEY_ALT, XKB_MOD_NAME_ALT);
+	update_modifier(plat, OBS_KEY_META, XKB_MOD_NAME_LOGO);
+
 	if (plat->current_layout != group) {
 		plat->current_layout = group;
 		rebuild_keymap_data(plat);
@@ -118,15 +142,20 @@ static void platform_keyboard_modifiers(void *data, struct wl_keyboard *keyboard
 static void platform_keyboard_key(void *data, struct wl_keyboard *keyboard, uint32_t serial, uint32_t time,
 				  uint32_t key, uint32_t state)
 {
-	UNUSED_PARAMETER(data);
 	UNUSED_PARAMETER(keyboard);
 	UNUSED_PARAMETER(serial);
 	UNUSED_PARAMETER(time);
-	UNUSED_PARAMETER(key);
-	UNUSED_PARAMETER(state);
-	// We have access to the keyboard input here, but behave like other
-	// platforms and let Qt inform us of key events through the platform
-	// callbacks.
+	obs_hotkeys_platform_t *plat = (obs_hotkeys_platform_t *)data;
+
+	// Qt injects the presses, reporting the key state here as well lets
+	// the hotkey thread see when the keys are released.  Wayland keycodes
+	// are offset by 8 in xkb.
+	xkb_keycode_t code = key + 8;
+	if (code >= MAX_KEYCODES)
+		return;
+
+	obs_key_t obs_key = obs_nix_wayland_key_from_virtual_key(plat->key_to_sym[0][code]);
+	set_key_state(plat, obs_key, state == WL_KEYBOARD_KEY_STATE_PRESSED);
 }
 
 static void platform_keyboard_enter(void *data, struct wl_keyboard *keyboard, uint32_t serial,
@@ -143,11 +172,14 @@ static void platform_keyboard_enter(void *data, struct wl_keyboard *keyboard, ui
 static void platform_keyboard_leave(void *data, struct wl_keyboard *keyboard, uint32_t serial,
 				    struct wl_surface *surface)
 {
-	UNUSED_PARAMETER(data);
 	UNUSED_PARAMETER(keyboard);
 	UNUSED_PARAMETER(serial);
 	UNUSED_PARAMETER(surface);
-	// Nothing to do.
+	obs_hotkeys_platform_t *plat = (obs_hotkeys_platform_t *)data;
+
+	// No more key events arrive once focus is lost
+	for (size_t i = 0; i < OBS_KEY_LAST_VALUE; i++)
+		set_key_state(plat, (obs_key_t)i, false);
 }
 
 static void platform_keyboard_repeat_info(void *data, struct wl_keyboard *keyboard, int32_t rate, int32_t delay)
@@ -246,6 +278,10 @@ static bool obs_nix_wayland_hotkeys_platform_init(struct obs_core_hotkeys *hotke
 	struct wl_registry *registry = wl_display_get_registry(display);
 	wl_registry_add_listener(registry, &registry_listener, hotkeys->platform_context);
 	wl_display_roundtrip(display);
+
+	// Key states are reported from the keyboard listener, so the hotkey
+	// thread only has to run when keys change.
+	hotkeys->event_driven = true;
 	return true;
 }
 
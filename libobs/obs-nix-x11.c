@@ -96,6 +96,15 @@ struct obs_hotkeys_platform {
 	bool pressed[XINPUT_MOUSE_LEN];
 	bool update[XINPUT_MOUSE_LEN];
 	bool button_pressed[XINPUT_MOUSE_LEN];
+
+	/* Raw XInput 2 events are read on a connection of their own by the
+	 * input thread, and reported to the hotkey thread as they arrive. */
+	xcb_connection_t *input_connection;
+	xcb_window_t input_wake_window;
+	pthread_t input_thread;
+	bool input_thread_active;
+	obs_key_t keycode_keys[256];
+	uint8_t keys_down[32];
 #endif
 };
 
@@ -838,6 +847,212 @@ static inline void registerMouseEvents(struct obs_core_hotkeys *hotkeys)
 	xcb_input_xi_select_events(connection, window, 1, &mask.head);
 	xcb_flush(connection);
 }
+
+static void fill_keycode_keys(obs_hotkeys_platform_t *context)
+{
+	for (size_t i = 0; i < OBS_KEY_LAST_VALUE; i++) {
+		struct keycode_list *codes = &context->keycodes[i];
+
+		for (size_t j = 0; j < codes->list.num; j++) {
+			xcb_keycode_t code = codes->list.array[j];
+			if (!context->keycode_keys[code])
+				context->keycode_keys[code] = (obs_key_t)i;
+		}
+	}
+
+	if (context->super_l_code)
+		context->keycode_keys[context->super_l_code] = OBS_KEY_META;
+	if (context->super_r_code)
+		context->keycode_keys[context->super_r_code] = OBS_KEY_META;
+}
+
+static inline bool keycode_down(obs_hotkeys_platform_t *context, xcb_keycode_t code)
+{
+	return (context->keys_down[code / 8] & (1 << (code % 8))) != 0;
+}
+
+static void raw_key_event(obs_hotkeys_platform_t *context, xcb_keycode_t code, bool down)
+{
+	obs_key_t key = context->keycode_keys[code];
+	bool pressed = false;
+
+	if (down)
+		context->keys_down[code / 8] |= (uint8_t)(1 << (code % 8));
+	else
+		context->keys_down[code / 8] &= (uint8_t)~(1 << (code % 8));
+
+	if (key == OBS_KEY_NONE)
+		return;
+
+	/* A key stays pressed while any of its keycodes is down, such as
+	 * either shift key */
+	if (key == OBS_KEY_META) {
+		pressed = keycode_down(context, context->super_l_code) || keycode_down(context, context->super_r_code);
+	} else {
+		struct keycode_list *codes = &context->keycodes[key];
+		for (size_t i = 0; i < codes->list.num && !pressed; i++)
+			pressed = keycode_down(context, codes->list.array[i]);
+	}
+
+	obs_hotkeys_key_event(key, pressed);
+}
+
+// Mouse 2 for OBS is Right Click and Mouse 3 is Wheel Click.
+// Mouse Wheel axis clicks (xinput detail 4 5 6 7) are ignored.
+static obs_key_t key_from_button(uint32_t button)
+{
+	switch (button) {
+	case 1:
+		return OBS_KEY_MOUSE1;
+	case 2:
+		return OBS_KEY_MOUSE3;
+	case 3:
+		return OBS_KEY_MOUSE2;
+	default:
+		break;
+	}
+
+	if (button >= 8 && button < XINPUT_MOUSE_LEN + 1)
+		return (obs_key_t)(OBS_KEY_MOUSE4 + (button - 8));
+
+	return OBS_KEY_NONE;
+}
+
+static void *x11_input_thread(void *data)
+{
+	obs_hotkeys_platform_t *context = data;
+	xcb_generic_event_t *ev;
+
+	os_set_thread_name("libobs: x11 input thread");
+
+	while ((ev = xcb_wait_for_event(context->input_connection))) {
+		uint8_t type = ev->response_type & ~0x80;
+
+		/* Sent by stop_input_thread */
+		if (type == XCB_CLIENT_MESSAGE) {
+			free(ev);
+			break;
+		}
+
+		if (type != XCB_GE_GENERIC) {
+			free(ev);
+			continue;
+		}
+
+		switch (((xcb_ge_event_t *)ev)->event_type) {
+		case XCB_INPUT_RAW_KEY_PRESS:
+		case XCB_INPUT_RAW_KEY_RELEASE: {
+			xcb_input_raw_key_press_event_t *raw = (xcb_input_raw_key_press_event_t *)ev;
+			if (raw->detail < 256)
+				raw_key_event(context, (xcb_keycode_t)raw->detail,
+					      raw->event_type == XCB_INPUT_RAW_KEY_PRESS);
+			break;
+		}
+		case XCB_INPUT_RAW_BUTTON_PRESS:
+		case XCB_INPUT_RAW_BUTTON_RELEASE: {
+			xcb_input_raw_button_press_event_t *raw = (xcb_input_raw_button_press_event_t *)ev;
+			obs_key_t key = key_from_button(raw->detail);
+			if (key != OBS_KEY_NONE)
+				obs_hotkeys_key_event(key, raw->event_type == XCB_INPUT_RAW_BUTTON_PRESS);
+			break;
+		}
+		default:
+			break;
+		}
+
+		free(ev);
+	}
+
+	return NULL;
+}
+
+static bool start_input_thread(obs_hotkeys_platform_t *context)
+{
+	int screen_num = 0;
+	xcb_connection_t *connection = xcb_connect(NULL, &screen_num);
+	xcb_input_xi_query_version_reply_t *version;
+	const xcb_query_extension_reply_t *ext;
+	xcb_screen_iterator_t iter;
+	xcb_screen_t *screen = NULL;
+	bool supported;
+
+	if (xcb_connection_has_error(connection))
+		goto fail;
+
+	/* Raw events were added in XInput 2.0 */
+	ext = xcb_get_extension_data(connection, &xcb_input_id);
+	if (!ext || !ext->present)
+		goto fail;
+
+	version = xcb_input_xi_query_version_reply(connection, xcb_input_xi_query_version(connection, 2, 0), NULL);
+	supported = version && version->major_version >= 2;
+	free(version);
+	if (!supported)
+		goto fail;
+
+	iter = xcb_setup_roots_iterator(xcb_get_setup(connection));
+	for (; iter.rem; screen_num--, xcb_screen_next(&iter)) {
+		if (screen_num == 0) {
+			screen = iter.data;
+			break;
+		}
+	}
+	if (!screen)
+		goto fail;
+
+	struct {
+		xcb_input_event_mask_t head;
+		xcb_input_xi_event_mask_t mask;
+	} mask;
+	mask.head.deviceid = XCB_INPUT_DEVICE_ALL_MASTER;
+	mask.head.mask_len = sizeof(mask.mask) / sizeof(uint32_t);
+	mask.mask = XCB_INPUT_XI_EVENT_MASK_RAW_KEY_PRESS | XCB_INPUT_XI_EVENT_MASK_RAW_KEY_RELEASE |
+		    XCB_INPUT_XI_EVENT_MASK_RAW_BUTTON_PRESS | XCB_INPUT_XI_EVENT_MASK_RAW_BUTTON_RELEASE;
+
+	xcb_input_xi_select_events(connection, screen->root, 1, &mask.head);
+
+	/* Never mapped, only used to wake the input thread up */
+	context->input_wake_window = xcb_generate_id(connection);
+	xcb_create_window(connection, XCB_COPY_FROM_PARENT, context->input_wake_window, screen->root, 0, 0, 1, 1, 0,
+			  XCB_WINDOW_CLASS_INPUT_ONLY, XCB_COPY_FROM_PARENT, 0, NULL);
+	xcb_flush(connection);
+
+	context->input_connection = connection;
+	if (pthread_create(&context->input_thread, NULL, x11_input_thread, context) != 0) {
+		context->input_connection = NULL;
+		goto fail;
+	}
+
+	context->input_thread_active = true;
+	return true;
+
+fail:
+	xcb_disconnect(connection);
+	return false;
+}
+
+static void stop_input_thread(obs_hotkeys_platform_t *context)
+{
+	xcb_client_message_event_t event = {0};
+
+	if (!context->input_thread_active)
+		return;
+
+	/* Sent back to this client, since it created the window */
+	event.response_type = XCB_CLIENT_MESSAGE;
+	event.format = 32;
+	event.window = context->input_wake_window;
+	xcb_send_event(context->input_connection, false, context->input_wake_window, XCB_EVENT_MASK_NO_EVENT,
+		       (const char *)&event);
+	xcb_flush(context->input_connection);
+
+	pthread_join(context->input_thread, NULL);
+
+	xcb_destroy_window(context->input_connection, context->input_wake_window);
+	xcb_disconnect(context->input_connection);
+	context->input_connection = NULL;
+	context->input_thread_active = false;
+}
 #endif
 
 static bool obs_nix_x11_hotkeys_platform_init(struct obs_core_hotkeys *hotkeys)
@@ -850,11 +1065,21 @@ static bool obs_nix_x11_hotkeys_platform_init(struct obs_core_hotkeys *hotkeys)
 	hotkeys->platform_context = bzalloc(sizeof(obs_hotkeys_platform_t));
 	hotkeys->platform_context->display = display;
 
-#if defined(XCB_XINPUT_FOUND)
-	registerMouseEvents(hotkeys);
-#endif
 	fill_base_keysyms(hotkeys);
 	fill_keycodes(hotkeys);
+
+#if defined(XCB_XINPUT_FOUND)
+	fill_keycode_keys(hotkeys->platform_context);
+
+	/* Fall back to polling the key states if raw events aren't
+	 * available */
+	if (start_input_thread(hotkeys->platform_context)) {
+		blog(LOG_INFO, "[x11] Using XInput 2 raw events for hotkeys");
+		hotkeys->event_driven = true;
+	} else {
+		registerMouseEvents(hotkeys);
+	}
+#endif
 	return true;
 }
 
@@ -864,6 +1089,10 @@ static void obs_nix_x11_hotkeys_platform_free(struct obs_core_hotkeys *hotkeys)
 	if (!context)
 		return;
 
+#if defined(XCB_XINPUT_FOUND)
+	stop_input_thread(context);
+#endif
+
 	for (size_t i = 0; i < OBS_KEY_LAST_VALUE; i++)
 		da_free(context->keycodes[i].list);
 
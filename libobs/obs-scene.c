@@ -614,6 +614,9 @@ static void update_item_transform(struct obs_scene_item *item, bool update_tex)
 	if (os_atomic_load_long(&item->defer_update) > 0)
 		return;
 
+	if (item->parent)
+		os_atomic_inc_long(&item->parent->transform_updates);
+
 	/* Reset bounds crop */
 	memset(&item->bounds_crop, 0, sizeof(item->bounds_crop));
 
@@ -987,6 +990,29 @@ cleanup:
 	GS_DEBUG_MARKER_END();
 }
 
+static inline bool source_has_filters(obs_source_t *source)
+{
+	pthread_mutex_lock(&source->filter_mutex);
+	bool has_filters = source->filters.num > 0;
+	pthread_mutex_unlock(&source->filter_mutex);
+
+	return has_filters;
+}
+
+/* Items that are entirely outside of the scene would be clipped anyway, so
+ * they can be skipped entirely. Filters can draw outside of the bounds of a
+ * source (e.g. 3D transforms) or rely on being rendered each frame, so
+ * items with filters are never culled. */
+static inline bool item_culled(struct obs_scene_item *item, float cx, float cy)
+{
+	if (!cx || !cy)
+		return false;
+	if (obs_scene_item_box_on_canvas(item, cx, cy))
+		return false;
+
+	return !source_has_filters(item->source);
+}
+
 static void scene_video_tick(void *data, float seconds)
 {
 	struct obs_scene *scene = data;
@@ -1041,6 +1067,8 @@ static void update_transforms_and_prune_sources(obs_scene_t *scene, obs_scene_it
 
 	if (rebuild_group && group_sceneitem)
 		resize_group(group_sceneitem, scene_size_changed);
+
+	source_profiler_scene_transforms_updated(scene->source, os_atomic_set_long(&scene->transform_updates, 0));
 }
 
 static inline bool scene_size_changed(obs_scene_t *scene)
@@ -1056,6 +1084,48 @@ static inline bool scene_size_changed(obs_scene_t *scene)
 	return true;
 }
 
+/* A culled nested scene is not rendered, so its transforms and removed
+ * sources would not be updated until it is visible again.  Do the part of
+ * its render that has to happen every frame anyway, for it and every scene
+ * it would have rendered.  Assumes the video lock of the parent scene. */
+static void prune_culled_scene(obs_source_t *source, obs_scene_item_ptr_array_t *remove_items);
+
+static void prune_culled_items(obs_scene_t *scene, obs_scene_item_ptr_array_t *remove_items)
+{
+	struct obs_scene_item *item = scene->first_item;
+
+	while (item) {
+		if (!item->user_visible && !transition_active(item->hide_transition)) {
+			item = item->next;
+			continue;
+		}
+
+		if (item->is_group) {
+			obs_scene_t *group_scene = item->source->context.data;
+
+			video_lock(group_scene);
+			prune_culled_items(group_scene, remove_items);
+			video_unlock(group_scene);
+		} else {
+			prune_culled_scene(item->source, remove_items);
+		}
+
+		item = item->next;
+	}
+}
+
+static void prune_culled_scene(obs_source_t *source, obs_scene_item_ptr_array_t *remove_items)
+{
+	obs_scene_t *scene = obs_scene_from_source(source);
+	if (!scene)
+		return;
+
+	video_lock(scene);
+	update_transforms_and_prune_sources(scene, remove_items, NULL, scene_size_changed(scene));
+	prune_culled_items(scene, remove_items);
+	video_unlock(scene);
+}
+
 static void scene_video_render(void *data, gs_effect_t *effect)
 {
 	obs_scene_item_ptr_array_t remove_items;
@@ -1071,19 +1141,34 @@ static void scene_video_render(void *data, gs_effect_t *effect)
 		update_transforms_and_prune_sources(scene, &remove_items, NULL, size_changed);
 	}
 
+	/* Group items are in the coordinate space of the group and can't be
+	 * outside of it, so only regular scenes need to be culled. */
+	const float cx = (float)scene_getwidth(scene);
+	const float cy = (float)scene_getheight(scene);
+	const bool cull = !scene->is_group;
+	uint64_t items_culled = 0;
+
 	gs_blend_state_push();
 	gs_reset_blend_state();
 
 	item = scene->first_item;
 	while (item) {
-		if (item->user_visible || transition_active(item->hide_transition))
-			render_item(item);
+		if (item->user_visible || transition_active(item->hide_transition)) {
+			if (cull && item_culled(item, cx, cy)) {
+				prune_culled_scene(item->source, &remove_items);
+				items_culled++;
+			} else {
+				render_item(item);
+			}
+		}
 
 		item = item->next;
 	}
 
 	gs_blend_state_pop();
 
+	source_profiler_scene_items_culled(scene->source, items_culled);
+
 	video_unlock(scene);
 
 	for (size_t i = 0; i < remove_items.num; i++)
@@ -3458,7 +3543,13 @@ static bool resize_scene_base(obs_scene_t *scene, struct vec2 *minv, struct vec2
 		else
 			vec2_copy(&minv_rel, minv);
 
-		while (item) {
+		/* Items only need to be moved (and their transforms
+		 * recomputed) if the top left of the group actually changed,
+		 * otherwise only the items that were marked dirty are
+		 * updated. */
+		bool origin_changed = minv_rel.x != 0.0f || minv_rel.y != 0.0f;
+
+		while (origin_changed && item) {
 			vec2_sub(&item->pos, &item->pos, &minv_rel);
 			update_item_transform(item, false);
 			item = item->next;
@@ -96,6 +96,37 @@ struct obs_scene_item {
 	struct obs_scene_item *next;
 };
 
+/* Checks whether any part of the item's box is within a cx by cy canvas.
+ * The box transform maps the unit square to the item's on-screen bounds, so
+ * its four corners are transformed and the resulting bounding rectangle is
+ * tested against the canvas. */
+static inline bool obs_scene_item_box_on_canvas(const struct obs_scene_item *item, float cx, float cy)
+{
+	struct vec2 minv;
+	struct vec2 maxv;
+	const float corners[4][2] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f}};
+
+	vec2_set(&minv, M_INFINITE, M_INFINITE);
+	vec2_set(&maxv, -M_INFINITE, -M_INFINITE);
+
+	for (size_t i = 0; i < 4; i++) {
+		struct vec3 v;
+		vec3_set(&v, corners[i][0], corners[i][1], 0.0f);
+		vec3_transform(&v, &v, &item->box_transform);
+
+		if (v.x < minv.x)
+			minv.x = v.x;
+		if (v.y < minv.y)
+			minv.y = v.y;
+		if (v.x > maxv.x)
+			maxv.x = v.x;
+		if (v.y > maxv.y)
+			maxv.y = v.y;
+	}
+
+	return maxv.x > 0.0f && maxv.y > 0.0f && minv.x < cx && minv.y < cy;
+}
+
 struct obs_scene {
 	struct obs_source *source;
 
@@ -110,6 +141,10 @@ struct obs_scene {
 
 	int64_t id_counter;
 
+	/* number of item transforms recomputed since the last update pass,
+	 * reported to the source profiler */
+	volatile long transform_updates;
+
 	pthread_mutex_t video_mutex;
 	pthread_mutex_t audio_mutex;
 	struct obs_scene_item *first_item;
@@ -286,6 +286,9 @@ static void obs_source_init_finalize(struct obs_source *source, obs_canvas_t *ca
 		}
 	}
 	obs_context_data_insert_uuid(&source->context, &obs->data.sources_mutex, &obs->data.sources);
+
+	/* ticked once to find out whether it has anything to do every frame */
+	obs_source_wake_tick(source);
 }
 
 static bool obs_source_hotkey_mute(void *data, obs_hotkey_pair_id id, obs_hotkey_t *key, bool pressed)
@@ -747,6 +750,14 @@ void obs_source_destroy(struct obs_source *source)
 		obs_source_filter_remove(source, source->filters.array[0]);
 
 	obs_context_data_remove_uuid(&source->context, &obs->data.sources_mutex, &obs->data.sources);
+
+	pthread_mutex_lock(&obs->data.tick_mutex);
+	if (source->in_tick_set) {
+		da_erase_item(obs->data.tick_set, &source);
+		source->in_tick_set = false;
+	}
+	pthread_mutex_unlock(&obs->data.tick_mutex);
+
 	if (!source->context.private) {
 		if (requires_canvas(source)) {
 			obs_canvas_remove_source(source);
@@ -801,6 +812,10 @@ static void obs_source_destroy_defer(struct obs_source *source)
 		gs_texrender_destroy(source->filter_texrender);
 	if (source->color_space_texrender)
 		gs_texrender_destroy(source->color_space_texrender);
+	if (source->render_cache)
+		gs_texrender_destroy(source->render_cache);
+	if (source->shared_render)
+		gs_texrender_destroy(source->shared_render);
 	gs_leave_context();
 
 	for (i = 0; i < MAX_AV_PLANES; i++)
@@ -1058,6 +1073,7 @@ static void obs_source_deferred_update(obs_source_t *source)
 	if (source->context.data && source->info.update) {
 		long count = os_atomic_load_long(&source->defer_update_count);
 		source->info.update(source->context.data, source->context.settings);
+		obs_source_invalidate_render_cache(source);
 		os_atomic_compare_swap_long(&source->defer_update_count, count, 0);
 		obs_source_dosignal(source, "source_update", "update");
 	}
@@ -1074,6 +1090,7 @@ void obs_source_update(obs_source_t *source, obs_data_t *settings)
 
 	if (source->info.output_flags & OBS_SOURCE_VIDEO) {
 		os_atomic_inc_long(&source->defer_update_count);
+		obs_source_wake_tick(source);
 	} else if (source->context.data && source->info.update) {
 		source->info.update(source->context.data, source->context.settings);
 		obs_source_dosignal(source, "source_update", "update");
@@ -1199,6 +1216,7 @@ static void hide_source(obs_source_t *source)
 static void activate_tree(obs_source_t *parent, obs_source_t *child, void *param)
 {
 	os_atomic_inc_long(&child->activate_refs);
+	obs_source_wake_tick(child);
 
 	UNUSED_PARAMETER(parent);
 	UNUSED_PARAMETER(param);
@@ -1207,6 +1225,7 @@ static void activate_tree(obs_source_t *parent, obs_source_t *child, void *param
 static void deactivate_tree(obs_source_t *parent, obs_source_t *child, void *param)
 {
 	os_atomic_dec_long(&child->activate_refs);
+	obs_source_wake_tick(child);
 
 	UNUSED_PARAMETER(parent);
 	UNUSED_PARAMETER(param);
@@ -1215,6 +1234,7 @@ static void deactivate_tree(obs_source_t *parent, obs_source_t *child, void *par
 static void show_tree(obs_source_t *parent, obs_source_t *child, void *param)
 {
 	os_atomic_inc_long(&child->show_refs);
+	obs_source_wake_tick(child);
 
 	UNUSED_PARAMETER(parent);
 	UNUSED_PARAMETER(param);
@@ -1223,6 +1243,7 @@ static void show_tree(obs_source_t *parent, obs_source_t *child, void *param)
 static void hide_tree(obs_source_t *parent, obs_source_t *child, void *param)
 {
 	os_atomic_dec_long(&child->show_refs);
+	obs_source_wake_tick(child);
 
 	UNUSED_PARAMETER(parent);
 	UNUSED_PARAMETER(param);
@@ -1234,10 +1255,12 @@ void obs_source_activate(obs_source_t *source, enum view_type type)
 		return;
 
 	os_atomic_inc_long(&source->show_refs);
+	obs_source_wake_tick(source);
 	obs_source_enum_active_tree(source, show_tree, NULL);
 
 	if (type == MAIN_VIEW) {
 		os_atomic_inc_long(&source->activate_refs);
+		obs_source_wake_tick(source);
 		obs_source_enum_active_tree(source, activate_tree, NULL);
 	}
 }
@@ -1249,12 +1272,14 @@ void obs_source_deactivate(obs_source_t *source, enum view_type type)
 
 	if (os_atomic_load_long(&source->show_refs) > 0) {
 		os_atomic_dec_long(&source->show_refs);
+		obs_source_wake_tick(source);
 		obs_source_enum_active_tree(source, hide_tree, NULL);
 	}
 
 	if (type == MAIN_VIEW) {
 		if (os_atomic_load_long(&source->activate_refs) > 0) {
 			os_atomic_dec_long(&source->activate_refs);
+			obs_source_wake_tick(source);
 			obs_source_enum_active_tree(source, deactivate_tree, NULL);
 		}
 	}
@@ -1354,12 +1379,43 @@ static void async_tick(obs_source_t *source)
 	pthread_mutex_unlock(&source->async_mutex);
 }
 
-void obs_source_video_tick(obs_source_t *source, float seconds)
+/* Sources without any per-frame work only have to be ticked when their show
+ * or active state changed or an update was deferred, all of which wake them
+ * up through obs_source_wake_tick. */
+bool obs_source_needs_tick(const obs_source_t *source)
+{
+	if (source->info.video_tick || source->filter_texrender)
+		return true;
+	if (source->info.type == OBS_SOURCE_TYPE_TRANSITION)
+		return true;
+	if ((source->info.output_flags & (OBS_SOURCE_ASYNC | OBS_SOURCE_CONTROLLABLE_MEDIA)) != 0)
+		return true;
+
+	return os_atomic_load_long(&source->defer_update_count) > 0 ||
+	       !!os_atomic_load_long(&source->show_refs) != source->showing ||
+	       !!os_atomic_load_long(&source->activate_refs) != source->active;
+}
+
+/* Must be called after the change that requires the tick has been made */
+void obs_source_wake_tick(obs_source_t *source)
+{
+	pthread_mutex_lock(&obs->data.tick_mutex);
+	if (!source->in_tick_set) {
+		da_push_back(obs->data.tick_set, &source);
+		source->in_tick_set = true;
+	}
+	pthread_mutex_unlock(&obs->data.tick_mutex);
+}
+
+/* Returns true if the source still has to have its video_tick called from the
+ * tick pool */
+bool obs_source_video_tick(obs_source_t *source, float seconds)
 {
 	bool now_showing, now_active;
+	bool threaded;
 
 	if (!obs_source_valid(source, "obs_source_video_tick"))
-		return;
+		return false;
 
 	if (source->info.type == OBS_SOURCE_TYPE_TRANSITION)
 		obs_transition_tick(source, seconds);
@@ -1423,11 +1479,15 @@ void obs_source_video_tick(obs_source_t *source, float seconds)
 		source->active = now_active;
 	}
 
-	if (source->context.data && source->info.video_tick)
+	threaded = source->context.data && source->info.video_tick &&
+		   (source->info.output_flags & OBS_SOURCE_THREADSAFE_TICK) != 0;
+
+	if (source->context.data && source->info.video_tick && !threaded)
 		source->info.video_tick(source->context.data, seconds);
 
 	source->async_rendered = false;
 	source->deinterlace_rendered = false;
+	return threaded;
 }
 
 /* unless the value is 3+ hours worth of frames, this won't overflow */
@@ -2526,7 +2586,9 @@ static void obs_source_update_async_video(obs_source_t *source)
 			}
 
 			if (source->async_update_texture) {
+				const uint64_t start = source_profiler_telemetry_start();
 				update_async_textures(source, frame, source->async_textures, source->async_texrender);
+				source_profiler_async_upload_end(source, start);
 				source->async_update_texture = false;
 			}
 
@@ -2678,6 +2740,135 @@ static inline void obs_source_render_filters(obs_source_t *source)
 	obs_source_release(first_filter);
 }
 
+static bool filters_have_flag(obs_source_t *source, uint32_t flag)
+{
+	bool have_flag = true;
+
+	pthread_mutex_lock(&source->filter_mutex);
+	for (size_t i = 0; i < source->filters.num; i++) {
+		obs_source_t *filter = source->filters.array[i];
+
+		if (filter->enabled && (filter->info.output_flags & flag) == 0) {
+			have_flag = false;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&source->filter_mutex);
+
+	return have_flag;
+}
+
+static inline bool render_cache_enabled(obs_source_t *source)
+{
+	if ((source->info.output_flags & OBS_SOURCE_CACHEABLE) == 0)
+		return false;
+
+	return filters_have_flag(source, OBS_SOURCE_CACHEABLE);
+}
+
+/* Draws a texture holding the unblended output of a source with the caller's
+ * blend state, so that it looks the same as rendering the source */
+static void draw_render_cache(gs_texture_t *tex, bool linear_srgb)
+{
+	if (!tex)
+		return;
+
+	gs_effect_t *effect = obs->video.default_effect;
+	gs_technique_t *tech = gs_effect_get_technique(effect, "Draw");
+	gs_eparam_t *image = gs_effect_get_param_by_name(effect, "image");
+
+	const bool previous = gs_framebuffer_srgb_enabled();
+	gs_enable_framebuffer_srgb(linear_srgb);
+
+	if (linear_srgb)
+		gs_effect_set_texture_srgb(image, tex);
+	else
+		gs_effect_set_texture(image, tex);
+
+	const size_t passes = gs_technique_begin(tech);
+	for (size_t i = 0; i < passes; i++) {
+		gs_technique_begin_pass(tech, i);
+		gs_draw_sprite(tex, 0, 0, 0);
+		gs_technique_end_pass(tech);
+	}
+	gs_technique_end(tech);
+
+	gs_enable_framebuffer_srgb(previous);
+}
+
+/* Renders the filter chain to a texture which is reused until the source or
+ * one of its filters is updated or the source changes size */
+static void obs_source_render_filters_cached(obs_source_t *source)
+{
+	const enum gs_color_space space = gs_get_color_space();
+	const enum gs_color_format format = gs_get_format_from_space(space);
+	const bool linear_srgb = gs_get_linear_srgb();
+	const uint32_t cx = obs_source_get_width(source);
+	const uint32_t cy = obs_source_get_height(source);
+
+	if (!cx || !cy)
+		return;
+
+	if (source->render_cache && gs_texrender_get_format(source->render_cache) != format) {
+		gs_texrender_destroy(source->render_cache);
+		source->render_cache = NULL;
+	}
+
+	if (!source->render_cache) {
+		source->render_cache = gs_texrender_create(format, GS_ZS_NONE);
+		os_atomic_set_bool(&source->render_cache_valid, false);
+	}
+
+	bool hit = os_atomic_load_bool(&source->render_cache_valid) && source->render_cache_space == space &&
+		   source->render_cache_linear_srgb == linear_srgb && source->render_cache_cx == cx &&
+		   source->render_cache_cy == cy;
+
+	if (!hit) {
+		/* Mark valid before rendering so invalidations that happen
+		 * while rendering are not lost */
+		os_atomic_set_bool(&source->render_cache_valid, true);
+
+		gs_texrender_reset(source->render_cache);
+		if (gs_texrender_begin_with_color_space(source->render_cache, cx, cy, space)) {
+			struct vec4 clear_color;
+			vec4_zero(&clear_color);
+			gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+			gs_ortho(0.0f, (float)cx, 0.0f, (float)cy, -100.0f, 100.0f);
+
+			/* the output is copied as is and blended when the
+			 * cache is drawn */
+			gs_blend_state_push();
+			gs_enable_blending(true);
+			gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+			gs_blend_op(GS_BLEND_OP_ADD);
+			obs_source_render_filters(source);
+			gs_blend_state_pop();
+
+			gs_texrender_end(source->render_cache);
+			source->render_cache_space = space;
+			source->render_cache_linear_srgb = linear_srgb;
+			source->render_cache_cx = cx;
+			source->render_cache_cy = cy;
+		} else {
+			os_atomic_set_bool(&source->render_cache_valid, false);
+		}
+	}
+
+	source_profiler_render_cache_used(source, hit);
+	draw_render_cache(gs_texrender_get_texture(source->render_cache), linear_srgb);
+}
+
+void obs_source_invalidate_render_cache(obs_source_t *source)
+{
+	if (!obs_source_valid(source, "obs_source_invalidate_render_cache"))
+		return;
+
+	if (source->filter_parent)
+		source = source->filter_parent;
+
+	os_atomic_set_bool(&source->render_cache_valid, false);
+}
+
 static inline uint32_t get_async_width(const obs_source_t *source)
 {
 	return ((source->async_rotation % 180) == 0) ? source->async_width : source->async_height;
@@ -2927,8 +3118,12 @@ static inline void render_video(obs_source_t *source)
 	GS_DEBUG_MARKER_BEGIN_FORMAT(GS_DEBUG_COLOR_SOURCE, get_type_format(source->info.type),
 				     obs_source_get_name(source));
 
-	if (source->filters.num && !source->rendering_filter)
-		obs_source_render_filters(source);
+	if (source->filters.num && !source->rendering_filter) {
+		if (render_cache_enabled(source))
+			obs_source_render_filters_cached(source);
+		else
+			obs_source_render_filters(source);
+	}
 
 	else if (source->info.video_render)
 		obs_source_main_render(source);
@@ -2945,6 +3140,119 @@ static inline void render_video(obs_source_t *source)
 	GS_DEBUG_MARKER_END();
 }
 
+static inline bool shared_render_enabled(obs_source_t *source)
+{
+	const uint32_t flags = source->info.output_flags;
+
+	if (!obs->video.rendering_mix)
+		return false;
+	if (source->info.type != OBS_SOURCE_TYPE_INPUT || (flags & OBS_SOURCE_SHAREABLE) == 0)
+		return false;
+	if (!source->context.data || !source->enabled || source->rendering_filter)
+		return false;
+
+	/* a source drawn in another color space converts with its own blend
+	 * state rather than the one it is rendered with */
+	const enum gs_color_space space = gs_get_color_space();
+	if (obs_source_get_color_space(source, 1, &space) != space)
+		return false;
+
+	/* async inputs without filters already draw straight from their
+	 * texture, and cacheable filter chains have their own cache */
+	if (!source->filters.num)
+		return (flags & OBS_SOURCE_ASYNC) == 0;
+	return !render_cache_enabled(source) && filters_have_flag(source, OBS_SOURCE_SHAREABLE);
+}
+
+/* Renders a shareable source to a texture the first time it is rendered in a
+ * frame, if it was rendered for more than one mix in the frame before, and
+ * draws that texture for every other render in the frame.  The texture holds
+ * the unblended output of the source, so drawing it with the caller's blend
+ * state gives the same result as rendering the source.  Returns false if the
+ * source has to be rendered as usual. */
+static bool obs_source_render_shared(obs_source_t *source)
+{
+	const struct obs_core_video_mix *mix = obs->video.rendering_mix;
+	const uint64_t frame = obs->video.render_frame;
+	const enum gs_color_space space = gs_get_color_space();
+	const bool linear_srgb = gs_get_linear_srgb();
+	bool hit;
+
+	if (source->shared_render_frame != frame) {
+		source->shared_render_wanted = source->shared_render_frame + 1 == frame &&
+					       source->shared_render_mixes > 1;
+		source->shared_render_frame = frame;
+		source->shared_render_mix = NULL;
+		source->shared_render_mixes = 0;
+		source->shared_render_valid = false;
+	}
+
+	/* mixes render one after another, so each change of mix is a new one */
+	if (source->shared_render_mix != mix) {
+		source->shared_render_mix = mix;
+		source->shared_render_mixes++;
+	}
+
+	if (!source->shared_render_wanted)
+		return false;
+
+	hit = source->shared_render_valid;
+	if (hit && (source->shared_render_space != space || source->shared_render_linear_srgb != linear_srgb))
+		return false;
+
+	if (!hit) {
+		const enum gs_color_format format = gs_get_format_from_space(space);
+		const uint32_t cx = obs_source_get_width(source);
+		const uint32_t cy = obs_source_get_height(source);
+		const bool centered = source->texcoords_centered;
+
+		if (!cx || !cy)
+			return false;
+
+		if (source->shared_render && gs_texrender_get_format(source->shared_render) != format) {
+			gs_texrender_destroy(source->shared_render);
+			source->shared_render = NULL;
+		}
+
+		if (!source->shared_render)
+			source->shared_render = gs_texrender_create(format, GS_ZS_NONE);
+
+		gs_texrender_reset(source->shared_render);
+		if (!gs_texrender_begin_with_color_space(source->shared_render, cx, cy, space))
+			return false;
+
+		struct vec4 clear_color;
+		vec4_zero(&clear_color);
+		gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+		gs_ortho(0.0f, (float)cx, 0.0f, (float)cy, -100.0f, 100.0f);
+
+		/* the texture is drawn 1:1 */
+		source->texcoords_centered = true;
+
+		/* filters still blend into their own textures, only the final
+		 * draw is copied as is */
+		gs_blend_state_push();
+		gs_enable_blending(true);
+		gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+		gs_blend_op(GS_BLEND_OP_ADD);
+		render_video(source);
+		gs_blend_state_pop();
+
+		source->texcoords_centered = centered;
+
+		gs_texrender_end(source->shared_render);
+		source->shared_render_space = space;
+		source->shared_render_linear_srgb = linear_srgb;
+		source->shared_render_valid = true;
+	} else {
+		obs->video.rendering_mix->shared_renders++;
+	}
+
+	source_profiler_render_cache_used(source, hit);
+	draw_render_cache(gs_texrender_get_texture(source->shared_render), linear_srgb);
+	return true;
+}
+
 void obs_source_video_render(obs_source_t *source)
 {
 	if (!obs_source_valid(source, "obs_source_video_render"))
@@ -2952,7 +3260,8 @@ void obs_source_video_render(obs_source_t *source)
 
 	source = obs_source_get_ref(source);
 	if (source) {
-		render_video(source);
+		if (!shared_render_enabled(source) || !obs_source_render_shared(source))
+			render_video(source);
 		obs_source_release(source);
 	}
 }
@@ -3108,6 +3417,8 @@ void obs_source_filter_add(obs_source_t *source, obs_source_t *filter)
 
 	pthread_mutex_unlock(&source->filter_mutex);
 
+	obs_source_invalidate_render_cache(source);
+
 	calldata_init_fixed(&cd, stack, sizeof(stack));
 	calldata_set_ptr(&cd, "source", source);
 	calldata_set_ptr(&cd, "filter", filter);
@@ -3145,6 +3456,8 @@ static bool obs_source_filter_remove_refless(obs_source_t *source, obs_source_t
 
 	pthread_mutex_unlock(&source->filter_mutex);
 
+	obs_source_invalidate_render_cache(source);
+
 	calldata_init_fixed(&cd, stack, sizeof(stack));
 	calldata_set_ptr(&cd, "source", source);
 	calldata_set_ptr(&cd, "filter", filter);
@@ -3270,8 +3583,10 @@ void obs_source_filter_set_order(obs_source_t *source, obs_source_t *filter, enu
 	success = move_filter_dir(source, filter, movement);
 	pthread_mutex_unlock(&source->filter_mutex);
 
-	if (success)
+	if (success) {
+		obs_source_invalidate_render_cache(source);
 		obs_source_dosignal(source, NULL, "reorder_filters");
+	}
 }
 
 int obs_source_filter_get_index(obs_source_t *source, obs_source_t *filter)
@@ -3315,8 +3630,10 @@ void obs_source_filter_set_index(obs_source_t *source, obs_source_t *filter, siz
 	success = set_filter_index(source, filter, index);
 	pthread_mutex_unlock(&source->filter_mutex);
 
-	if (success)
+	if (success) {
+		obs_source_invalidate_render_cache(source);
 		obs_source_dosignal(source, NULL, "reorder_filters");
+	}
 }
 
 obs_data_t *obs_source_get_settings(const obs_source_t *source)
@@ -3874,7 +4191,9 @@ static inline struct obs_audio_data *filter_async_audio(obs_source_t *source, st
 			continue;
 
 		if (filter->context.data && filter->info.filter_audio) {
+			const uint64_t start = source_profiler_telemetry_start();
 			in = filter->info.filter_audio(filter->context.data, in);
+			source_profiler_audio_filter_end(filter, start);
 			if (!in)
 				return NULL;
 		}
@@ -4401,6 +4720,7 @@ bool obs_source_process_filter_begin_with_color_space(obs_source_t *filter, enum
 
 	if (!filter->filter_texrender) {
 		filter->filter_texrender = gs_texrender_create(format, GS_ZS_NONE);
+		obs_source_wake_tick(filter);
 	}
 
 	if (gs_texrender_begin_with_color_space(filter->filter_texrender, cx, cy, space)) {
@@ -5014,6 +5334,7 @@ void obs_source_set_enabled(obs_source_t *source, bool enabled)
 		return;
 
 	source->enabled = enabled;
+	obs_source_invalidate_render_cache(source);
 
 	calldata_init_fixed(&data, stack, sizeof(stack));
 	calldata_set_ptr(&data, "source", source);
@@ -208,6 +208,33 @@ enum obs_media_state {
  */
 #define OBS_SOURCE_REQUIRES_CANVAS (1 << 17)
 
+/**
+ * Source/filter video only changes when its settings are updated or when it
+ * calls obs_source_invalidate_render_cache.  If a source and all of its
+ * enabled filters have this flag, the output of the filter chain is cached
+ * and reused until it is invalidated.  Like OBS_SOURCE_SHAREABLE, this also
+ * means the output is a single draw that uses the blend state it is rendered
+ * with.
+ */
+#define OBS_SOURCE_CACHEABLE (1 << 18)
+
+/**
+ * Source/filter video_tick only does CPU work on its own data and can be
+ * called from a worker thread, in parallel with the ticks of other sources
+ * that have this flag.  It must not use the graphics subsystem.  These ticks
+ * run after the ticks of all other sources of the frame.
+ */
+#define OBS_SOURCE_THREADSAFE_TICK (1 << 19)
+
+/**
+ * Source/filter video is a single draw within its width and height that uses
+ * the blend state it is rendered with.  If a source and all of its enabled
+ * filters have this flag and the source is shown in more than one canvas, it
+ * is rendered once per frame to a texture which its other renders of the
+ * frame draw instead.
+ */
+#define OBS_SOURCE_SHAREABLE (1 << 20)
+
 /** @} */
 
 typedef void (*obs_source_enum_proc_t)(obs_source_t *parent, obs_source_t *child, void *param);
@@ -17,6 +17,7 @@
 
 #include <time.h>
 #include <stdlib.h>
+#include <inttypes.h>
 
 #include "obs.h"
 #include "obs-internal.h"
@@ -29,11 +30,176 @@
 #include <windows.h>
 #endif
 
+#define MAX_TICK_THREADS 4
+
+static void tick_pool_run(struct obs_tick_pool *pool)
+{
+	size_t num = pool->ticks.num;
+	size_t i;
+
+	while ((i = (size_t)os_atomic_inc_long(&pool->next_tick) - 1) < num) {
+		struct threaded_tick *tick = pool->ticks.array + i;
+		obs_source_t *source = tick->source;
+		const uint64_t start = tick->profiler_start ? source_profiler_source_tick_start() : 0;
+
+		source->info.video_tick(source->context.data, pool->seconds);
+		if (start)
+			tick->tick_ns += os_gettime_ns() - start;
+	}
+}
+
+static void *tick_pool_thread(void *param)
+{
+	struct obs_tick_pool *pool = param;
+
+	os_set_thread_name("libobs: source tick thread");
+
+	for (;;) {
+		os_sem_wait(pool->start_sem);
+		if (os_atomic_load_bool(&pool->stop))
+			break;
+
+		tick_pool_run(pool);
+		os_sem_post(pool->done_sem);
+	}
+
+	return NULL;
+}
+
+/* Started the first time more than one source has a threadsafe tick, so
+ * nothing is spawned for sessions that never use any */
+static void tick_pool_start(struct obs_tick_pool *pool)
+{
+	int cores = os_get_logical_cores();
+	size_t num_threads = cores > 2 ? (size_t)cores / 2 : 0;
+
+	pool->started = true;
+
+	if (num_threads > MAX_TICK_THREADS)
+		num_threads = MAX_TICK_THREADS;
+	if (!num_threads)
+		return;
+
+	if (os_sem_init(&pool->start_sem, 0) != 0)
+		return;
+	if (os_sem_init(&pool->done_sem, 0) != 0) {
+		os_sem_destroy(pool->start_sem);
+		pool->start_sem = NULL;
+		return;
+	}
+
+	pool->threads = bzalloc(sizeof(pthread_t) * num_threads);
+
+	for (size_t i = 0; i < num_threads; i++) {
+		if (pthread_create(&pool->threads[i], NULL, tick_pool_thread, pool) != 0) {
+			blog(LOG_WARNING, "Failed to create source tick thread %zu", i);
+			break;
+		}
+		pool->num_threads++;
+	}
+}
+
+void obs_tick_pool_free(struct obs_tick_pool *pool)
+{
+	if (pool->num_threads) {
+		os_atomic_set_bool(&pool->stop, true);
+
+		for (size_t i = 0; i < pool->num_threads; i++)
+			os_sem_post(pool->start_sem);
+		for (size_t i = 0; i < pool->num_threads; i++)
+			pthread_join(pool->threads[i], NULL);
+	}
+
+	os_sem_destroy(pool->start_sem);
+	os_sem_destroy(pool->done_sem);
+	da_free(pool->ticks);
+	bfree(pool->threads);
+	memset(pool, 0, sizeof(*pool));
+}
+
+static void run_threaded_ticks(struct obs_tick_pool *pool, float seconds)
+{
+	if (!pool->started && pool->ticks.num > 1)
+		tick_pool_start(pool);
+
+	size_t num_workers = pool->ticks.num - 1;
+
+	if (num_workers > pool->num_threads)
+		num_workers = pool->num_threads;
+
+	pool->seconds = seconds;
+	os_atomic_set_long(&pool->next_tick, 0);
+
+	for (size_t i = 0; i < num_workers; i++)
+		os_sem_post(pool->start_sem);
+
+	tick_pool_run(pool);
+
+	for (size_t i = 0; i < num_workers; i++)
+		os_sem_wait(pool->done_sem);
+
+	/* the profiler is not thread safe, so the time measured on the
+	 * workers is only added to the source samples once all ticks are
+	 * done */
+	for (size_t i = 0; i < pool->ticks.num; i++) {
+		struct threaded_tick *tick = pool->ticks.array + i;
+		if (tick->profiler_start)
+			source_profiler_source_tick_time(tick->source, tick->tick_ns);
+	}
+}
+
+static void update_tick_stats(struct obs_tick_stats *stats, uint64_t frame_ns, size_t ticked, size_t threaded)
+{
+	uint64_t bucket_ns = 250000;
+	size_t bucket = 0;
+
+	while (frame_ns >= bucket_ns && bucket < OBS_TICK_HISTOGRAM_BUCKETS - 1) {
+		bucket_ns *= 2;
+		bucket++;
+	}
+
+	stats->frames++;
+	stats->total_ns += frame_ns;
+	stats->sources_ticked += ticked;
+	stats->sources_threaded += threaded;
+	stats->histogram[bucket]++;
+	if (frame_ns > stats->max_ns)
+		stats->max_ns = frame_ns;
+}
+
+void obs_log_tick_stats(const struct obs_tick_stats *stats)
+{
+	struct dstr histogram = {0};
+	double bucket_ms = 0.25;
+
+	if (!stats->frames)
+		return;
+
+	for (size_t i = 0; i < OBS_TICK_HISTOGRAM_BUCKETS; i++) {
+		double pct = (double)stats->histogram[i] * 100.0 / (double)stats->frames;
+
+		if (i < OBS_TICK_HISTOGRAM_BUCKETS - 1)
+			dstr_catf(&histogram, "%s<%g ms: %.1f%%", i ? ", " : "", bucket_ms, pct);
+		else
+			dstr_catf(&histogram, ", >=%g ms: %.1f%%", bucket_ms / 2.0, pct);
+		bucket_ms *= 2.0;
+	}
+
+	blog(LOG_INFO, "Source ticks: %.3f ms average, %.3f ms max, %.1f sources per frame (%.1f threaded)",
+	     (double)stats->total_ns / (double)stats->frames / 1000000.0, (double)stats->max_ns / 1000000.0,
+	     (double)stats->sources_ticked / (double)stats->frames,
+	     (double)stats->sources_threaded / (double)stats->frames);
+	blog(LOG_INFO, "Source tick time per frame: %s", histogram.array);
+
+	dstr_free(&histogram);
+}
+
 static uint64_t tick_sources(uint64_t cur_time, uint64_t last_time)
 {
 	struct obs_core_data *data = &obs->data;
-	struct obs_source *source;
+	struct obs_tick_pool *pool = &data->tick_pool;
 	uint64_t delta_time;
+	uint64_t tick_start;
 	float seconds;
 
 	if (!last_time)
@@ -58,19 +224,20 @@ static uint64_t tick_sources(uint64_t cur_time, uint64_t last_time)
 	/* ------------------------------------- */
 	/* get an array of all sources to tick   */
 
+	tick_start = os_gettime_ns();
+
 	da_clear(data->sources_to_tick);
+	da_clear(pool->ticks);
 
-	pthread_mutex_lock(&data->sources_mutex);
+	pthread_mutex_lock(&data->tick_mutex);
 
-	source = data->sources;
-	while (source) {
-		obs_source_t *s = obs_source_removed(source) ? NULL : obs_source_get_ref(source);
+	for (size_t i = 0; i < data->tick_set.num; i++) {
+		obs_source_t *s = obs_source_get_ref(data->tick_set.array[i]);
 		if (s)
 			da_push_back(data->sources_to_tick, &s);
-		source = (struct obs_source *)source->context.hh_uuid.next;
 	}
 
-	pthread_mutex_unlock(&data->sources_mutex);
+	pthread_mutex_unlock(&data->tick_mutex);
 
 	/* ------------------------------------- */
 	/* call the tick function of each source */
@@ -79,25 +246,62 @@ static uint64_t tick_sources(uint64_t cur_time, uint64_t last_time)
 		obs_source_t *s = data->sources_to_tick.array[i];
 		if (!obs_source_removed(s)) {
 			const uint64_t start = source_profiler_source_tick_start();
-			obs_source_video_tick(s, seconds);
-			source_profiler_source_tick_end(s, start);
+
+			if (obs_source_video_tick(s, seconds)) {
+				struct threaded_tick *tick = da_push_back_new(pool->ticks);
+				tick->source = s;
+				tick->profiler_start = start;
+				tick->tick_ns = start ? os_gettime_ns() - start : 0;
+			} else {
+				source_profiler_source_tick_end(s, start);
+			}
+		}
+	}
+
+	if (pool->ticks.num)
+		run_threaded_ticks(pool, seconds);
+
+	/* ------------------------------------- */
+	/* drop sources with nothing left to do  */
+
+	pthread_mutex_lock(&data->tick_mutex);
+
+	for (size_t i = 0; i < data->sources_to_tick.num; i++) {
+		obs_source_t *s = data->sources_to_tick.array[i];
+		if (s->in_tick_set && (obs_source_removed(s) || !obs_source_needs_tick(s))) {
+			da_erase_item(data->tick_set, &s);
+			s->in_tick_set = false;
 		}
-		obs_source_release(s);
 	}
 
+	pthread_mutex_unlock(&data->tick_mutex);
+
+	update_tick_stats(&data->tick_stats, os_gettime_ns() - tick_start, data->sources_to_tick.num,
+			  pool->ticks.num);
+
+	for (size_t i = 0; i < data->sources_to_tick.num; i++)
+		obs_source_release(data->sources_to_tick.array[i]);
+
 	return cur_time;
 }
 
 /* in obs-display.c */
-extern void render_display(struct obs_display *display);
+extern bool render_display(struct obs_display *display, uint64_t video_time, bool over_budget);
 
-static inline void render_displays(void)
+/* Displays are rendered after the output frames.  When the outputs already
+ * took up most of the frame budget, displays are skipped for a few frames so
+ * the next output frame is not late. */
+static inline void render_displays(uint64_t frame_start)
 {
 	struct obs_display *display;
+	uint64_t budget_ns = obs->video.video_frame_interval_ns * 3 / 4;
+	bool over_budget;
 
 	if (!obs->data.valid)
 		return;
 
+	over_budget = os_gettime_ns() - frame_start > budget_ns;
+
 	gs_enter_context(obs->video.graphics);
 
 	/* render extra displays/swaps */
@@ -105,7 +309,8 @@ static inline void render_displays(void)
 
 	display = obs->data.first_display;
 	while (display) {
-		render_display(display);
+		if (!render_display(display, obs->video.video_time, over_budget))
+			obs->video.skipped_display_frames++;
 		display = display->next;
 	}
 
@@ -123,12 +328,12 @@ static inline void set_render_size(uint32_t width, uint32_t height)
 	gs_set_viewport(0, 0, width, height);
 }
 
-static inline void unmap_last_surface(struct obs_core_video_mix *video)
+static inline void unmap_surfaces(struct obs_core_video_mix *video, int texture)
 {
 	for (int c = 0; c < NUM_CHANNELS; ++c) {
-		if (video->mapped_surfaces[c]) {
-			gs_stagesurface_unmap(video->mapped_surfaces[c]);
-			video->mapped_surfaces[c] = NULL;
+		if (video->mapped_surfaces[texture][c]) {
+			gs_stagesurface_unmap(video->mapped_surfaces[texture][c]);
+			video->mapped_surfaces[texture][c] = NULL;
 		}
 	}
 }
@@ -196,10 +401,15 @@ static inline void render_main_texture(struct obs_core_video_mix *video)
 
 	/* In some cases we can reuse a previous mix's texture and save re-rendering everything */
 	size_t reuse_idx;
-	if (can_reuse_mix_texture(video, &reuse_idx))
+	if (can_reuse_mix_texture(video, &reuse_idx)) {
 		draw_mix_texture(reuse_idx);
-	else
+	} else {
+		/* sources rendered more than once for the mixes of a frame
+		 * draw from a texture after the first render */
+		obs->video.rendering_mix = video;
 		obs_view_render(video->view);
+		obs->video.rendering_mix = NULL;
+	}
 
 	video->texture_rendered = true;
 
@@ -410,7 +620,19 @@ static inline void stage_output_texture(struct obs_core_video_mix *video, int cu
 {
 	profile_start(stage_output_texture_name);
 
-	unmap_last_surface(video);
+	if (os_atomic_load_bool(&video->copying[cur_texture])) {
+		struct obs_readback_thread *readback = &obs->video.readback;
+		uint64_t wait_start = os_gettime_ns();
+
+		obs_readback_wait(video, cur_texture);
+
+		pthread_mutex_lock(&readback->mutex);
+		readback->wait_ns_total += os_gettime_ns() - wait_start;
+		pthread_mutex_unlock(&readback->mutex);
+	}
+
+	unmap_surfaces(video, cur_texture);
+	video->stage_ts[cur_texture] = os_gettime_ns();
 
 	if (!video->gpu_conversion) {
 		gs_stagesurf_t *copy = copy_surfaces[0];
@@ -593,7 +815,7 @@ static inline bool download_frame(struct obs_core_video_mix *video, int prev_tex
 			if (!gs_stagesurface_map(surface, &frame->data[channel], &frame->linesize[channel]))
 				return false;
 
-			video->mapped_surfaces[channel] = surface;
+			video->mapped_surfaces[prev_texture][channel] = surface;
 		}
 	}
 	return true;
@@ -796,6 +1018,158 @@ static inline void output_video_data(struct obs_core_video_mix *video, struct vi
 	}
 }
 
+/* ------------------------------------------------------------------------- */
+/* readback                                                                  */
+
+static void copy_readback_frame(struct obs_core_video_mix *video, int texture, struct video_data *frame, int count)
+{
+	struct obs_readback_thread *readback = &obs->video.readback;
+	uint64_t start = os_gettime_ns();
+	uint64_t end;
+	uint64_t latency;
+
+	output_video_data(video, frame, count);
+
+	end = os_gettime_ns();
+	latency = end - video->stage_ts[texture];
+
+	pthread_mutex_lock(&readback->mutex);
+	readback->frames++;
+	readback->copy_ns_total += end - start;
+	readback->latency_ns_total += latency;
+	if (latency > readback->latency_ns_max)
+		readback->latency_ns_max = latency;
+	pthread_mutex_unlock(&readback->mutex);
+}
+
+static void *readback_thread(void *param)
+{
+	struct obs_readback_thread *readback = param;
+
+	os_set_thread_name("libobs: readback thread");
+
+	for (;;) {
+		struct obs_readback_job job;
+		bool have_job = false;
+		bool stop;
+
+		os_sem_wait(readback->sem);
+
+		pthread_mutex_lock(&readback->mutex);
+		if (readback->jobs.size) {
+			deque_pop_front(&readback->jobs, &job, sizeof(job));
+			have_job = true;
+		}
+		stop = readback->stop;
+		pthread_mutex_unlock(&readback->mutex);
+
+		if (have_job) {
+			copy_readback_frame(job.mix, job.texture, &job.frame, job.count);
+
+			os_atomic_set_bool(&job.mix->copying[job.texture], false);
+			os_event_signal(job.mix->copy_done);
+		} else if (stop) {
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static void queue_readback_frame(struct obs_core_video_mix *video, int texture, struct video_data *frame, int count)
+{
+	struct obs_readback_thread *readback = &obs->video.readback;
+	struct obs_readback_job job = {
+		.mix = video,
+		.texture = texture,
+		.count = count,
+		.frame = *frame,
+	};
+
+	os_atomic_set_bool(&video->copying[texture], true);
+
+	pthread_mutex_lock(&readback->mutex);
+	deque_push_back(&readback->jobs, &job, sizeof(job));
+	pthread_mutex_unlock(&readback->mutex);
+
+	os_sem_post(readback->sem);
+}
+
+bool obs_readback_thread_init(struct obs_readback_thread *readback)
+{
+	pthread_mutex_init_value(&readback->mutex);
+
+	if (pthread_mutex_init(&readback->mutex, NULL) != 0)
+		return false;
+	if (os_sem_init(&readback->sem, 0) != 0)
+		return false;
+	if (pthread_create(&readback->thread, NULL, readback_thread, readback) != 0)
+		return false;
+
+	readback->initialized = true;
+	return true;
+}
+
+/* Copies the frames that are still queued, then stops the thread */
+void obs_readback_thread_stop(struct obs_readback_thread *readback)
+{
+	if (!readback->initialized)
+		return;
+
+	pthread_mutex_lock(&readback->mutex);
+	readback->stop = true;
+	pthread_mutex_unlock(&readback->mutex);
+
+	os_sem_post(readback->sem);
+	pthread_join(readback->thread, NULL);
+
+	if (readback->frames) {
+		const double frames = (double)readback->frames;
+
+		blog(LOG_INFO,
+		     "Video readback: %" PRIu64 " frames, %.2f ms average latency (%.2f ms max), "
+		     "%.3f ms map, %.3f ms copy, %.3f ms waiting for copies per frame",
+		     readback->frames, (double)readback->latency_ns_total / frames / 1000000.0,
+		     (double)readback->latency_ns_max / 1000000.0, (double)readback->map_ns_total / frames / 1000000.0,
+		     (double)readback->copy_ns_total / frames / 1000000.0,
+		     (double)readback->wait_ns_total / frames / 1000000.0);
+	}
+
+	os_sem_destroy(readback->sem);
+	pthread_mutex_destroy(&readback->mutex);
+	deque_free(&readback->jobs);
+	memset(readback, 0, sizeof(*readback));
+}
+
+void obs_readback_wait(struct obs_core_video_mix *video, int texture)
+{
+	while (os_atomic_load_bool(&video->copying[texture]))
+		os_event_wait(video->copy_done);
+}
+
+void obs_get_video_readback_stats(struct obs_video_readback_stats *stats)
+{
+	struct obs_readback_thread *readback = &obs->video.readback;
+
+	memset(stats, 0, sizeof(*stats));
+
+	if (!readback->initialized)
+		return;
+
+	pthread_mutex_lock(&readback->mutex);
+
+	stats->frames = readback->frames;
+	stats->max_latency_ns = readback->latency_ns_max;
+	if (readback->frames) {
+		stats->avg_latency_ns = readback->latency_ns_total / readback->frames;
+		stats->avg_map_ns = readback->map_ns_total / readback->frames;
+		stats->avg_copy_ns = readback->copy_ns_total / readback->frames;
+		stats->avg_wait_ns = readback->wait_ns_total / readback->frames;
+	}
+
+	pthread_mutex_unlock(&readback->mutex);
+}
+
 void add_ready_encoder_group(obs_encoder_t *encoder)
 {
 	obs_weak_encoder_t *weak = obs_encoder_get_weak_encoder(encoder);
@@ -867,62 +1241,88 @@ static const char *output_frame_render_video_name = "render_video";
 static const char *output_frame_download_frame_name = "download_frame";
 static const char *output_frame_gs_flush_name = "gs_flush";
 static const char *output_frame_output_video_data_name = "output_video_data";
-static inline void output_frame(struct obs_core_video_mix *video)
-{
-	const bool raw_active = video->raw_was_active;
-	const bool gpu_active = video->gpu_was_active;
-
-	int cur_texture = video->cur_texture;
-	int prev_texture = cur_texture == 0 ? NUM_TEXTURES - 1 : cur_texture - 1;
-	struct video_data frame;
-	bool frame_ready = 0;
 
-	memset(&frame, 0, sizeof(struct video_data));
-
-	profile_start(output_frame_gs_context_name);
-	gs_enter_context(obs->video.graphics);
+static inline void render_mix_frame(struct obs_core_video_mix *video)
+{
+	const uint64_t start = os_gettime_ns();
+	uint64_t elapsed;
 
 	profile_start(output_frame_render_video_name);
 	GS_DEBUG_MARKER_BEGIN(GS_DEBUG_COLOR_RENDER_VIDEO, output_frame_render_video_name);
-	render_video(video, raw_active, gpu_active, cur_texture);
+	render_video(video, video->raw_was_active, video->gpu_was_active, video->cur_texture);
 	GS_DEBUG_MARKER_END();
 	profile_end(output_frame_render_video_name);
 
-	if (raw_active) {
-		profile_start(output_frame_download_frame_name);
-		frame_ready = download_frame(video, prev_texture, &frame);
-		profile_end(output_frame_download_frame_name);
-	}
+	elapsed = os_gettime_ns() - start;
+	video->render_frames++;
+	video->render_ns_total += elapsed;
+	if (elapsed > video->render_ns_max)
+		video->render_ns_max = elapsed;
+}
 
-	profile_start(output_frame_gs_flush_name);
-	gs_flush();
-	profile_end(output_frame_gs_flush_name);
+static inline void download_mix_frame(struct obs_core_video_mix *video)
+{
+	/* the oldest staged frame, its surfaces are staged again next frame */
+	int prev_texture = (video->cur_texture + 1) % video->readback_depth;
+	struct obs_readback_thread *readback = &obs->video.readback;
+	uint64_t map_start;
+	uint64_t elapsed;
 
-	gs_leave_context();
-	profile_end(output_frame_gs_context_name);
+	memset(&video->pending_frame, 0, sizeof(struct video_data));
+	video->pending_frame_ready = false;
+
+	if (!video->raw_was_active)
+		return;
+
+	map_start = os_gettime_ns();
+
+	profile_start(output_frame_download_frame_name);
+	video->pending_frame_ready = download_frame(video, prev_texture, &video->pending_frame);
+	profile_end(output_frame_download_frame_name);
+
+	elapsed = os_gettime_ns() - map_start;
+	video->download_ns_total += elapsed;
 
-	if (raw_active && frame_ready) {
+	pthread_mutex_lock(&readback->mutex);
+	readback->map_ns_total += elapsed;
+	pthread_mutex_unlock(&readback->mutex);
+}
+
+static inline void output_mix_frame(struct obs_core_video_mix *video)
+{
+	int prev_texture = (video->cur_texture + 1) % video->readback_depth;
+	struct video_data *frame = &video->pending_frame;
+
+	if (video->raw_was_active && video->pending_frame_ready) {
 		struct obs_vframe_info vframe_info;
 		deque_pop_front(&video->vframe_info_buffer, &vframe_info, sizeof(vframe_info));
 
-		frame.timestamp = vframe_info.timestamp;
-		profile_start(output_frame_output_video_data_name);
-		output_video_data(video, &frame, vframe_info.count);
-		profile_end(output_frame_output_video_data_name);
+		frame->timestamp = vframe_info.timestamp;
+
+		if (video->readback_depth > NUM_TEXTURES) {
+			queue_readback_frame(video, prev_texture, frame, vframe_info.count);
+		} else {
+			profile_start(output_frame_output_video_data_name);
+			copy_readback_frame(video, prev_texture, frame, vframe_info.count);
+			profile_end(output_frame_output_video_data_name);
+		}
 	}
 
-	if (++video->cur_texture == NUM_TEXTURES)
+	video->pending_frame_ready = false;
+
+	if (++video->cur_texture == video->readback_depth)
 		video->cur_texture = 0;
 }
 
+/* Every mix is rendered before any of them maps its staged frame, so the GPU
+ * has the work of all canvases queued before the graphics thread can stall
+ * on a map */
 static inline void output_frames(void)
 {
 	pthread_mutex_lock(&obs->video.mixes_mutex);
 	for (size_t i = 0, num = obs->video.mixes.num; i < num; i++) {
 		struct obs_core_video_mix *mix = obs->video.mixes.array[i];
-		if (mix->view) {
-			output_frame(mix);
-		} else {
+		if (!mix->view) {
 			obs->video.mixes.array[i] = NULL;
 			obs_free_video_mix(mix);
 			da_erase(obs->video.mixes, i);
@@ -930,6 +1330,27 @@ static inline void output_frames(void)
 			num--;
 		}
 	}
+
+	obs->video.render_frame++;
+
+	profile_start(output_frame_gs_context_name);
+	gs_enter_context(obs->video.graphics);
+
+	for (size_t i = 0; i < obs->video.mixes.num; i++)
+		render_mix_frame(obs->video.mixes.array[i]);
+	for (size_t i = 0; i < obs->video.mixes.num; i++)
+		download_mix_frame(obs->video.mixes.array[i]);
+
+	profile_start(output_frame_gs_flush_name);
+	gs_flush();
+	profile_end(output_frame_gs_flush_name);
+
+	gs_leave_context();
+	profile_end(output_frame_gs_context_name);
+
+	for (size_t i = 0; i < obs->video.mixes.num; i++)
+		output_mix_frame(obs->video.mixes.array[i]);
+
 	pthread_mutex_unlock(&obs->video.mixes_mutex);
 }
 
@@ -1100,6 +1521,9 @@ bool obs_graphics_thread_loop(struct obs_graphics_context *context)
 {
 	uint64_t frame_start = os_gettime_ns();
 	uint64_t frame_time_ns;
+	uint64_t output_start;
+	uint64_t display_start;
+	struct gs_frame_stats stats;
 
 	update_active_states();
 
@@ -1107,6 +1531,9 @@ bool obs_graphics_thread_loop(struct obs_graphics_context *context)
 	source_profiler_frame_begin();
 
 	gs_enter_context(obs->video.graphics);
+	/* draw calls of the previous frame */
+	gs_get_frame_stats(&stats);
+	context->draw_calls_total += stats.draw_calls;
 	gs_begin_frame();
 	gs_leave_context();
 
@@ -1124,11 +1551,15 @@ bool obs_graphics_thread_loop(struct obs_graphics_context *context)
 
 	source_profiler_render_begin();
 	profile_start(output_frame_name);
+	output_start = os_gettime_ns();
 	output_frames();
+	context->output_time_total_ns += os_gettime_ns() - output_start;
 	profile_end(output_frame_name);
 
 	profile_start(render_displays_name);
-	render_displays();
+	display_start = os_gettime_ns();
+	render_displays(frame_start);
+	context->display_time_total_ns += os_gettime_ns() - display_start;
 	profile_end(render_displays_name);
 	source_profiler_render_end();
 
@@ -1151,8 +1582,17 @@ bool obs_graphics_thread_loop(struct obs_graphics_context *context)
 		obs->video.video_fps =
 			(double)context->fps_total_frames / ((double)context->fps_total_ns / 1000000000.0);
 		obs->video.video_avg_frame_time_ns = context->frame_time_total_ns / (uint64_t)context->fps_total_frames;
+		obs->video.video_avg_output_time_ns =
+			context->output_time_total_ns / (uint64_t)context->fps_total_frames;
+		obs->video.video_avg_display_time_ns =
+			context->display_time_total_ns / (uint64_t)context->fps_total_frames;
+		obs->video.video_avg_draw_calls =
+			(uint32_t)(context->draw_calls_total / (uint64_t)context->fps_total_frames);
 
 		context->frame_time_total_ns = 0;
+		context->output_time_total_ns = 0;
+		context->display_time_total_ns = 0;
+		context->draw_calls_total = 0;
 		context->fps_total_ns = 0;
 		context->fps_total_frames = 0;
 	}
@@ -1184,8 +1624,11 @@ void *obs_graphics_thread(void *param)
 	struct obs_graphics_context context;
 	context.interval = interval;
 	context.frame_time_total_ns = 0;
+	context.output_time_total_ns = 0;
+	context.display_time_total_ns = 0;
 	context.fps_total_ns = 0;
 	context.fps_total_frames = 0;
+	context.draw_calls_total = 0;
 	context.last_time = 0;
 	context.video_thread_name = video_thread_name;
 
@@ -22,6 +22,7 @@
 
 #include "obs.h"
 #include "obs-internal.h"
+#include "util/source-profiler.h"
 
 struct obs_core *obs = NULL;
 
@@ -370,7 +371,7 @@ static bool obs_init_textures(struct obs_core_video_mix *video)
 		break;
 	}
 
-	for (size_t i = 0; i < NUM_TEXTURES; i++) {
+	for (size_t i = 0; i < (size_t)video->readback_depth; i++) {
 #ifdef _WIN32
 		if (video->using_nv12_tex) {
 			video->copy_surfaces_encode[i] = gs_stagesurface_create_nv12(info->width, info->height);
@@ -434,7 +435,7 @@ static bool obs_init_textures(struct obs_core_video_mix *video)
 	if (success) {
 		video->render_space = space;
 	} else {
-		for (size_t i = 0; i < NUM_TEXTURES; i++) {
+		for (size_t i = 0; i < MAX_READBACK_DEPTH; i++) {
 			for (size_t c = 0; c < NUM_CHANNELS; c++) {
 				if (video->copy_surfaces[i][c]) {
 					gs_stagesurface_destroy(video->copy_surfaces[i][c]);
@@ -623,6 +624,7 @@ static int obs_init_video_mix(struct obs_video_info *ovi, struct obs_core_video_
 	pthread_mutex_unlock(&obs->video.mixes_mutex);
 
 	video->gpu_conversion = ovi->gpu_conversion;
+	video->readback_depth = obs->video.readback_depth ? (int)obs->video.readback_depth : NUM_TEXTURES;
 	video->gpu_was_active = false;
 	video->raw_was_active = false;
 	video->was_active = false;
@@ -642,6 +644,8 @@ static int obs_init_video_mix(struct obs_video_info *ovi, struct obs_core_video_
 
 	if (pthread_mutex_init(&video->gpu_encoder_mutex, NULL) < 0)
 		return OBS_VIDEO_FAIL;
+	if (os_event_init(&video->copy_done, OS_EVENT_TYPE_AUTO) != 0)
+		return OBS_VIDEO_FAIL;
 
 	gs_enter_context(obs->video.graphics);
 
@@ -698,6 +702,8 @@ static int obs_init_video(struct obs_video_info *ovi)
 		return OBS_VIDEO_FAIL;
 	if (pthread_mutex_init(&video->mixes_mutex, NULL) < 0)
 		return OBS_VIDEO_FAIL;
+	if (!obs_readback_thread_init(&video->readback))
+		return OBS_VIDEO_FAIL;
 
 	/* Reset main canvas mix first so it remains first in the rendering order. */
 	if (!obs_canvas_reset_video_internal(obs->data.main_canvas, ovi))
@@ -740,6 +746,8 @@ static void stop_video(void)
 		pthread_join(video->video_thread, &thread_retval);
 		video->thread_initialized = false;
 	}
+
+	obs_readback_thread_stop(&video->readback);
 }
 
 static void obs_free_render_textures(struct obs_core_video_mix *video)
@@ -749,14 +757,16 @@ static void obs_free_render_textures(struct obs_core_video_mix *video)
 
 	gs_enter_context(obs->video.graphics);
 
-	for (size_t c = 0; c < NUM_CHANNELS; c++) {
-		if (video->mapped_surfaces[c]) {
-			gs_stagesurface_unmap(video->mapped_surfaces[c]);
-			video->mapped_surfaces[c] = NULL;
+	for (size_t i = 0; i < MAX_READBACK_DEPTH; i++) {
+		for (size_t c = 0; c < NUM_CHANNELS; c++) {
+			if (video->mapped_surfaces[i][c]) {
+				gs_stagesurface_unmap(video->mapped_surfaces[i][c]);
+				video->mapped_surfaces[i][c] = NULL;
+			}
 		}
 	}
 
-	for (size_t i = 0; i < NUM_TEXTURES; i++) {
+	for (size_t i = 0; i < MAX_READBACK_DEPTH; i++) {
 		for (size_t c = 0; c < NUM_CHANNELS; c++) {
 			if (video->copy_surfaces[i][c]) {
 				gs_stagesurface_destroy(video->copy_surfaces[i][c]);
@@ -795,6 +805,23 @@ static void obs_free_render_textures(struct obs_core_video_mix *video)
 
 void obs_free_video_mix(struct obs_core_video_mix *video)
 {
+	if (video->render_frames) {
+		blog(LOG_INFO,
+		     "Video mix %ux%u: %" PRIu64 " frames, %.2f ms average render (%.2f ms max), "
+		     "%.2f ms average download, %" PRIu64 " shared source renders",
+		     video->ovi.base_width, video->ovi.base_height, video->render_frames,
+		     (double)video->render_ns_total / (double)video->render_frames / 1000000.0,
+		     (double)video->render_ns_max / 1000000.0,
+		     (double)video->download_ns_total / (double)video->render_frames / 1000000.0,
+		     video->shared_renders);
+	}
+
+	/* frames still being copied into the video output */
+	if (video->copy_done) {
+		for (int i = 0; i < MAX_READBACK_DEPTH; i++)
+			obs_readback_wait(video, i);
+	}
+
 	if (video->video) {
 		video_output_close(video->video);
 		video->video = NULL;
@@ -815,6 +842,7 @@ void obs_free_video_mix(struct obs_core_video_mix *video)
 		video->gpu_encoder_active = 0;
 		video->cur_texture = 0;
 	}
+	os_event_destroy(video->copy_done);
 	bfree(video);
 }
 
@@ -969,6 +997,7 @@ static bool obs_init_data(void)
 
 	pthread_mutex_init_value(&obs->data.displays_mutex);
 	pthread_mutex_init_value(&obs->data.draw_callbacks_mutex);
+	pthread_mutex_init_value(&obs->data.tick_mutex);
 
 	if (pthread_mutex_init_recursive(&data->sources_mutex) != 0)
 		goto fail;
@@ -986,6 +1015,8 @@ static bool obs_init_data(void)
 		goto fail;
 	if (pthread_mutex_init_recursive(&obs->data.canvases_mutex) != 0)
 		goto fail;
+	if (pthread_mutex_init(&obs->data.tick_mutex, NULL) != 0)
+		goto fail;
 
 	data->sources = NULL;
 	data->public_sources = NULL;
@@ -1056,6 +1087,9 @@ static void obs_free_data(void)
 
 	os_task_queue_wait(obs->destruction_task_thread);
 
+	obs_log_tick_stats(&data->tick_stats);
+	obs_tick_pool_free(&data->tick_pool);
+
 	pthread_mutex_destroy(&data->sources_mutex);
 	pthread_mutex_destroy(&data->audio_sources_mutex);
 	pthread_mutex_destroy(&data->displays_mutex);
@@ -1064,6 +1098,7 @@ static void obs_free_data(void)
 	pthread_mutex_destroy(&data->services_mutex);
 	pthread_mutex_destroy(&data->draw_callbacks_mutex);
 	pthread_mutex_destroy(&data->canvases_mutex);
+	pthread_mutex_destroy(&data->tick_mutex);
 	da_free(data->draw_callbacks);
 	da_free(data->rendered_callbacks);
 	da_free(data->tick_callbacks);
@@ -1073,6 +1108,7 @@ static void obs_free_data(void)
 		bfree(data->protocols.array[i]);
 	da_free(data->protocols);
 	da_free(data->sources_to_tick);
+	da_free(data->tick_set);
 }
 
 static const char *obs_signals[] = {
@@ -1148,6 +1184,13 @@ static inline bool obs_init_hotkeys(void)
 	hotkeys->sceneitem_show = bstrdup("Show '%1'");
 	hotkeys->sceneitem_hide = bstrdup("Hide '%1'");
 
+	/* Event-driven platforms may report keys as soon as they are
+	 * initialized */
+	if (pthread_mutex_init(&hotkeys->event_mutex, NULL) != 0)
+		return false;
+	if (os_event_init(&hotkeys->event_ready, OS_EVENT_TYPE_AUTO) != 0)
+		return false;
+
 	if (!obs_hotkeys_platform_init(hotkeys))
 		return false;
 
@@ -1175,6 +1218,7 @@ static inline void stop_hotkeys(void)
 
 	if (hotkeys->hotkey_thread_initialized) {
 		os_event_signal(hotkeys->stop_event);
+		os_event_signal(hotkeys->event_ready);
 		pthread_join(hotkeys->hotkey_thread, &thread_ret);
 		hotkeys->hotkey_thread_initialized = false;
 	}
@@ -1198,6 +1242,10 @@ static inline void obs_free_hotkeys(void)
 
 	obs_hotkeys_platform_free(hotkeys);
 	pthread_mutex_destroy(&hotkeys->mutex);
+
+	deque_free(&hotkeys->key_events);
+	os_event_destroy(hotkeys->event_ready);
+	pthread_mutex_destroy(&hotkeys->event_mutex);
 }
 
 extern const struct obs_source_info scene_info;
@@ -1378,6 +1426,7 @@ void obs_shutdown(void)
 {
 	struct obs_module *module;
 
+	source_profiler_export_stop();
 	obs_wait_for_destroy_queue();
 
 	for (size_t i = 0; i < obs->source_types.num; i++) {
@@ -2892,6 +2941,21 @@ uint64_t obs_get_average_frame_time_ns(void)
 	return obs->video.video_avg_frame_time_ns;
 }
 
+uint64_t obs_get_average_output_render_time_ns(void)
+{
+	return obs->video.video_avg_output_time_ns;
+}
+
+uint64_t obs_get_average_display_render_time_ns(void)
+{
+	return obs->video.video_avg_display_time_ns;
+}
+
+uint32_t obs_get_average_draw_calls(void)
+{
+	return obs->video.video_avg_draw_calls;
+}
+
 uint64_t obs_get_frame_interval_ns(void)
 {
 	return obs->video.video_frame_interval_ns;
@@ -3080,6 +3144,25 @@ uint32_t obs_get_lagged_frames(void)
 	return obs->video.lagged_frames;
 }
 
+bool obs_set_video_readback_depth(uint32_t depth)
+{
+	if (depth < NUM_TEXTURES || depth > MAX_READBACK_DEPTH)
+		return false;
+
+	obs->video.readback_depth = depth;
+	return true;
+}
+
+uint32_t obs_get_video_readback_depth(void)
+{
+	return obs->video.readback_depth ? obs->video.readback_depth : NUM_TEXTURES;
+}
+
+uint32_t obs_get_skipped_display_frames(void)
+{
+	return obs->video.skipped_display_frames;
+}
+
 struct obs_core_video_mix *get_mix_for_video(video_t *v)
 {
 	struct obs_core_video_mix *result = NULL;
@@ -908,11 +908,44 @@ EXPORT uint64_t obs_get_video_frame_time(void);
 
 EXPORT double obs_get_active_fps(void);
 EXPORT uint64_t obs_get_average_frame_time_ns(void);
+EXPORT uint64_t obs_get_average_output_render_time_ns(void);
+EXPORT uint64_t obs_get_average_display_render_time_ns(void);
+EXPORT uint32_t obs_get_average_draw_calls(void);
 EXPORT uint64_t obs_get_frame_interval_ns(void);
 
 EXPORT uint32_t obs_get_total_frames(void);
 EXPORT uint32_t obs_get_lagged_frames(void);
 
+/** Number of display frames skipped to leave the frame budget to the outputs */
+EXPORT uint32_t obs_get_skipped_display_frames(void);
+
+/**
+ * Sets the number of frames of staging surfaces used for raw video readback,
+ * from 2 (the default) to 4.  Only applies to video mixes created afterwards,
+ * for example by the next obs_reset_video.  Every level past the default maps
+ * frames one frame later, so mapping does not wait on the GPU, and copies them
+ * into the video output on a separate thread, at the cost of one frame of
+ * latency.
+ */
+EXPORT bool obs_set_video_readback_depth(uint32_t depth);
+EXPORT uint32_t obs_get_video_readback_depth(void);
+
+struct obs_video_readback_stats {
+	uint64_t frames;
+	/* from staging a frame to it being copied into the video output */
+	uint64_t avg_latency_ns;
+	uint64_t max_latency_ns;
+	/* per frame, time spent mapping on the graphics thread */
+	uint64_t avg_map_ns;
+	/* per frame, time spent copying into the video output */
+	uint64_t avg_copy_ns;
+	/* per frame, time the graphics thread waited for copies to finish */
+	uint64_t avg_wait_ns;
+};
+
+/** Readback statistics since the last obs_reset_video */
+EXPORT void obs_get_video_readback_stats(struct obs_video_readback_stats *stats);
+
 OBS_DEPRECATED EXPORT bool obs_nv12_tex_active(void);
 OBS_DEPRECATED EXPORT bool obs_p010_tex_active(void);
 
@@ -1023,6 +1056,12 @@ EXPORT bool obs_display_enabled(obs_display_t *display);
 
 EXPORT void obs_display_set_background_color(obs_display_t *display, uint32_t color);
 
+/**
+ * Limits how often the display is rendered, independently of the output frame
+ * rate.  0 renders the display on every output frame, which is the default.
+ */
+EXPORT void obs_display_set_max_fps(obs_display_t *display, double fps);
+
 EXPORT void obs_display_size(obs_display_t *display, uint32_t *width, uint32_t *height);
 
 /* ------------------------------------------------------------------------- */
@@ -1495,6 +1534,13 @@ EXPORT void obs_source_process_filter_tech_end(obs_source_t *filter, gs_effect_t
 /** Skips the filter if the filter is invalid and cannot be rendered */
 EXPORT void obs_source_skip_video_filter(obs_source_t *filter);
 
+/**
+ * Marks the cached filter output of a source with the OBS_SOURCE_CACHEABLE
+ * flag as outdated, call when the source/filter's video changed outside of
+ * its update callback.
+ */
+EXPORT void obs_source_invalidate_render_cache(obs_source_t *source);
+
 /**
  * Adds an active child source.  Must be called by parent sources on child
  * sources when the child is added and active.  This ensures that the source is
@@ -2689,6 +2735,21 @@ EXPORT bool obs_canvas_get_video_info(const obs_canvas_t *canvas, struct obs_vid
 /** Renders the sources of this canvas's view context */
 EXPORT void obs_canvas_render(obs_canvas_t *canvas);
 
+struct obs_canvas_render_stats {
+	uint64_t frames;
+	/* per frame, graphics thread time spent rendering the canvas */
+	uint64_t avg_render_ns;
+	uint64_t max_render_ns;
+	/* per frame, graphics thread time spent mapping its staged frame */
+	uint64_t avg_download_ns;
+	/* source renders drawn from a texture rendered earlier in the same
+	 * frame, for this or another canvas */
+	uint64_t shared_renders;
+};
+
+/** Render statistics of the canvas's video mix since it was (re)created */
+EXPORT void obs_canvas_get_render_stats(obs_canvas_t *canvas, struct obs_canvas_render_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
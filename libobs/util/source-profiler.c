@@ -17,7 +17,11 @@
 
 #include "source-profiler.h"
 
+#include <inttypes.h>
+#include <time.h>
+
 #include "darray.h"
+#include "dstr.h"
 #include "obs-internal.h"
 #include "platform.h"
 #include "threading.h"
@@ -25,6 +29,10 @@
 
 struct frame_sample {
 	uint64_t tick;
+	uint64_t transform_updates;
+	uint64_t items_culled;
+	uint64_t render_cache_hits;
+	uint64_t render_cache_misses;
 	DARRAY(uint64_t) render_cpu;
 	DARRAY(gs_timer_t *) render_timers;
 };
@@ -69,6 +77,33 @@ struct profiler_entry {
 	struct ucirclebuf async_frame_ts;
 	/* Timestamps of last N async frames rendered */
 	struct ucirclebuf async_rendered_ts;
+	/* Number of scene item transforms recomputed in last N frames */
+	struct ucirclebuf transform_updates;
+	/* Number of scene items culled in last N frames */
+	struct ucirclebuf items_culled;
+	/* Cached filter output reused/re-rendered in last N frames */
+	struct ucirclebuf render_cache_hits;
+	struct ucirclebuf render_cache_misses;
+	/* Decode latency and queue depth of last N decoded async frames */
+	struct ucirclebuf decode_latency;
+	struct ucirclebuf decode_queue_depth;
+	/* GPU time of all render passes while telemetry is exported */
+	uint64_t render_gpu_total;
+
+	UT_hash_handle hh;
+};
+
+struct client_entry {
+	/* the pointer address of the client is the hashtable key */
+	uintptr_t key;
+
+	/* Time and events reported since the last frame */
+	uint64_t pending_time;
+	uint64_t pending_events;
+
+	/* Time and events reported in last N frames */
+	struct ucirclebuf time;
+	struct ucirclebuf events;
 
 	UT_hash_handle hh;
 };
@@ -76,6 +111,7 @@ struct profiler_entry {
 /* Hashmaps */
 struct source_samples *hm_samples = NULL;
 struct profiler_entry *hm_entries = NULL;
+struct client_entry *hm_clients = NULL;
 
 /* GPU timer ranges (only required for DirectX) */
 static uint8_t timer_idx = 0;
@@ -93,6 +129,9 @@ static bool gpu_enabled = false;
 /* These can be set from other threads, mark them volatile */
 static volatile bool enable_next = false;
 static volatile bool gpu_enable_next = false;
+/* Set while the telemetry export is running, sources then keep cumulative
+ * costs even if the profiler itself is disabled */
+static volatile bool telemetry_enabled = false;
 
 void ucirclebuf_init(struct ucirclebuf *buf, size_t capacity)
 {
@@ -174,6 +213,12 @@ static struct profiler_entry *entry_create(const uintptr_t key)
 	ucirclebuf_init(&ent->render_gpu_sum, profiler_samples);
 	ucirclebuf_init(&ent->async_frame_ts, profiler_samples);
 	ucirclebuf_init(&ent->async_rendered_ts, profiler_samples);
+	ucirclebuf_init(&ent->transform_updates, profiler_samples);
+	ucirclebuf_init(&ent->items_culled, profiler_samples);
+	ucirclebuf_init(&ent->render_cache_hits, profiler_samples);
+	ucirclebuf_init(&ent->render_cache_misses, profiler_samples);
+	ucirclebuf_init(&ent->decode_latency, profiler_samples);
+	ucirclebuf_init(&ent->decode_queue_depth, profiler_samples);
 	return ent;
 }
 
@@ -186,6 +231,28 @@ static void entry_destroy(struct profiler_entry *entry)
 	ucirclebuf_free(&entry->render_gpu_sum);
 	ucirclebuf_free(&entry->async_frame_ts);
 	ucirclebuf_free(&entry->async_rendered_ts);
+	ucirclebuf_free(&entry->transform_updates);
+	ucirclebuf_free(&entry->items_culled);
+	ucirclebuf_free(&entry->render_cache_hits);
+	ucirclebuf_free(&entry->render_cache_misses);
+	ucirclebuf_free(&entry->decode_latency);
+	ucirclebuf_free(&entry->decode_queue_depth);
+	bfree(entry);
+}
+
+static struct client_entry *client_entry_create(const uintptr_t key)
+{
+	struct client_entry *ent = bzalloc(sizeof(struct client_entry));
+	ent->key = key;
+	ucirclebuf_init(&ent->time, profiler_samples);
+	ucirclebuf_init(&ent->events, profiler_samples);
+	return ent;
+}
+
+static void client_entry_destroy(struct client_entry *entry)
+{
+	ucirclebuf_free(&entry->time);
+	ucirclebuf_free(&entry->events);
 	bfree(entry);
 }
 
@@ -215,6 +282,11 @@ static void profiler_shutdown(void)
 		HASH_DEL(hm_entries, ent);
 		entry_destroy(ent);
 	}
+	struct client_entry *client, *ctmp;
+	HASH_ITER (hh, hm_clients, client, ctmp) {
+		HASH_DEL(hm_clients, client);
+		client_entry_destroy(client);
+	}
 	pthread_rwlock_unlock(&hm_rwlock);
 
 	reset_gpu_timers();
@@ -327,6 +399,13 @@ void source_profiler_frame_collect(void)
 		}
 
 		ucirclebuf_push(&ent->tick, smp->tick);
+		ucirclebuf_push(&ent->transform_updates, smp->transform_updates);
+		smp->transform_updates = 0;
+		ucirclebuf_push(&ent->items_culled, smp->items_culled);
+		smp->items_culled = 0;
+		ucirclebuf_push(&ent->render_cache_hits, smp->render_cache_hits);
+		ucirclebuf_push(&ent->render_cache_misses, smp->render_cache_misses);
+		smp->render_cache_hits = smp->render_cache_misses = 0;
 
 		if (smp->render_cpu.num) {
 			uint64_t sum = 0;
@@ -362,6 +441,9 @@ void source_profiler_frame_collect(void)
 			if (first) {
 				ucirclebuf_push(&ent->render_gpu, first);
 				ucirclebuf_push(&ent->render_gpu_sum, sum);
+
+				if (telemetry_enabled)
+					ent->render_gpu_total += sum;
 			}
 			da_clear(smp->render_timers);
 		} else {
@@ -378,6 +460,15 @@ void source_profiler_frame_collect(void)
 		smps = smps->hh.next;
 	}
 
+	struct client_entry *client = hm_clients;
+	while (client) {
+		ucirclebuf_push(&client->time, client->pending_time);
+		ucirclebuf_push(&client->events, client->pending_events);
+		client->pending_time = client->pending_events = 0;
+
+		client = client->hh.next;
+	}
+
 	pthread_rwlock_unlock(&hm_rwlock);
 
 	if (gpu_enabled && gpu_ready)
@@ -412,9 +503,66 @@ void source_profiler_async_frame_received(obs_source_t *source)
 	pthread_rwlock_unlock(&hm_rwlock);
 }
 
-uint64_t source_profiler_source_tick_start(void)
+void source_profiler_async_frame_decoded(obs_source_t *source, uint64_t latency_ns, uint32_t queue_depth)
+{
+	if (!enabled)
+		return;
+
+	pthread_rwlock_wrlock(&hm_rwlock);
+
+	struct profiler_entry *ent;
+	HASH_FIND_PTR(hm_entries, &source, ent);
+	if (ent) {
+		ucirclebuf_push(&ent->decode_latency, latency_ns);
+		ucirclebuf_push(&ent->decode_queue_depth, queue_depth);
+	}
+
+	pthread_rwlock_unlock(&hm_rwlock);
+}
+
+void source_profiler_client_time(const void *client, uint64_t time_ns, uint32_t events)
 {
 	if (!enabled)
+		return;
+
+	pthread_rwlock_wrlock(&hm_rwlock);
+
+	struct client_entry *ent;
+	HASH_FIND_PTR(hm_clients, &client, ent);
+	if (!ent) {
+		ent = client_entry_create((uintptr_t)client);
+		HASH_ADD_PTR(hm_clients, key, ent);
+	}
+
+	ent->pending_time += time_ns;
+	ent->pending_events += events;
+
+	pthread_rwlock_unlock(&hm_rwlock);
+}
+
+void source_profiler_remove_client(const void *client)
+{
+	pthread_rwlock_wrlock(&hm_rwlock);
+
+	struct client_entry *ent;
+	HASH_FIND_PTR(hm_clients, &client, ent);
+	if (ent) {
+		HASH_DEL(hm_clients, ent);
+		client_entry_destroy(ent);
+	}
+
+	pthread_rwlock_unlock(&hm_rwlock);
+}
+
+static inline void telemetry_add(struct source_telemetry_counter *counter, uint64_t delta)
+{
+	counter->count++;
+	counter->ns += delta;
+}
+
+uint64_t source_profiler_source_tick_start(void)
+{
+	if (!enabled && !telemetry_enabled)
 		return 0;
 
 	return os_gettime_ns();
@@ -422,10 +570,18 @@ uint64_t source_profiler_source_tick_start(void)
 
 void source_profiler_source_tick_end(obs_source_t *source, uint64_t start)
 {
-	if (!enabled)
+	if (!start)
 		return;
 
-	const uint64_t delta = os_gettime_ns() - start;
+	source_profiler_source_tick_time(source, os_gettime_ns() - start);
+}
+
+void source_profiler_source_tick_time(obs_source_t *source, uint64_t delta)
+{
+	if (telemetry_enabled)
+		telemetry_add(&source->tick_telemetry, delta);
+	if (!enabled)
+		return;
 
 	struct source_samples *smp = NULL;
 	HASH_FIND_PTR(hm_samples, &source, smp);
@@ -443,7 +599,7 @@ void source_profiler_source_tick_end(obs_source_t *source, uint64_t start)
 
 uint64_t source_profiler_source_render_begin(gs_timer_t **timer)
 {
-	if (!enabled)
+	if (!enabled && !telemetry_enabled)
 		return 0;
 
 	if (gpu_enabled) {
@@ -458,13 +614,18 @@ uint64_t source_profiler_source_render_begin(gs_timer_t **timer)
 
 void source_profiler_source_render_end(obs_source_t *source, uint64_t start, gs_timer_t *timer)
 {
-	if (!enabled)
+	if (!start)
 		return;
 	if (timer)
 		gs_timer_end(timer);
 
 	const uint64_t delta = os_gettime_ns() - start;
 
+	if (telemetry_enabled)
+		telemetry_add(&source->render_telemetry, delta);
+	if (!enabled)
+		return;
+
 	struct source_samples *smp;
 	HASH_FIND_PTR(hm_samples, &source, smp);
 
@@ -478,6 +639,64 @@ void source_profiler_source_render_end(obs_source_t *source, uint64_t start, gs_
 	}
 }
 
+void source_profiler_scene_transforms_updated(obs_source_t *source, uint64_t count)
+{
+	if (!enabled || !count)
+		return;
+
+	struct source_samples *smp;
+	HASH_FIND_PTR(hm_samples, &source, smp);
+
+	/* Scenes can be rendered more than once per frame, so accumulate */
+	if (smp)
+		smp->frames[smp->frame_idx]->transform_updates += count;
+}
+
+void source_profiler_scene_items_culled(obs_source_t *source, uint64_t count)
+{
+	if (!enabled || !count)
+		return;
+
+	struct source_samples *smp;
+	HASH_FIND_PTR(hm_samples, &source, smp);
+
+	if (smp)
+		smp->frames[smp->frame_idx]->items_culled += count;
+}
+
+void source_profiler_render_cache_used(obs_source_t *source, bool hit)
+{
+	if (!enabled)
+		return;
+
+	struct source_samples *smp;
+	HASH_FIND_PTR(hm_samples, &source, smp);
+	if (!smp)
+		return;
+
+	if (hit)
+		smp->frames[smp->frame_idx]->render_cache_hits++;
+	else
+		smp->frames[smp->frame_idx]->render_cache_misses++;
+}
+
+uint64_t source_profiler_telemetry_start(void)
+{
+	return telemetry_enabled ? os_gettime_ns() : 0;
+}
+
+void source_profiler_async_upload_end(obs_source_t *source, uint64_t start)
+{
+	if (start)
+		telemetry_add(&source->async_upload_telemetry, os_gettime_ns() - start);
+}
+
+void source_profiler_audio_filter_end(obs_source_t *filter, uint64_t start)
+{
+	if (start)
+		telemetry_add(&filter->audio_filter_telemetry, os_gettime_ns() - start);
+}
+
 static void task_delete_source(void *key)
 {
 	struct source_samples *smp;
@@ -560,6 +779,62 @@ static inline void calculate_render(struct profiler_entry *ent, struct profiler_
 	}
 }
 
+static inline void calculate_scene(struct profiler_entry *ent, struct profiler_result *result)
+{
+	size_t idx = 0;
+	uint64_t sum = 0;
+
+	for (; idx < ent->transform_updates.num; idx++) {
+		const uint64_t count = ent->transform_updates.array[idx];
+		if (count > result->transform_updates_max)
+			result->transform_updates_max = count;
+
+		sum += count;
+	}
+
+	if (idx)
+		result->transform_updates_avg = sum / idx;
+
+	sum = 0;
+	for (idx = 0; idx < ent->items_culled.num; idx++)
+		sum += ent->items_culled.array[idx];
+
+	if (idx)
+		result->items_culled_avg = sum / idx;
+}
+
+static inline void calculate_render_cache(struct profiler_entry *ent, struct profiler_result *result)
+{
+	for (size_t idx = 0; idx < ent->render_cache_hits.num; idx++) {
+		result->render_cache_hits += ent->render_cache_hits.array[idx];
+		result->render_cache_misses += ent->render_cache_misses.array[idx];
+	}
+}
+
+static inline void calculate_decode(struct profiler_entry *ent, struct profiler_result *result)
+{
+	size_t idx;
+	uint64_t latency_sum = 0, depth_sum = 0;
+
+	for (idx = 0; idx < ent->decode_latency.num; idx++) {
+		const uint64_t latency = ent->decode_latency.array[idx];
+		const uint64_t depth = ent->decode_queue_depth.array[idx];
+
+		if (latency > result->decode_latency_max)
+			result->decode_latency_max = latency;
+		if (depth > result->decode_queue_depth_max)
+			result->decode_queue_depth_max = depth;
+
+		latency_sum += latency;
+		depth_sum += depth;
+	}
+
+	if (idx) {
+		result->decode_latency_avg = latency_sum / idx;
+		result->decode_queue_depth_avg = depth_sum / idx;
+	}
+}
+
 static inline void calculate_fps(const struct ucirclebuf *frames, double *avg, uint64_t *best, uint64_t *worst)
 {
 	uint64_t deltas = 0, delta_sum = 0, best_delta = 0, worst_delta = 0;
@@ -605,12 +880,15 @@ bool source_profiler_fill_result(obs_source_t *source, struct profiler_result *r
 	if (ent) {
 		calculate_tick(ent, result);
 		calculate_render(ent, result);
+		calculate_scene(ent, result);
+		calculate_render_cache(ent, result);
 
 		if (is_async_video_source(source)) {
 			calculate_fps(&ent->async_frame_ts, &result->async_input, &result->async_input_best,
 				      &result->async_input_worst);
 			calculate_fps(&ent->async_rendered_ts, &result->async_rendered, &result->async_rendered_best,
 				      &result->async_rendered_worst);
+			calculate_decode(ent, result);
 		}
 	}
 
@@ -628,3 +906,359 @@ profiler_result_t *source_profiler_get_result(obs_source_t *source)
 	}
 	return ret;
 }
+
+bool source_profiler_fill_client_result(const void *client, profiler_client_result_t *result)
+{
+	if (!enabled || !result)
+		return false;
+
+	memset(result, 0, sizeof(struct profiler_client_result));
+
+	pthread_rwlock_rdlock(&hm_rwlock);
+
+	struct client_entry *ent = NULL;
+	HASH_FIND_PTR(hm_clients, &client, ent);
+	if (ent) {
+		size_t idx;
+		uint64_t sum = 0;
+
+		for (idx = 0; idx < ent->time.num; idx++) {
+			const uint64_t delta = ent->time.array[idx];
+			if (delta > result->time_max)
+				result->time_max = delta;
+
+			sum += delta;
+			result->events += ent->events.array[idx];
+		}
+
+		if (idx)
+			result->time_avg = sum / idx;
+	}
+
+	pthread_rwlock_unlock(&hm_rwlock);
+
+	return !!ent;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Telemetry export                                                          */
+
+struct telemetry_sample {
+	char *name;
+	char *uuid;
+	const char *type;
+
+	uint64_t tick_count;
+	uint64_t tick_ns;
+	uint64_t render_count;
+	uint64_t render_ns;
+	uint64_t render_gpu_ns;
+	uint64_t async_upload_count;
+	uint64_t async_upload_ns;
+	uint64_t audio_filter_count;
+	uint64_t audio_filter_ns;
+
+	/* Averages of the last frames, only while the profiler is enabled */
+	bool has_result;
+	uint64_t tick_avg_ns;
+	uint64_t render_avg_ns;
+	uint64_t render_gpu_avg_ns;
+};
+
+struct telemetry_metric {
+	const char *name;
+	const char *json_name;
+	const char *help;
+	size_t offset;
+	bool seconds;
+	bool gauge;
+};
+
+#define METRIC(name, json_name, help, field, seconds, gauge) \
+	{name, json_name, help, offsetof(struct telemetry_sample, field), seconds, gauge}
+
+static const struct telemetry_metric telemetry_metrics[] = {
+	METRIC("obs_source_ticks_total", "ticks", "Number of video ticks", tick_count, false, false),
+	METRIC("obs_source_tick_seconds_total", "tick_ns", "CPU time spent in video ticks", tick_ns, true, false),
+	METRIC("obs_source_renders_total", "renders", "Number of video renders", render_count, false, false),
+	METRIC("obs_source_render_seconds_total", "render_ns",
+	       "CPU time spent in video renders, including anything rendered from within them", render_ns, true,
+	       false),
+	METRIC("obs_source_render_gpu_seconds_total", "render_gpu_ns",
+	       "GPU time spent in video renders, only counted while GPU profiling is enabled", render_gpu_ns, true,
+	       false),
+	METRIC("obs_source_async_uploads_total", "async_uploads", "Number of async frames uploaded to textures",
+	       async_upload_count, false, false),
+	METRIC("obs_source_async_upload_seconds_total", "async_upload_ns",
+	       "CPU time spent uploading async frames to textures", async_upload_ns, true, false),
+	METRIC("obs_source_audio_filter_calls_total", "audio_filter_calls", "Number of audio filter calls",
+	       audio_filter_count, false, false),
+	METRIC("obs_source_audio_filter_seconds_total", "audio_filter_ns", "CPU time spent filtering audio",
+	       audio_filter_ns, true, false),
+	METRIC("obs_source_tick_avg_seconds", "tick_avg_ns", "Average tick time of the last frames", tick_avg_ns, true,
+	       true),
+	METRIC("obs_source_render_avg_seconds", "render_avg_ns", "Average render time of the last frames",
+	       render_avg_ns, true, true),
+	METRIC("obs_source_render_gpu_avg_seconds", "render_gpu_avg_ns", "Average GPU render time of the last frames",
+	       render_gpu_avg_ns, true, true),
+};
+
+#undef METRIC
+
+struct telemetry_export {
+	pthread_t thread;
+	os_event_t *stop_event;
+	char *path;
+	enum profiler_export_format format;
+	uint32_t interval_ms;
+	bool active;
+
+	DARRAY(struct telemetry_sample) samples;
+	struct dstr buffer;
+};
+
+static struct telemetry_export telemetry_export = {0};
+static pthread_mutex_t telemetry_export_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static inline uint64_t metric_value(const struct telemetry_metric *metric, const struct telemetry_sample *sample)
+{
+	return *(const uint64_t *)((const uint8_t *)sample + metric->offset);
+}
+
+static uint64_t get_render_gpu_total(const obs_source_t *source)
+{
+	struct profiler_entry *ent;
+	uint64_t total = 0;
+
+	pthread_rwlock_rdlock(&hm_rwlock);
+	HASH_FIND_PTR(hm_entries, &source, ent);
+	if (ent)
+		total = ent->render_gpu_total;
+	pthread_rwlock_unlock(&hm_rwlock);
+
+	return total;
+}
+
+static bool snapshot_source(void *param, obs_source_t *source)
+{
+	struct telemetry_export *exp = param;
+	struct telemetry_sample sample = {0};
+
+	sample.tick_count = source->tick_telemetry.count;
+	sample.render_count = source->render_telemetry.count;
+	sample.async_upload_count = source->async_upload_telemetry.count;
+	sample.audio_filter_count = source->audio_filter_telemetry.count;
+
+	if (!sample.tick_count && !sample.render_count && !sample.async_upload_count && !sample.audio_filter_count)
+		return true;
+
+	sample.tick_ns = source->tick_telemetry.ns;
+	sample.render_ns = source->render_telemetry.ns;
+	sample.render_gpu_ns = get_render_gpu_total(source);
+	sample.async_upload_ns = source->async_upload_telemetry.ns;
+	sample.audio_filter_ns = source->audio_filter_telemetry.ns;
+
+	profiler_result_t result;
+	if (source_profiler_fill_result(source, &result)) {
+		sample.has_result = true;
+		sample.tick_avg_ns = result.tick_avg;
+		sample.render_avg_ns = result.render_avg;
+		sample.render_gpu_avg_ns = result.render_gpu_avg;
+	}
+
+	sample.name = bstrdup(obs_source_get_name(source));
+	sample.uuid = bstrdup(obs_source_get_uuid(source));
+	sample.type = obs_source_get_id(source);
+
+	da_push_back(exp->samples, &sample);
+	return true;
+}
+
+static void free_samples(struct telemetry_export *exp)
+{
+	for (size_t i = 0; i < exp->samples.num; i++) {
+		bfree(exp->samples.array[i].name);
+		bfree(exp->samples.array[i].uuid);
+	}
+	da_resize(exp->samples, 0);
+}
+
+static void cat_label(struct dstr *str, const char *name, const char *value, bool first)
+{
+	dstr_catf(str, "%s%s=\"", first ? "" : ",", name);
+
+	for (const char *ch = value ? value : ""; *ch; ch++) {
+		if (*ch == '\\')
+			dstr_cat(str, "\\\\");
+		else if (*ch == '"')
+			dstr_cat(str, "\\\"");
+		else if (*ch == '\n')
+			dstr_cat(str, "\\n");
+		else
+			dstr_cat_ch(str, *ch);
+	}
+
+	dstr_cat_ch(str, '"');
+}
+
+static void export_prometheus(struct telemetry_export *exp)
+{
+	struct dstr *str = &exp->buffer;
+
+	dstr_copy(str, "# HELP obs_video_frames_total Number of frames rendered\n"
+		       "# TYPE obs_video_frames_total counter\n");
+	dstr_catf(str, "obs_video_frames_total %" PRIu32 "\n", obs_get_total_frames());
+
+	for (size_t i = 0; i < OBS_COUNTOF(telemetry_metrics); i++) {
+		const struct telemetry_metric *metric = &telemetry_metrics[i];
+		bool header = false;
+
+		for (size_t j = 0; j < exp->samples.num; j++) {
+			const struct telemetry_sample *sample = &exp->samples.array[j];
+			if (metric->gauge && !sample->has_result)
+				continue;
+
+			if (!header) {
+				dstr_catf(str, "# HELP %s %s\n# TYPE %s %s\n", metric->name, metric->help, metric->name,
+					  metric->gauge ? "gauge" : "counter");
+				header = true;
+			}
+
+			const uint64_t value = metric_value(metric, sample);
+
+			dstr_catf(str, "%s{", metric->name);
+			cat_label(str, "source", sample->name, true);
+			cat_label(str, "uuid", sample->uuid, false);
+			cat_label(str, "type", sample->type, false);
+
+			if (metric->seconds)
+				dstr_catf(str, "} %.9f\n", (double)value / 1000000000.0);
+			else
+				dstr_catf(str, "} %" PRIu64 "\n", value);
+		}
+	}
+
+	if (!os_quick_write_utf8_file_safe(exp->path, str->array, str->len, false, "tmp", NULL))
+		blog(LOG_WARNING, "Failed to write source telemetry to '%s'", exp->path);
+}
+
+static void export_json(struct telemetry_export *exp)
+{
+	const int64_t timestamp = (int64_t)time(NULL);
+	const int64_t frame = (int64_t)obs_get_total_frames();
+	struct dstr *str = &exp->buffer;
+
+	dstr_free(str);
+
+	for (size_t i = 0; i < exp->samples.num; i++) {
+		const struct telemetry_sample *sample = &exp->samples.array[i];
+		obs_data_t *data = obs_data_create();
+
+		obs_data_set_int(data, "time", timestamp);
+		obs_data_set_int(data, "frame", frame);
+		obs_data_set_string(data, "source", sample->name ? sample->name : "");
+		obs_data_set_string(data, "uuid", sample->uuid);
+		obs_data_set_string(data, "type", sample->type);
+
+		for (size_t j = 0; j < OBS_COUNTOF(telemetry_metrics); j++) {
+			const struct telemetry_metric *metric = &telemetry_metrics[j];
+			if (!metric->gauge || sample->has_result)
+				obs_data_set_int(data, metric->json_name, (long long)metric_value(metric, sample));
+		}
+
+		dstr_cat(str, obs_data_get_json(data));
+		dstr_cat_ch(str, '\n');
+		obs_data_release(data);
+	}
+
+	if (!str->len)
+		return;
+
+	FILE *file = os_fopen(exp->path, "ab");
+	if (!file || fwrite(str->array, 1, str->len, file) != str->len)
+		blog(LOG_WARNING, "Failed to write source telemetry to '%s'", exp->path);
+	if (file)
+		fclose(file);
+}
+
+static void *telemetry_export_thread(void *param)
+{
+	struct telemetry_export *exp = param;
+
+	os_set_thread_name("source-profiler: telemetry export");
+
+	while (os_event_timedwait(exp->stop_event, exp->interval_ms) == ETIMEDOUT) {
+		obs_enum_all_sources(snapshot_source, exp);
+
+		if (exp->format == PROFILER_EXPORT_JSON)
+			export_json(exp);
+		else
+			export_prometheus(exp);
+
+		free_samples(exp);
+	}
+
+	return NULL;
+}
+
+bool source_profiler_export_start(const char *path, enum profiler_export_format format, uint32_t interval_ms)
+{
+	struct telemetry_export *exp = &telemetry_export;
+	bool success = false;
+
+	if (!path || !*path || !interval_ms)
+		return false;
+
+	pthread_mutex_lock(&telemetry_export_mutex);
+
+	if (exp->active)
+		goto finish;
+	if (os_event_init(&exp->stop_event, OS_EVENT_TYPE_MANUAL) != 0)
+		goto finish;
+
+	exp->path = bstrdup(path);
+	exp->format = format;
+	exp->interval_ms = interval_ms;
+	telemetry_enabled = true;
+
+	if (pthread_create(&exp->thread, NULL, telemetry_export_thread, exp) != 0) {
+		telemetry_enabled = false;
+		os_event_destroy(exp->stop_event);
+		bfree(exp->path);
+		exp->stop_event = NULL;
+		exp->path = NULL;
+		goto finish;
+	}
+
+	exp->active = true;
+	success = true;
+
+	blog(LOG_INFO, "Exporting source telemetry to '%s' every %" PRIu32 " ms (%s)", path, interval_ms,
+	     format == PROFILER_EXPORT_JSON ? "NDJSON" : "Prometheus");
+
+finish:
+	pthread_mutex_unlock(&telemetry_export_mutex);
+	return success;
+}
+
+void source_profiler_export_stop(void)
+{
+	struct telemetry_export *exp = &telemetry_export;
+
+	pthread_mutex_lock(&telemetry_export_mutex);
+
+	if (exp->active) {
+		os_event_signal(exp->stop_event);
+		pthread_join(exp->thread, NULL);
+		os_event_destroy(exp->stop_event);
+
+		telemetry_enabled = false;
+
+		da_free(exp->samples);
+		dstr_free(&exp->buffer);
+		bfree(exp->path);
+		memset(exp, 0, sizeof(*exp));
+	}
+
+	pthread_mutex_unlock(&telemetry_export_mutex);
+}
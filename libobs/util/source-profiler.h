@@ -49,8 +49,43 @@ typedef struct profiler_result {
 	uint64_t async_input_worst;
 	uint64_t async_rendered_best;
 	uint64_t async_rendered_worst;
+
+	/* Scene item transforms recomputed per frame (scenes/groups only) */
+	uint64_t transform_updates_avg;
+	uint64_t transform_updates_max;
+	/* Scene items skipped because they were off-canvas (scenes only) */
+	uint64_t items_culled_avg;
+
+	/* Number of times cached filter output was reused/re-rendered
+	 * (OBS_SOURCE_CACHEABLE sources only) */
+	uint64_t render_cache_hits;
+	uint64_t render_cache_misses;
+
+	/* Time from queueing a compressed async frame to its output in ns,
+	 * and frames queued or decoding at the time (as reported by sources
+	 * via source_profiler_async_frame_decoded) */
+	uint64_t decode_latency_avg;
+	uint64_t decode_latency_max;
+	uint64_t decode_queue_depth_avg;
+	uint64_t decode_queue_depth_max;
 } profiler_result_t;
 
+typedef struct profiler_client_result {
+	/* Average and max time reported per frame in ns */
+	uint64_t time_avg;
+	uint64_t time_max;
+
+	/* Events reported within the sampled timeframe */
+	uint64_t events;
+} profiler_client_result_t;
+
+enum profiler_export_format {
+	/* Prometheus text format, the file is replaced on every export */
+	PROFILER_EXPORT_PROMETHEUS,
+	/* One JSON object per source per export, appended to the file */
+	PROFILER_EXPORT_JSON,
+};
+
 /* Enable/disable profiler (applied on next frame) */
 EXPORT void source_profiler_enable(bool enable);
 /* Enable/disable GPU profiling (applied on next frame) */
@@ -61,6 +96,26 @@ EXPORT profiler_result_t *source_profiler_get_result(obs_source_t *source);
 /* Update existing profiler results object for source */
 EXPORT bool source_profiler_fill_result(obs_source_t *source, profiler_result_t *result);
 
+/* Report a decoded async frame, for sources that decode on their own
+ * threads (thread-safe) */
+EXPORT void source_profiler_async_frame_decoded(obs_source_t *source, uint64_t latency_ns, uint32_t queue_depth);
+
+/* Report time spent on behalf of something that is not a source, such as a
+ * script, keyed by its address (thread-safe) */
+EXPORT void source_profiler_client_time(const void *client, uint64_t time_ns, uint32_t events);
+/* Update existing profiler results object for client */
+EXPORT bool source_profiler_fill_client_result(const void *client, profiler_client_result_t *result);
+/* Remove a client's results, e.g. when it is destroyed (thread-safe) */
+EXPORT void source_profiler_remove_client(const void *client);
+
+/* Start periodically writing cumulative per-source tick, render, async upload
+ * and audio filter costs to a file (independent of the profiler being
+ * enabled). Returns false if an export is already running. */
+EXPORT bool source_profiler_export_start(const char *path, enum profiler_export_format format,
+					 uint32_t interval_ms);
+/* Stop the telemetry export, if running */
+EXPORT void source_profiler_export_stop(void);
+
 #ifdef __cplusplus
 }
 #endif
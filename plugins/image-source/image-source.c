@@ -5,6 +5,8 @@
 #include <util/dstr.h>
 #include <sys/stat.h>
 
+#include "slide-cache.h"
+
 #define blog(log_level, format, ...) \
 	blog(log_level, "[image_source: '%s'] " format, obs_source_get_name(context->source), ##__VA_ARGS__)
 
@@ -27,6 +29,12 @@ struct image_source {
 	volatile bool file_decoded;
 	volatile bool texture_loaded;
 
+	/* slides are decoded by the slide cache, no larger than needed */
+	uint32_t slide_max_cx;
+	uint32_t slide_max_cy;
+	volatile bool decode_pending;
+	uint64_t slide_mem_usage;
+
 	gs_image_file4_t if4;
 };
 
@@ -44,6 +52,95 @@ static const char *image_source_get_name(void *unused)
 	return obs_module_text("ImageInput");
 }
 
+static inline bool is_8bit_rgba(enum gs_color_format format)
+{
+	switch (format) {
+	case GS_RGBA:
+	case GS_BGRA:
+	case GS_BGRX:
+	case GS_RGBA_UNORM:
+	case GS_BGRA_UNORM:
+	case GS_BGRX_UNORM:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* Box filter, averaging every source pixel that falls into a destination
+ * pixel.  Alpha is already premultiplied, so channels can be averaged
+ * independently. */
+static uint8_t *downscale_image(const uint8_t *src, uint32_t src_cx, uint32_t src_cy, uint32_t dst_cx,
+				uint32_t dst_cy)
+{
+	uint8_t *dst = bmalloc((size_t)dst_cx * dst_cy * 4);
+	uint32_t *sums = bmalloc((size_t)src_cx * 4 * sizeof(uint32_t));
+
+	for (uint32_t dy = 0; dy < dst_cy; dy++) {
+		const uint32_t y0 = (uint32_t)((uint64_t)dy * src_cy / dst_cy);
+		const uint32_t y1 = (uint32_t)((uint64_t)(dy + 1) * src_cy / dst_cy);
+		uint8_t *out = dst + (size_t)dy * dst_cx * 4;
+
+		memset(sums, 0, (size_t)src_cx * 4 * sizeof(uint32_t));
+		for (uint32_t y = y0; y < y1; y++) {
+			const uint8_t *row = src + (size_t)y * src_cx * 4;
+			for (size_t i = 0; i < (size_t)src_cx * 4; i++)
+				sums[i] += row[i];
+		}
+
+		for (uint32_t dx = 0; dx < dst_cx; dx++) {
+			const uint32_t x0 = (uint32_t)((uint64_t)dx * src_cx / dst_cx);
+			const uint32_t x1 = (uint32_t)((uint64_t)(dx + 1) * src_cx / dst_cx);
+			const uint64_t count = (uint64_t)(x1 - x0) * (y1 - y0);
+
+			for (uint32_t c = 0; c < 4; c++) {
+				uint64_t sum = 0;
+				for (uint32_t x = x0; x < x1; x++)
+					sum += sums[x * 4 + c];
+				out[dx * 4 + c] = (uint8_t)((sum + count / 2) / count);
+			}
+		}
+	}
+
+	bfree(sums);
+	return dst;
+}
+
+/* Slides are drawn scaled to fit the slideshow, so there is no point in
+ * keeping more pixels around than the slideshow can show */
+static void downscale_slide(struct image_source *context)
+{
+	struct gs_image_file *image = &context->if4.image3.image2.image;
+	uint32_t cx = image->cx;
+	uint32_t cy = image->cy;
+
+	if (!image->loaded || image->is_animated_gif || !image->texture_data || !is_8bit_rgba(image->format))
+		return;
+	if (!context->slide_max_cx || !context->slide_max_cy)
+		return;
+	if (cx <= context->slide_max_cx && cy <= context->slide_max_cy)
+		return;
+
+	if ((uint64_t)cx * context->slide_max_cy > (uint64_t)cy * context->slide_max_cx) {
+		cy = (uint32_t)(((uint64_t)cy * context->slide_max_cx + cx / 2) / cx);
+		cx = context->slide_max_cx;
+	} else {
+		cx = (uint32_t)(((uint64_t)cx * context->slide_max_cy + cy / 2) / cy);
+		cy = context->slide_max_cy;
+	}
+	if (!cx)
+		cx = 1;
+	if (!cy)
+		cy = 1;
+
+	uint8_t *data = downscale_image(image->texture_data, image->cx, image->cy, cx, cy);
+	bfree(image->texture_data);
+	image->texture_data = data;
+	image->cx = cx;
+	image->cy = cy;
+	context->if4.image3.image2.mem_usage = (uint64_t)cx * cy * 4;
+}
+
 void image_source_preload_image(void *data)
 {
 	struct image_source *context = data;
@@ -53,9 +150,38 @@ void image_source_preload_image(void *data)
 	context->file_timestamp = get_modified_timestamp(context->file);
 	gs_image_file4_init(&context->if4, context->file,
 			    context->linear_alpha ? GS_IMAGE_ALPHA_PREMULTIPLY_SRGB : GS_IMAGE_ALPHA_PREMULTIPLY);
+	if (context->is_slide)
+		downscale_slide(context);
 	os_atomic_set_bool(&context->file_decoded, true);
 }
 
+/* Called by the slide cache with its lock held, so a slide is only ever
+ * queued once */
+bool image_source_begin_slide_decode(void *data)
+{
+	struct image_source *context = data;
+
+	if (os_atomic_load_bool(&context->file_decoded) || os_atomic_load_bool(&context->decode_pending))
+		return false;
+
+	os_atomic_set_bool(&context->decode_pending, true);
+	return true;
+}
+
+void image_source_decode_slide(void *data)
+{
+	struct image_source *context = data;
+
+	image_source_preload_image(context);
+	os_atomic_set_bool(&context->decode_pending, false);
+}
+
+bool image_source_slide_loaded(void *data)
+{
+	struct image_source *context = data;
+	return os_atomic_load_bool(&context->texture_loaded);
+}
+
 static void image_source_load_texture(void *data)
 {
 	struct image_source *context = data;
@@ -70,8 +196,14 @@ static void image_source_load_texture(void *data)
 
 	if (!context->if4.image3.image2.image.loaded)
 		warn("failed to load texture '%s'", context->file);
+
+	if (context->is_slide) {
+		context->slide_mem_usage = context->if4.image3.image2.mem_usage;
+		slide_cache_add_memory((int64_t)context->slide_mem_usage);
+	}
 	context->update_time_elapsed = 0;
 	os_atomic_set_bool(&context->texture_loaded, true);
+	obs_source_invalidate_render_cache(context->source);
 }
 
 static void image_source_unload(void *data)
@@ -83,6 +215,26 @@ static void image_source_unload(void *data)
 	obs_enter_graphics();
 	gs_image_file4_free(&context->if4);
 	obs_leave_graphics();
+
+	if (context->slide_mem_usage) {
+		slide_cache_add_memory(-(int64_t)context->slide_mem_usage);
+		context->slide_mem_usage = 0;
+	}
+
+	obs_source_invalidate_render_cache(context->source);
+}
+
+/* Drops the texture of a slide that is no longer likely to be shown soon.
+ * It is decoded again when the slideshow requests it. */
+bool image_source_evict_slide(void *data)
+{
+	struct image_source *context = data;
+
+	if (!os_atomic_load_bool(&context->texture_loaded) || os_atomic_load_bool(&context->decode_pending))
+		return false;
+
+	image_source_unload(context);
+	return true;
 }
 
 static void image_source_load(struct image_source *context)
@@ -109,6 +261,8 @@ static void image_source_update(void *data, obs_data_t *settings)
 	context->persistent = !unload;
 	context->linear_alpha = linear_alpha;
 	context->is_slide = is_slide;
+	context->slide_max_cx = (uint32_t)obs_data_get_int(settings, "slide_max_width");
+	context->slide_max_cy = (uint32_t)obs_data_get_int(settings, "slide_max_height");
 
 	if (is_slide)
 		return;
@@ -155,6 +309,7 @@ static void restart_gif(void *data)
 		gs_image_file4_update_texture(&context->if4);
 		obs_leave_graphics();
 
+		obs_source_invalidate_render_cache(context->source);
 		context->restart_gif = false;
 	}
 }
@@ -276,6 +431,8 @@ static void image_source_tick(void *data, float seconds)
 			obs_enter_graphics();
 			gs_image_file4_update_texture(&context->if4);
 			obs_leave_graphics();
+
+			obs_source_invalidate_render_cache(context->source);
 		}
 	}
 
@@ -363,7 +520,7 @@ static enum gs_color_space image_source_get_color_space(void *data, size_t count
 static struct obs_source_info image_source_info = {
 	.id = "image_source",
 	.type = OBS_SOURCE_TYPE_INPUT,
-	.output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_SRGB,
+	.output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_SRGB | OBS_SOURCE_CACHEABLE,
 	.get_name = image_source_get_name,
 	.create = image_source_create,
 	.destroy = image_source_destroy,
@@ -405,3 +562,8 @@ bool obs_module_load(void)
 	obs_register_source(&slideshow_info_mk2);
 	return true;
 }
+
+void obs_module_unload(void)
+{
+	slide_cache_free();
+}
@@ -4,10 +4,11 @@
 #include <util/platform.h>
 #include <util/darray.h>
 #include <util/dstr.h>
-#include <util/task.h>
 
 #include <inttypes.h>
 
+#include "slide-cache.h"
+
 #define do_log(level, format, ...) \
 	blog(level, "[slideshow: '%s'] " format, obs_source_get_name(ss->source), ##__VA_ARGS__)
 
@@ -67,7 +68,8 @@ static const char *TR_SLIDE                  = "slide";
 
 /* clang-format on */
 
-extern void image_source_preload_image(void *data);
+extern bool image_source_slide_loaded(void *data);
+extern bool image_source_evict_slide(void *data);
 
 /* ------------------------------------------------------------------------- */
 
@@ -90,6 +92,10 @@ enum behavior {
 };
 
 #define SLIDE_BUFFER_COUNT 5
+#define MAX_ACTIVE_SLIDES (SLIDE_BUFFER_COUNT * 2 + 1)
+
+/* the current slide, the next one and the one just shown are always kept */
+#define MIN_READY_SLIDES 3
 
 struct active_slides {
 	struct deque prev;
@@ -124,10 +130,10 @@ struct slideshow {
 	obs_source_t *source;
 
 	struct slideshow_data data;
-	os_task_queue_t *queue;
 	obs_source_t *transition;
 	uint32_t cx;
 	uint32_t cy;
+	size_t ready_limit;
 
 	obs_hotkey_id play_pause_hotkey;
 	obs_hotkey_id restart_hotkey;
@@ -280,19 +286,6 @@ static inline struct source_data *deque_get_source(struct deque *buf, size_t sli
 	return NULL;
 }
 
-static void decode_image(void *data)
-{
-	obs_weak_source_t *weak = data;
-
-	obs_source_t *source = obs_weak_source_get_source(weak);
-	if (source) {
-		image_source_preload_image(obs_obj_get_data(source));
-		obs_source_release(source);
-	}
-
-	obs_weak_source_release(weak);
-}
-
 /* creates source from a file path. only used in get_new_source(). */
 static inline obs_source_t *create_source_from_file(struct slideshow *ss, const char *file, bool now)
 {
@@ -302,11 +295,13 @@ static inline obs_source_t *create_source_from_file(struct slideshow *ss, const
 	obs_data_set_string(settings, "file", file);
 	obs_data_set_bool(settings, "unload", false);
 	obs_data_set_bool(settings, "is_slide", !now);
+	obs_data_set_int(settings, "slide_max_width", ss->cx);
+	obs_data_set_int(settings, "slide_max_height", ss->cy);
 	source = obs_source_create_private("image_source", NULL, settings);
 
 	obs_data_release(settings);
 
-	os_task_queue_queue_task(ss->queue, decode_image, obs_source_get_weak_source(source));
+	slide_cache_request(source);
 
 	return source;
 }
@@ -405,6 +400,82 @@ static void restart_slides(struct slideshow *ss)
 	ssd->slides = new_slides;
 }
 
+/* lists the active slides from most to least likely to be shown next */
+static size_t get_slides_by_priority(struct active_slides *slides, obs_source_t **out)
+{
+	const size_t prev_count = slides->prev.size / sizeof(struct source_data);
+	const size_t next_count = slides->next.size / sizeof(struct source_data);
+	obs_source_t *candidates[MAX_ACTIVE_SLIDES];
+	size_t num_candidates = 0;
+	size_t num = 0;
+	struct source_data *sd;
+
+	if (!slides->cur.source)
+		return 0;
+
+	candidates[num_candidates++] = slides->cur.source;
+	if (next_count) {
+		sd = deque_data(&slides->next, 0);
+		candidates[num_candidates++] = sd->source;
+	}
+	if (prev_count) {
+		sd = deque_data(&slides->prev, (prev_count - 1) * sizeof(*sd));
+		candidates[num_candidates++] = sd->source;
+	}
+	for (size_t i = 1; i < next_count && i < SLIDE_BUFFER_COUNT; i++) {
+		sd = deque_data(&slides->next, i * sizeof(*sd));
+		candidates[num_candidates++] = sd->source;
+	}
+	for (size_t i = 1; i < prev_count && i < SLIDE_BUFFER_COUNT; i++) {
+		sd = deque_data(&slides->prev, (prev_count - 1 - i) * sizeof(*sd));
+		candidates[num_candidates++] = sd->source;
+	}
+
+	/* short file lists reuse the same source in several places */
+	for (size_t i = 0; i < num_candidates; i++) {
+		bool found = false;
+		for (size_t j = 0; j < num && !found; j++)
+			found = out[j] == candidates[i];
+		if (!found)
+			out[num++] = candidates[i];
+	}
+
+	return num;
+}
+
+/* Keeps the slides most likely to be shown next decoded, and drops the
+ * least likely ones while the slide cache is over its memory budget */
+static void update_ready_slides(struct slideshow *ss)
+{
+	obs_source_t *slides[MAX_ACTIVE_SLIDES];
+	const size_t num = get_slides_by_priority(&ss->data.slides, slides);
+	const uint64_t budget = slide_cache_get_budget();
+	uint64_t memory = slide_cache_get_memory();
+
+	if (memory > budget) {
+		for (size_t i = num; i > MIN_READY_SLIDES && memory > budget; i--) {
+			if (image_source_evict_slide(obs_obj_get_data(slides[i - 1]))) {
+				slide_cache_record_evicted();
+				memory = slide_cache_get_memory();
+				if (ss->ready_limit > i - 1)
+					ss->ready_limit = i - 1;
+			}
+		}
+	} else if (memory < budget / 2 && ss->ready_limit < MAX_ACTIVE_SLIDES) {
+		ss->ready_limit++;
+	}
+
+	for (size_t i = 0; i < num && (i < MIN_READY_SLIDES || i < ss->ready_limit); i++)
+		slide_cache_request(slides[i]);
+}
+
+static inline void record_shown_slide(struct slideshow *ss)
+{
+	obs_source_t *source = ss->data.slides.cur.source;
+	if (source)
+		slide_cache_record_shown(image_source_slide_loaded(obs_obj_get_data(source)));
+}
+
 static void ss_update(void *data, obs_data_t *settings)
 {
 	struct slideshow *ss = data;
@@ -562,13 +633,13 @@ static void ss_update(void *data, obs_data_t *settings)
 	/* ------------------------------------- */
 	/* update files                          */
 
+	ss->cx = cx;
+	ss->cy = cy;
 	restart_slides(ss);
 
 	/* ------------------------------------- */
 	/* restart transition                    */
 
-	ss->cx = cx;
-	ss->cy = cy;
 	obs_transition_set_size(ss->transition, cx, cy);
 	obs_transition_set_alignment(ss->transition, OBS_ALIGN_CENTER);
 	obs_transition_set_scale_type(ss->transition, OBS_TRANSITION_SCALE_ASPECT);
@@ -659,6 +730,7 @@ static void ss_next_slide(void *data)
 	deque_pop_front(&slides->prev, &sd, sizeof(sd));
 	free_source_data(&sd);
 
+	record_shown_slide(ss);
 	do_transition(ss, false);
 }
 
@@ -689,6 +761,7 @@ static void ss_previous_slide(void *data)
 	deque_pop_back(&slides->next, &sd, sizeof(sd));
 	free_source_data(&sd);
 
+	record_shown_slide(ss);
 	do_transition(ss, false);
 }
 
@@ -769,7 +842,6 @@ static void ss_destroy(void *data)
 {
 	struct slideshow *ss = data;
 
-	os_task_queue_destroy(ss->queue);
 	obs_source_release(ss->transition);
 	free_slideshow_data(&ss->data);
 	bfree(ss);
@@ -785,8 +857,7 @@ static void *ss_create(obs_data_t *settings, obs_source_t *source)
 	ss->data.manual = false;
 	ss->data.paused = false;
 	ss->data.stop = false;
-
-	ss->queue = os_task_queue_create();
+	ss->ready_limit = MAX_ACTIVE_SLIDES;
 
 	ss->play_pause_hotkey = obs_hotkey_register_source(
 		source, "SlideShow.PlayPause", obs_module_text("SlideShow.PlayPause"), play_pause_hotkey, ss);
@@ -837,6 +908,8 @@ static void ss_video_tick(void *data, float seconds)
 	if (!ss->transition || !ssd->slide_time)
 		return;
 
+	update_ready_slides(ss);
+
 	if (ssd->restart_on_activate && ssd->use_cut) {
 		ssd->elapsed = 0.0f;
 		restart_slides(ss);
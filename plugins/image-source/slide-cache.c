@@ -0,0 +1,214 @@
+#include <util/threading.h>
+#include <util/platform.h>
+#include <util/darray.h>
+#include <util/deque.h>
+
+#include <inttypes.h>
+
+#include "slide-cache.h"
+
+#define MAX_WORKERS 4
+#define MEMORY_BUDGET (512ULL * 1024 * 1024)
+
+extern bool image_source_begin_slide_decode(void *data);
+extern void image_source_decode_slide(void *data);
+
+struct slide_cache {
+	pthread_mutex_t mutex;
+	os_sem_t *sem;
+	struct deque queue;
+	DARRAY(pthread_t) workers;
+	bool started;
+	bool stop;
+
+	uint64_t memory;
+
+	uint64_t decoded;
+	uint64_t decode_ns_total;
+	uint64_t decode_ns_max;
+	uint64_t shown;
+	uint64_t shown_ready;
+	uint64_t evicted;
+};
+
+static struct slide_cache cache = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+
+static void *decode_thread(void *unused)
+{
+	UNUSED_PARAMETER(unused);
+
+	os_set_thread_name("slideshow: decode");
+
+	for (;;) {
+		obs_weak_source_t *weak = NULL;
+		obs_source_t *source;
+		uint64_t start;
+		uint64_t elapsed;
+
+		os_sem_wait(cache.sem);
+
+		pthread_mutex_lock(&cache.mutex);
+		if (cache.stop) {
+			pthread_mutex_unlock(&cache.mutex);
+			break;
+		}
+		if (cache.queue.size)
+			deque_pop_front(&cache.queue, &weak, sizeof(weak));
+		pthread_mutex_unlock(&cache.mutex);
+
+		source = obs_weak_source_get_source(weak);
+		obs_weak_source_release(weak);
+		if (!source)
+			continue;
+
+		start = os_gettime_ns();
+		image_source_decode_slide(obs_obj_get_data(source));
+		elapsed = os_gettime_ns() - start;
+
+		obs_source_release(source);
+
+		pthread_mutex_lock(&cache.mutex);
+		cache.decoded++;
+		cache.decode_ns_total += elapsed;
+		if (elapsed > cache.decode_ns_max)
+			cache.decode_ns_max = elapsed;
+		pthread_mutex_unlock(&cache.mutex);
+	}
+
+	return NULL;
+}
+
+/* Must be called with the mutex held */
+static bool start_workers(void)
+{
+	int num_workers = os_get_logical_cores() - 1;
+
+	if (num_workers < 1)
+		num_workers = 1;
+	if (num_workers > MAX_WORKERS)
+		num_workers = MAX_WORKERS;
+
+	if (os_sem_init(&cache.sem, 0) != 0)
+		return false;
+
+	for (int i = 0; i < num_workers; i++) {
+		pthread_t thread;
+
+		if (pthread_create(&thread, NULL, decode_thread, NULL) != 0)
+			break;
+		da_push_back(cache.workers, &thread);
+	}
+
+	if (!cache.workers.num) {
+		os_sem_destroy(cache.sem);
+		cache.sem = NULL;
+		return false;
+	}
+
+	cache.started = true;
+	return true;
+}
+
+void slide_cache_request(obs_source_t *image_source)
+{
+	obs_weak_source_t *weak;
+
+	if (!image_source)
+		return;
+
+	pthread_mutex_lock(&cache.mutex);
+
+	if (!cache.started && !start_workers()) {
+		pthread_mutex_unlock(&cache.mutex);
+		blog(LOG_WARNING, "[slideshow] Failed to start decode threads");
+		return;
+	}
+
+	if (!image_source_begin_slide_decode(obs_obj_get_data(image_source))) {
+		pthread_mutex_unlock(&cache.mutex);
+		return;
+	}
+
+	weak = obs_source_get_weak_source(image_source);
+	deque_push_back(&cache.queue, &weak, sizeof(weak));
+
+	pthread_mutex_unlock(&cache.mutex);
+
+	os_sem_post(cache.sem);
+}
+
+void slide_cache_add_memory(int64_t bytes)
+{
+	pthread_mutex_lock(&cache.mutex);
+	if (bytes < 0 && (uint64_t)-bytes > cache.memory)
+		cache.memory = 0;
+	else
+		cache.memory += bytes;
+	pthread_mutex_unlock(&cache.mutex);
+}
+
+uint64_t slide_cache_get_memory(void)
+{
+	uint64_t memory;
+
+	pthread_mutex_lock(&cache.mutex);
+	memory = cache.memory;
+	pthread_mutex_unlock(&cache.mutex);
+
+	return memory;
+}
+
+uint64_t slide_cache_get_budget(void)
+{
+	return MEMORY_BUDGET;
+}
+
+void slide_cache_record_shown(bool ready)
+{
+	pthread_mutex_lock(&cache.mutex);
+	cache.shown++;
+	if (ready)
+		cache.shown_ready++;
+	pthread_mutex_unlock(&cache.mutex);
+}
+
+void slide_cache_record_evicted(void)
+{
+	pthread_mutex_lock(&cache.mutex);
+	cache.evicted++;
+	pthread_mutex_unlock(&cache.mutex);
+}
+
+void slide_cache_free(void)
+{
+	pthread_mutex_lock(&cache.mutex);
+	cache.stop = true;
+	pthread_mutex_unlock(&cache.mutex);
+
+	for (size_t i = 0; i < cache.workers.num; i++)
+		os_sem_post(cache.sem);
+	for (size_t i = 0; i < cache.workers.num; i++)
+		pthread_join(cache.workers.array[i], NULL);
+
+	while (cache.queue.size) {
+		obs_weak_source_t *weak;
+		deque_pop_front(&cache.queue, &weak, sizeof(weak));
+		obs_weak_source_release(weak);
+	}
+
+	if (cache.decoded) {
+		blog(LOG_INFO,
+		     "[slideshow] Decoded %" PRIu64 " images (%.1f ms average, %.1f ms max), %" PRIu64 " of %" PRIu64
+		     " slides ready when shown, %" PRIu64 " evicted",
+		     cache.decoded, (double)cache.decode_ns_total / (double)cache.decoded / 1000000.0,
+		     (double)cache.decode_ns_max / 1000000.0, cache.shown_ready, cache.shown, cache.evicted);
+	}
+
+	deque_free(&cache.queue);
+	da_free(cache.workers);
+	if (cache.sem)
+		os_sem_destroy(cache.sem);
+	cache.sem = NULL;
+	cache.started = false;
+	cache.stop = false;
+}
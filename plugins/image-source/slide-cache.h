@@ -0,0 +1,24 @@
+#pragma once
+
+#include <obs-module.h>
+
+/*
+ * Decodes slideshow images on a pool of worker threads shared by every
+ * slideshow, and keeps track of how much memory the textures of loaded
+ * slides take up, so slideshows can drop the slides they are least likely
+ * to show next once the budget is exceeded.
+ */
+
+/* Queues the image source for decoding unless it is decoded or queued
+ * already.  Only a weak reference is kept while the decode is pending. */
+extern void slide_cache_request(obs_source_t *image_source);
+
+/* Accounts for slide textures being loaded (> 0) or unloaded (< 0) */
+extern void slide_cache_add_memory(int64_t bytes);
+extern uint64_t slide_cache_get_memory(void);
+extern uint64_t slide_cache_get_budget(void);
+
+extern void slide_cache_record_shown(bool ready);
+extern void slide_cache_record_evicted(void);
+
+extern void slide_cache_free(void);
@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdio.h>
 #include <stdlib.h>
 #include <inttypes.h>
+#include <xcb/damage.h>
 #include <xcb/randr.h>
 #include <xcb/shm.h>
 #include <xcb/xfixes.h>
@@ -34,6 +35,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #define INVALID_DISPLAY (-1)
 
+/* Past this many damaged rectangles, or this share of the screen, a single
+ * full capture is cheaper than a round of small ones */
+#define MAX_DAMAGE_RECTS 32
+#define MAX_DAMAGE_AREA_PERCENT 50
+
 struct xshm_data {
 	obs_source_t *source;
 
@@ -65,6 +71,17 @@ struct xshm_data {
 	bool use_xinerama;
 	bool use_randr;
 	bool advanced;
+
+	bool use_damage;
+	uint8_t damage_event;
+	xcb_damage_damage_t damage;
+	xcb_xfixes_region_t damage_region;
+	bool damaged;
+	bool full_capture;
+
+	uint64_t full_uploads;
+	uint64_t partial_uploads;
+	uint64_t partial_pixels;
 };
 
 /**
@@ -102,6 +119,212 @@ static bool xshm_check_extensions(xcb_connection_t *xcb)
 	return ok;
 }
 
+/**
+ * Start tracking which parts of the root window change
+ *
+ * Falls back to capturing the whole screen on every tick if the xserver
+ * does not support the damage extension.
+ */
+static void xshm_init_damage(struct xshm_data *data)
+{
+	const xcb_query_extension_reply_t *ext;
+	xcb_damage_query_version_reply_t *ver;
+
+	data->use_damage = false;
+	data->full_capture = true;
+
+	ext = xcb_get_extension_data(data->xcb, &xcb_damage_id);
+	if (!ext || !ext->present) {
+		blog(LOG_INFO, "Missing Damage extension, capturing full frames");
+		return;
+	}
+
+	ver = xcb_damage_query_version_reply(data->xcb,
+					     xcb_damage_query_version_unchecked(data->xcb, XCB_DAMAGE_MAJOR_VERSION,
+										XCB_DAMAGE_MINOR_VERSION),
+					     NULL);
+	if (!ver) {
+		blog(LOG_INFO, "Failed to query Damage version, capturing full frames");
+		return;
+	}
+	free(ver);
+
+	data->damage_event = ext->first_event + XCB_DAMAGE_NOTIFY;
+
+	/* the xfixes version was already negotiated by the cursor */
+	data->damage_region = xcb_generate_id(data->xcb);
+	xcb_xfixes_create_region(data->xcb, data->damage_region, 0, NULL);
+
+	data->damage = xcb_generate_id(data->xcb);
+	xcb_damage_create(data->xcb, data->damage, data->xcb_screen->root, XCB_DAMAGE_REPORT_LEVEL_NON_EMPTY);
+
+	data->use_damage = true;
+}
+
+/**
+ * Collect damage notifications received since the last tick
+ *
+ * @return true if anything on the root window changed
+ */
+static bool xshm_poll_damage(struct xshm_data *data)
+{
+	xcb_generic_event_t *event;
+
+	while ((event = xcb_poll_for_event(data->xcb))) {
+		if ((event->response_type & ~0x80) == data->damage_event)
+			data->damaged = true;
+		free(event);
+	}
+
+	return data->damaged;
+}
+
+/**
+ * Upload a rectangle that was fetched into the shm segment at offset
+ *
+ * @return false if the graphics subsystem can't update part of a texture
+ * @note requires to be called within the obs graphics context
+ */
+static bool xshm_upload_rect(struct xshm_data *data, const xcb_rectangle_t *rect, size_t offset)
+{
+	return gs_texture_set_image_rect(data->texture, data->xshm->data + offset, rect->width * 4, rect->x, rect->y,
+					 rect->width, rect->height);
+}
+
+/**
+ * Fetch and upload the whole capture area
+ */
+static bool xshm_capture_full(struct xshm_data *data)
+{
+	xcb_shm_get_image_cookie_t img_c;
+	xcb_shm_get_image_reply_t *img_r;
+
+	img_c = xcb_shm_get_image_unchecked(data->xcb, data->xcb_screen->root, data->adj_x_org, data->adj_y_org,
+					    data->adj_width, data->adj_height, ~0, XCB_IMAGE_FORMAT_Z_PIXMAP,
+					    data->xshm->seg, 0);
+
+	img_r = xcb_shm_get_image_reply(data->xcb, img_c, NULL);
+	if (!img_r)
+		return false;
+
+	obs_enter_graphics();
+	gs_texture_set_image(data->texture, (void *)data->xshm->data, data->adj_width * 4, false);
+	obs_leave_graphics();
+
+	free(img_r);
+	data->full_uploads++;
+	return true;
+}
+
+/**
+ * Take the damaged region and clip it to the capture area
+ *
+ * @return number of rectangles in capture coordinates, or -1 if the whole
+ *         capture area should be fetched instead
+ */
+static int xshm_get_damage(struct xshm_data *data, xcb_rectangle_t *rects)
+{
+	xcb_xfixes_fetch_region_reply_t *region_r;
+	xcb_rectangle_t *damaged;
+	int num_damaged;
+	int num = 0;
+	int64_t area = 0;
+
+	data->damaged = false;
+	xcb_damage_subtract(data->xcb, data->damage, XCB_NONE, data->damage_region);
+
+	region_r = xcb_xfixes_fetch_region_reply(data->xcb, xcb_xfixes_fetch_region_unchecked(data->xcb,
+											   data->damage_region),
+						 NULL);
+	if (!region_r)
+		return -1;
+
+	damaged = xcb_xfixes_fetch_region_rectangles(region_r);
+	num_damaged = xcb_xfixes_fetch_region_rectangles_length(region_r);
+
+	for (int i = 0; i < num_damaged; i++) {
+		int_fast32_t x1 = damaged[i].x - data->adj_x_org;
+		int_fast32_t y1 = damaged[i].y - data->adj_y_org;
+		int_fast32_t x2 = x1 + damaged[i].width;
+		int_fast32_t y2 = y1 + damaged[i].height;
+
+		if (x1 < 0)
+			x1 = 0;
+		if (y1 < 0)
+			y1 = 0;
+		if (x2 > data->adj_width)
+			x2 = data->adj_width;
+		if (y2 > data->adj_height)
+			y2 = data->adj_height;
+		if (x1 >= x2 || y1 >= y2)
+			continue;
+
+		if (num == MAX_DAMAGE_RECTS) {
+			num = -1;
+			break;
+		}
+
+		rects[num].x = (int16_t)x1;
+		rects[num].y = (int16_t)y1;
+		rects[num].width = (uint16_t)(x2 - x1);
+		rects[num].height = (uint16_t)(y2 - y1);
+		area += (int64_t)rects[num].width * rects[num].height;
+		num++;
+	}
+
+	free(region_r);
+
+	if (area * 100 > (int64_t)data->adj_width * data->adj_height * MAX_DAMAGE_AREA_PERCENT)
+		return -1;
+
+	return num;
+}
+
+/**
+ * Fetch and upload only the parts of the capture area that changed
+ *
+ * The region rectangles do not overlap, so they can be packed one after the
+ * other into the shm segment, which is sized for the whole capture area.
+ */
+static bool xshm_capture_damage(struct xshm_data *data, const xcb_rectangle_t *rects, int num)
+{
+	xcb_shm_get_image_cookie_t img_c[MAX_DAMAGE_RECTS];
+	size_t offsets[MAX_DAMAGE_RECTS];
+	size_t offset = 0;
+	bool success = true;
+
+	for (int i = 0; i < num; i++) {
+		offsets[i] = offset;
+		img_c[i] = xcb_shm_get_image_unchecked(data->xcb, data->xcb_screen->root,
+						       data->adj_x_org + rects[i].x, data->adj_y_org + rects[i].y,
+						       rects[i].width, rects[i].height, ~0, XCB_IMAGE_FORMAT_Z_PIXMAP,
+						       data->xshm->seg, (uint32_t)offset);
+		offset += (size_t)rects[i].width * rects[i].height * 4;
+	}
+
+	for (int i = 0; i < num; i++) {
+		xcb_shm_get_image_reply_t *img_r = xcb_shm_get_image_reply(data->xcb, img_c[i], NULL);
+		success = success && img_r;
+		free(img_r);
+	}
+
+	if (!success)
+		return false;
+
+	obs_enter_graphics();
+	for (int i = 0; i < num && success; i++)
+		success = xshm_upload_rect(data, &rects[i], offsets[i]);
+	obs_leave_graphics();
+
+	if (!success)
+		return xshm_capture_full(data);
+
+	for (int i = 0; i < num; i++)
+		data->partial_pixels += (uint64_t)rects[i].width * rects[i].height;
+	data->partial_uploads++;
+	return true;
+}
+
 /**
  * Update the capture
  *
@@ -184,6 +407,19 @@ static const char *xshm_getname(void *unused)
  */
 static void xshm_capture_stop(struct xshm_data *data)
 {
+	if (data->full_uploads || data->partial_uploads) {
+		blog(LOG_INFO,
+		     "Uploaded %" PRIu64 " full frames and %" PRIu64 " partial updates (%" PRIu64
+		     " pixels, the equivalent of %.1f full frames)",
+		     data->full_uploads, data->partial_uploads, data->partial_pixels,
+		     data->adj_width && data->adj_height
+			     ? (double)data->partial_pixels / ((double)data->adj_width * data->adj_height)
+			     : 0.0);
+		data->full_uploads = 0;
+		data->partial_uploads = 0;
+		data->partial_pixels = 0;
+	}
+
 	obs_enter_graphics();
 
 	if (data->texture) {
@@ -197,6 +433,13 @@ static void xshm_capture_stop(struct xshm_data *data)
 
 	obs_leave_graphics();
 
+	if (data->use_damage) {
+		xcb_damage_destroy(data->xcb, data->damage);
+		xcb_xfixes_destroy_region(data->xcb, data->damage_region);
+		data->use_damage = false;
+		data->damaged = false;
+	}
+
 	if (data->xshm) {
 		xshm_xcb_detach(data->xshm);
 		data->xshm = NULL;
@@ -256,6 +499,8 @@ static void xshm_capture_start(struct xshm_data *data)
 	data->cursor = xcb_xcursor_init(data->xcb);
 	xcb_xcursor_offset(data->cursor, data->adj_x_org, data->adj_y_org);
 
+	xshm_init_damage(data);
+
 	obs_enter_graphics();
 
 	xshm_resize_texture(data);
@@ -494,27 +739,21 @@ static void xshm_video_tick(void *vptr, float seconds)
 	if (!obs_source_showing(data->source))
 		return;
 
-	xcb_shm_get_image_cookie_t img_c;
-	xcb_shm_get_image_reply_t *img_r;
+	if (!data->use_damage) {
+		xshm_capture_full(data);
+	} else if (xshm_poll_damage(data) || data->full_capture) {
+		xcb_rectangle_t rects[MAX_DAMAGE_RECTS];
+		int num = xshm_get_damage(data, rects);
 
-	img_c = xcb_shm_get_image_unchecked(data->xcb, data->xcb_screen->root, data->adj_x_org, data->adj_y_org,
-					    data->adj_width, data->adj_height, ~0, XCB_IMAGE_FORMAT_Z_PIXMAP,
-					    data->xshm->seg, 0);
-
-	img_r = xcb_shm_get_image_reply(data->xcb, img_c, NULL);
-
-	if (!img_r)
-		goto exit;
+		if (data->full_capture || num < 0)
+			data->full_capture = !xshm_capture_full(data);
+		else if (num > 0)
+			data->full_capture = !xshm_capture_damage(data, rects, num);
+	}
 
 	obs_enter_graphics();
-
-	gs_texture_set_image(data->texture, (void *)data->xshm->data, data->adj_width * 4, false);
 	xcb_xcursor_update(data->xcb, data->cursor);
-
 	obs_leave_graphics();
-
-exit:
-	free(img_r);
 }
 
 /**
@@ -23,6 +23,8 @@
 #include "formats.h"
 
 #include <util/darray.h>
+#include <util/platform.h>
+#include <util/threading.h>
 
 #include <gio/gio.h>
 #include <gio/gunixfdlist.h>
@@ -41,6 +43,8 @@
 
 //#define DEBUG_PIPEWIRE
 
+#define SEC_TO_NSEC 1000000000ULL
+
 #if !PW_CHECK_VERSION(0, 3, 62)
 enum spa_meta_videotransform_value {
 	SPA_META_TRANSFORMATION_None = 0,   /**< no transform */
@@ -95,11 +99,31 @@ struct _obs_pipewire {
 	GPtrArray *streams;
 };
 
+#define MAX_DMABUF_PLANES 4
+
+struct dmabuf_texture {
+	struct pw_buffer *buffer;
+	gs_texture_t *texture;
+
+	uint32_t width, height;
+	uint32_t drm_format;
+	uint64_t modifier;
+	uint32_t planes;
+	int fds[MAX_DMABUF_PLANES];
+	uint32_t offsets[MAX_DMABUF_PLANES];
+	uint32_t strides[MAX_DMABUF_PLANES];
+};
+
 struct _obs_pipewire_stream {
 	obs_pipewire *obs_pw;
 	obs_source_t *source;
 
+	/* Either owned by an entry of dmabuf_textures, shm_texture, or
+	 * retired_texture when its buffer was removed while still on screen */
 	gs_texture_t *texture;
+	gs_texture_t *shm_texture;
+	gs_texture_t *retired_texture;
+	DARRAY(struct dmabuf_texture) dmabuf_textures;
 
 	struct pw_stream *stream;
 	struct spa_hook stream_listener;
@@ -147,6 +171,24 @@ struct _obs_pipewire_stream {
 		bool release_point_will_signal;
 		bool set;
 	} sync;
+
+	struct {
+		enum obs_pw_buffer_path path;
+		uint64_t imports;
+		uint64_t import_cache_hits;
+		uint64_t import_ns_total;
+		uint64_t import_ns_max;
+		uint64_t copies;
+		uint64_t frames;
+
+		uint64_t window_start_ns;
+		uint64_t window_copies;
+		uint64_t window_frames;
+		double copies_per_sec;
+		double frames_per_sec;
+
+		pthread_mutex_t mutex;
+	} stats;
 };
 
 /* auxiliary methods */
@@ -638,6 +680,129 @@ static enum video_range_type video_color_range_from_spa_color_range(enum spa_vid
 	}
 }
 
+/* Buffer paths, imported textures and statistics */
+
+const char *obs_pipewire_buffer_path_name(enum obs_pw_buffer_path path)
+{
+	switch (path) {
+	case OBS_PW_BUFFER_PATH_DMABUF:
+		return "DMA-BUF import";
+	case OBS_PW_BUFFER_PATH_SHM:
+		return "memory copy";
+	case OBS_PW_BUFFER_PATH_ASYNC:
+		return "async frame copy";
+	case OBS_PW_BUFFER_PATH_NONE:
+		break;
+	}
+
+	return "none";
+}
+
+static void update_stats(obs_pipewire_stream *obs_pw_stream, enum obs_pw_buffer_path path, bool imported,
+			 uint64_t import_ns)
+{
+	uint64_t now = os_gettime_ns();
+	bool copied = path != OBS_PW_BUFFER_PATH_DMABUF;
+
+	pthread_mutex_lock(&obs_pw_stream->stats.mutex);
+
+	if (obs_pw_stream->stats.path != path) {
+		blog(LOG_INFO, "[pipewire] Stream %p: using %s path", obs_pw_stream->stream,
+		     obs_pipewire_buffer_path_name(path));
+		obs_pw_stream->stats.path = path;
+	}
+
+	if (imported) {
+		obs_pw_stream->stats.imports++;
+		obs_pw_stream->stats.import_ns_total += import_ns;
+		if (import_ns > obs_pw_stream->stats.import_ns_max)
+			obs_pw_stream->stats.import_ns_max = import_ns;
+	} else if (!copied) {
+		obs_pw_stream->stats.import_cache_hits++;
+	}
+
+	obs_pw_stream->stats.frames++;
+	obs_pw_stream->stats.window_frames++;
+	if (copied) {
+		obs_pw_stream->stats.copies++;
+		obs_pw_stream->stats.window_copies++;
+	}
+
+	if (!obs_pw_stream->stats.window_start_ns) {
+		obs_pw_stream->stats.window_start_ns = now;
+	} else if (now - obs_pw_stream->stats.window_start_ns >= SEC_TO_NSEC) {
+		double seconds = (double)(now - obs_pw_stream->stats.window_start_ns) / (double)SEC_TO_NSEC;
+
+		obs_pw_stream->stats.copies_per_sec = (double)obs_pw_stream->stats.window_copies / seconds;
+		obs_pw_stream->stats.frames_per_sec = (double)obs_pw_stream->stats.window_frames / seconds;
+		obs_pw_stream->stats.window_copies = 0;
+		obs_pw_stream->stats.window_frames = 0;
+		obs_pw_stream->stats.window_start_ns = now;
+	}
+
+	pthread_mutex_unlock(&obs_pw_stream->stats.mutex);
+}
+
+/* Must be called from within the graphics context */
+static void set_stream_texture(obs_pipewire_stream *obs_pw_stream, gs_texture_t *texture)
+{
+	obs_pw_stream->texture = texture;
+	g_clear_pointer(&obs_pw_stream->retired_texture, gs_texture_destroy);
+}
+
+static struct dmabuf_texture *find_dmabuf_texture(obs_pipewire_stream *obs_pw_stream, struct pw_buffer *b)
+{
+	for (size_t i = 0; i < obs_pw_stream->dmabuf_textures.num; i++) {
+		if (obs_pw_stream->dmabuf_textures.array[i].buffer == b)
+			return &obs_pw_stream->dmabuf_textures.array[i];
+	}
+
+	return NULL;
+}
+
+static bool dmabuf_texture_matches(const struct dmabuf_texture *entry, const struct dmabuf_texture *params)
+{
+	if (entry->width != params->width || entry->height != params->height ||
+	    entry->drm_format != params->drm_format || entry->modifier != params->modifier ||
+	    entry->planes != params->planes)
+		return false;
+
+	for (uint32_t plane = 0; plane < params->planes; plane++) {
+		if (entry->fds[plane] != params->fds[plane] || entry->offsets[plane] != params->offsets[plane] ||
+		    entry->strides[plane] != params->strides[plane])
+			return false;
+	}
+
+	return true;
+}
+
+/* Must be called from within the graphics context */
+static void release_dmabuf_texture(obs_pipewire_stream *obs_pw_stream, struct dmabuf_texture *entry)
+{
+	/* The texture may still be drawn until the next frame replaces it */
+	if (entry->texture == obs_pw_stream->texture) {
+		g_clear_pointer(&obs_pw_stream->retired_texture, gs_texture_destroy);
+		obs_pw_stream->retired_texture = entry->texture;
+	} else {
+		gs_texture_destroy(entry->texture);
+	}
+
+	da_erase(obs_pw_stream->dmabuf_textures, entry - obs_pw_stream->dmabuf_textures.array);
+}
+
+/* Must be called from within the graphics context */
+static void clear_stream_textures(obs_pipewire_stream *obs_pw_stream)
+{
+	obs_pw_stream->texture = NULL;
+
+	for (size_t i = 0; i < obs_pw_stream->dmabuf_textures.num; i++)
+		gs_texture_destroy(obs_pw_stream->dmabuf_textures.array[i].texture);
+	da_free(obs_pw_stream->dmabuf_textures);
+
+	g_clear_pointer(&obs_pw_stream->shm_texture, gs_texture_destroy);
+	g_clear_pointer(&obs_pw_stream->retired_texture, gs_texture_destroy);
+}
+
 static bool prepare_obs_frame(obs_pipewire_stream *obs_pw_stream, struct obs_source_frame *frame)
 {
 	struct obs_pw_video_format obs_pw_video_format;
@@ -703,6 +868,7 @@ static void process_video_async(obs_pipewire_stream *obs_pw_stream)
 #endif
 
 	obs_source_output_video(obs_pw_stream->source, &out);
+	update_stats(obs_pw_stream, OBS_PW_BUFFER_PATH_ASYNC, false, 0);
 
 done:
 	pw_stream_queue_buffer(obs_pw_stream->stream, b);
@@ -745,10 +911,11 @@ static void process_video_sync(obs_pipewire_stream *obs_pw_stream)
 
 	if (buffer->datas[0].type == SPA_DATA_DmaBuf) {
 		uint32_t planes = get_spa_buffer_plane_count(buffer);
-		uint32_t *offsets = alloca(sizeof(uint32_t) * planes);
-		uint32_t *strides = alloca(sizeof(uint32_t) * planes);
-		uint64_t *modifiers = alloca(sizeof(uint64_t) * planes);
-		int *fds = alloca(sizeof(int) * planes);
+		uint64_t modifiers[MAX_DMABUF_PLANES];
+		struct dmabuf_texture params = {0};
+		struct dmabuf_texture *entry;
+		gs_texture_t *texture;
+		uint64_t import_ns;
 		bool use_modifiers;
 		bool corrupt = false;
 #if PW_CHECK_VERSION(1, 2, 0)
@@ -769,10 +936,22 @@ static void process_video_sync(obs_pipewire_stream *obs_pw_stream)
 			goto read_metadata;
 		}
 
+		if (planes == 0 || planes > MAX_DMABUF_PLANES) {
+			blog(LOG_ERROR, "[pipewire] unsupported DMA buffer plane count: %u", planes);
+			goto read_metadata;
+		}
+
+		params.buffer = b;
+		params.width = obs_pw_stream->format.info.raw.size.width;
+		params.height = obs_pw_stream->format.info.raw.size.height;
+		params.drm_format = obs_pw_video_format.drm_format;
+		params.modifier = obs_pw_stream->format.info.raw.modifier;
+		params.planes = planes;
+
 		for (uint32_t plane = 0; plane < planes; plane++) {
-			fds[plane] = buffer->datas[plane].fd;
-			offsets[plane] = buffer->datas[plane].chunk->offset;
-			strides[plane] = buffer->datas[plane].chunk->stride;
+			params.fds[plane] = buffer->datas[plane].fd;
+			params.offsets[plane] = buffer->datas[plane].chunk->offset;
+			params.strides[plane] = buffer->datas[plane].chunk->stride;
 			modifiers[plane] = obs_pw_stream->format.info.raw.modifier;
 			corrupt |= (buffer->datas[plane].chunk->flags & SPA_CHUNK_FLAG_CORRUPTED) > 0;
 		}
@@ -814,22 +993,54 @@ static void process_video_sync(obs_pipewire_stream *obs_pw_stream)
 			goto read_metadata;
 		}
 
-		g_clear_pointer(&obs_pw_stream->texture, gs_texture_destroy);
+		/* Producers cycle through a small pool of buffers, so the
+		 * texture imported for a buffer stays valid for as long as the
+		 * buffer keeps the same planes. */
+		entry = find_dmabuf_texture(obs_pw_stream, b);
+		if (entry && !dmabuf_texture_matches(entry, &params)) {
+			release_dmabuf_texture(obs_pw_stream, entry);
+			entry = NULL;
+		}
 
-		use_modifiers = obs_pw_stream->format.info.raw.modifier != DRM_FORMAT_MOD_INVALID;
-		obs_pw_stream->texture = gs_texture_create_from_dmabuf(obs_pw_stream->format.info.raw.size.width,
-								       obs_pw_stream->format.info.raw.size.height,
-								       obs_pw_video_format.drm_format, GS_BGRX, planes,
-								       fds, strides, offsets,
-								       use_modifiers ? modifiers : NULL);
+		if (entry) {
+			set_stream_texture(obs_pw_stream, entry->texture);
+			update_stats(obs_pw_stream, OBS_PW_BUFFER_PATH_DMABUF, false, 0);
+		} else {
+			use_modifiers = params.modifier != DRM_FORMAT_MOD_INVALID;
+			import_ns = os_gettime_ns();
+			texture = gs_texture_create_from_dmabuf(params.width, params.height, params.drm_format,
+								GS_BGRX, planes, params.fds, params.strides,
+								params.offsets, use_modifiers ? modifiers : NULL);
+			import_ns = os_gettime_ns() - import_ns;
+
+			if (texture == NULL) {
+				blog(LOG_INFO, "[pipewire] Failed to import DMA-BUF with modifier 0x%" PRIx64
+					       ", renegotiating",
+				     params.modifier);
+				remove_modifier_from_format(obs_pw_stream, obs_pw_stream->format.info.raw.format,
+							    obs_pw_stream->format.info.raw.modifier);
+				pw_loop_signal_event(pw_thread_loop_get_loop(obs_pw->thread_loop),
+						     obs_pw_stream->reneg);
+				goto read_metadata;
+			}
 
-		if (obs_pw_stream->texture == NULL) {
-			remove_modifier_from_format(obs_pw_stream, obs_pw_stream->format.info.raw.format,
-						    obs_pw_stream->format.info.raw.modifier);
-			pw_loop_signal_event(pw_thread_loop_get_loop(obs_pw->thread_loop), obs_pw_stream->reneg);
-			goto read_metadata;
+			if (obs_pw_video_format.swap_red_blue)
+				swap_texture_red_blue(texture);
+
+			params.texture = texture;
+			da_push_back(obs_pw_stream->dmabuf_textures, &params);
+
+			set_stream_texture(obs_pw_stream, texture);
+			update_stats(obs_pw_stream, OBS_PW_BUFFER_PATH_DMABUF, true, import_ns);
 		}
+
+		g_clear_pointer(&obs_pw_stream->shm_texture, gs_texture_destroy);
 	} else {
+		struct spa_data *data = &buffer->datas[0];
+		uint32_t width = obs_pw_stream->format.info.raw.size.width;
+		uint32_t height = obs_pw_stream->format.info.raw.size.height;
+		uint32_t stride;
+
 		blog(LOG_DEBUG, "[pipewire] Buffer has memory texture");
 
 		if (!obs_pw_video_format_from_spa_format(obs_pw_stream->format.info.raw.format, &obs_pw_video_format) ||
@@ -849,15 +1060,39 @@ static void process_video_sync(obs_pipewire_stream *obs_pw_stream)
 			goto read_metadata;
 		}
 
-		g_clear_pointer(&obs_pw_stream->texture, gs_texture_destroy);
-		obs_pw_stream->texture = gs_texture_create(obs_pw_stream->format.info.raw.size.width,
-							   obs_pw_stream->format.info.raw.size.height,
-							   obs_pw_video_format.gs_format, 1,
-							   (const uint8_t **)&buffer->datas[0].data, GS_DYNAMIC);
-	}
+		stride = data->chunk->stride > 0 ? (uint32_t)data->chunk->stride : width * obs_pw_video_format.bpp;
+		if (!data->data || (uint64_t)data->chunk->offset + (uint64_t)stride * height > data->maxsize) {
+			blog(LOG_DEBUG, "[pipewire] buffer is smaller than its frame");
+			goto read_metadata;
+		}
 
-	if (obs_pw_video_format.swap_red_blue)
-		swap_texture_red_blue(obs_pw_stream->texture);
+		/* Upload into the same texture for as long as the format holds
+		 * rather than allocating a new one for every frame */
+		if (obs_pw_stream->shm_texture && (gs_texture_get_width(obs_pw_stream->shm_texture) != width ||
+						   gs_texture_get_height(obs_pw_stream->shm_texture) != height ||
+						   gs_texture_get_color_format(obs_pw_stream->shm_texture) !=
+							   obs_pw_video_format.gs_format)) {
+			if (obs_pw_stream->texture == obs_pw_stream->shm_texture)
+				obs_pw_stream->texture = NULL;
+			g_clear_pointer(&obs_pw_stream->shm_texture, gs_texture_destroy);
+		}
+
+		if (!obs_pw_stream->shm_texture) {
+			obs_pw_stream->shm_texture =
+				gs_texture_create(width, height, obs_pw_video_format.gs_format, 1, NULL, GS_DYNAMIC);
+			if (!obs_pw_stream->shm_texture)
+				goto read_metadata;
+
+			if (obs_pw_video_format.swap_red_blue)
+				swap_texture_red_blue(obs_pw_stream->shm_texture);
+		}
+
+		gs_texture_set_image(obs_pw_stream->shm_texture, SPA_MEMBER(data->data, data->chunk->offset, uint8_t),
+				     stride, false);
+
+		set_stream_texture(obs_pw_stream, obs_pw_stream->shm_texture);
+		update_stats(obs_pw_stream, OBS_PW_BUFFER_PATH_SHM, false, 0);
+	}
 
 	/* Video Crop */
 	region = spa_buffer_find_meta_data(buffer, SPA_META_VideoCrop, sizeof(*region));
@@ -1073,10 +1308,25 @@ static void on_state_changed_cb(void *user_data, enum pw_stream_state old, enum
 	     pw_stream_state_as_string(state), error ? error : "none");
 }
 
+static void on_remove_buffer_cb(void *user_data, struct pw_buffer *buffer)
+{
+	obs_pipewire_stream *obs_pw_stream = user_data;
+	struct dmabuf_texture *entry;
+
+	entry = find_dmabuf_texture(obs_pw_stream, buffer);
+	if (!entry)
+		return;
+
+	obs_enter_graphics();
+	release_dmabuf_texture(obs_pw_stream, entry);
+	obs_leave_graphics();
+}
+
 static const struct pw_stream_events stream_events = {
 	PW_VERSION_STREAM_EVENTS,
 	.state_changed = on_state_changed_cb,
 	.param_changed = on_param_changed_cb,
+	.remove_buffer = on_remove_buffer_cb,
 	.process = on_process_cb,
 };
 
@@ -1208,6 +1458,7 @@ obs_pipewire_stream *obs_pipewire_connect_stream(obs_pipewire *obs_pw, obs_sourc
 	obs_pw_stream->resolution.set = connect_info->video.resolution != NULL;
 	obs_pw_stream->sync.acquire_syncobj_fd = -1;
 	obs_pw_stream->sync.release_syncobj_fd = -1;
+	pthread_mutex_init(&obs_pw_stream->stats.mutex, NULL);
 
 	if (obs_pw_stream->framerate.set)
 		obs_pw_stream->framerate.fraction = *connect_info->video.framerate;
@@ -1236,6 +1487,7 @@ obs_pipewire_stream *obs_pipewire_connect_stream(obs_pipewire *obs_pw, obs_sourc
 
 	if (!build_format_params(obs_pw_stream, &pod_builder, &params, &n_params)) {
 		pw_thread_loop_unlock(obs_pw->thread_loop);
+		pthread_mutex_destroy(&obs_pw_stream->stats.mutex);
 		bfree(obs_pw_stream);
 		return NULL;
 	}
@@ -1397,6 +1649,22 @@ void obs_pipewire_stream_set_cursor_visible(obs_pipewire_stream *obs_pw_stream,
 	obs_pw_stream->cursor.visible = cursor_visible;
 }
 
+static void log_stream_stats(obs_pipewire_stream *obs_pw_stream)
+{
+	struct obs_pipewire_stream_stats stats;
+
+	obs_pipewire_stream_get_stats(obs_pw_stream, &stats);
+	if (!stats.frames)
+		return;
+
+	blog(LOG_INFO,
+	     "[pipewire] Stream %p: %" PRIu64 " frames over the %s path, %" PRIu64 " DMA-BUF imports (%" PRIu64
+	     " reused, %.3f ms average, %.3f ms max), %" PRIu64 " copies",
+	     obs_pw_stream->stream, stats.frames, obs_pipewire_buffer_path_name(stats.path),
+	     stats.imports, stats.import_cache_hits, (double)stats.import_ns_avg / 1000000.0,
+	     (double)stats.import_ns_max / 1000000.0, stats.copies);
+}
+
 void obs_pipewire_stream_destroy(obs_pipewire_stream *obs_pw_stream)
 {
 	uint32_t output_flags;
@@ -1410,10 +1678,7 @@ void obs_pipewire_stream_destroy(obs_pipewire_stream *obs_pw_stream)
 
 	g_ptr_array_remove(obs_pw_stream->obs_pw->streams, obs_pw_stream);
 
-	obs_enter_graphics();
-	g_clear_pointer(&obs_pw_stream->cursor.texture, gs_texture_destroy);
-	g_clear_pointer(&obs_pw_stream->texture, gs_texture_destroy);
-	obs_leave_graphics();
+	log_stream_stats(obs_pw_stream);
 
 	pw_thread_loop_lock(obs_pw_stream->obs_pw->thread_loop);
 	if (obs_pw_stream->stream)
@@ -1421,10 +1686,18 @@ void obs_pipewire_stream_destroy(obs_pipewire_stream *obs_pw_stream)
 	g_clear_pointer(&obs_pw_stream->stream, pw_stream_destroy);
 	pw_thread_loop_unlock(obs_pw_stream->obs_pw->thread_loop);
 
+	/* Only once the stream is gone, so that no frame can be processed
+	 * into a texture that is no longer tracked */
+	obs_enter_graphics();
+	g_clear_pointer(&obs_pw_stream->cursor.texture, gs_texture_destroy);
+	clear_stream_textures(obs_pw_stream);
+	obs_leave_graphics();
+
 	g_clear_fd(&obs_pw_stream->sync.acquire_syncobj_fd, NULL);
 	g_clear_fd(&obs_pw_stream->sync.release_syncobj_fd, NULL);
 
 	clear_format_info(obs_pw_stream);
+	pthread_mutex_destroy(&obs_pw_stream->stats.mutex);
 	bfree(obs_pw_stream);
 }
 
@@ -1469,3 +1742,27 @@ void obs_pipewire_stream_set_resolution(obs_pipewire_stream *obs_pw_stream, cons
 	/* Signal to renegotiate */
 	pw_loop_signal_event(pw_thread_loop_get_loop(obs_pw->thread_loop), obs_pw_stream->reneg);
 }
+
+void obs_pipewire_stream_get_stats(obs_pipewire_stream *obs_pw_stream, struct obs_pipewire_stream_stats *stats)
+{
+	uint64_t now = os_gettime_ns();
+	bool stalled;
+
+	pthread_mutex_lock(&obs_pw_stream->stats.mutex);
+
+	stats->path = obs_pw_stream->stats.path;
+	stats->imports = obs_pw_stream->stats.imports;
+	stats->import_cache_hits = obs_pw_stream->stats.import_cache_hits;
+	stats->import_ns_avg =
+		stats->imports ? obs_pw_stream->stats.import_ns_total / obs_pw_stream->stats.imports : 0;
+	stats->import_ns_max = obs_pw_stream->stats.import_ns_max;
+	stats->copies = obs_pw_stream->stats.copies;
+	stats->frames = obs_pw_stream->stats.frames;
+
+	/* Rates are only refreshed as frames arrive */
+	stalled = now - obs_pw_stream->stats.window_start_ns > 2 * SEC_TO_NSEC;
+	stats->copies_per_sec = stalled ? 0.0 : obs_pw_stream->stats.copies_per_sec;
+	stats->frames_per_sec = stalled ? 0.0 : obs_pw_stream->stats.frames_per_sec;
+
+	pthread_mutex_unlock(&obs_pw_stream->stats.mutex);
+}
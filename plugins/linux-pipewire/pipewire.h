@@ -27,6 +27,32 @@
 typedef struct _obs_pipewire obs_pipewire;
 typedef struct _obs_pipewire_stream obs_pipewire_stream;
 
+enum obs_pw_buffer_path {
+	OBS_PW_BUFFER_PATH_NONE,
+	OBS_PW_BUFFER_PATH_DMABUF,
+	OBS_PW_BUFFER_PATH_SHM,
+	OBS_PW_BUFFER_PATH_ASYNC,
+};
+
+struct obs_pipewire_stream_stats {
+	enum obs_pw_buffer_path path;
+
+	/* DMA-BUF imports performed, and frames that reused the texture
+	 * imported for the same buffer earlier */
+	uint64_t imports;
+	uint64_t import_cache_hits;
+	uint64_t import_ns_avg;
+	uint64_t import_ns_max;
+
+	/* Frames copied through system memory, either uploaded to a texture
+	 * or handed to libobs as async frames */
+	uint64_t copies;
+	double copies_per_sec;
+
+	uint64_t frames;
+	double frames_per_sec;
+};
+
 struct obs_pipewire_connect_stream_info {
 	const char *stream_name;
 	struct pw_properties *stream_properties;
@@ -61,3 +87,6 @@ void obs_pipewire_stream_destroy(obs_pipewire_stream *obs_pw_stream);
 
 void obs_pipewire_stream_set_framerate(obs_pipewire_stream *obs_pw_stream, const struct spa_fraction *framerate);
 void obs_pipewire_stream_set_resolution(obs_pipewire_stream *obs_pw, const struct spa_rectangle *resolution);
+
+void obs_pipewire_stream_get_stats(obs_pipewire_stream *obs_pw_stream, struct obs_pipewire_stream_stats *stats);
+const char *obs_pipewire_buffer_path_name(enum obs_pw_buffer_path path);
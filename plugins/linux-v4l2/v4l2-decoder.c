@@ -15,7 +15,11 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <inttypes.h>
+
 #include <obs-module.h>
+#include <util/platform.h>
+#include <util/source-profiler.h>
 #include <linux/videodev2.h>
 #include <libavutil/error.h>
 
@@ -130,3 +134,208 @@ int v4l2_decode_frame(struct obs_source_frame *out, uint8_t *data, size_t length
 
 	return 0;
 }
+
+#define MAX_DECODE_WORKERS 4
+/* frames that may wait for a free worker before new ones are dropped */
+#define EXTRA_DECODE_JOBS 2
+
+static bool decode_pool_next_job(struct v4l2_decode_pool *pool, struct v4l2_decode_job **job)
+{
+	pthread_mutex_lock(&pool->mutex);
+
+	while (!pool->stop && !pool->pending.size)
+		pthread_cond_wait(&pool->job_cond, &pool->mutex);
+
+	const bool running = !pool->stop;
+	if (running) {
+		deque_pop_front(&pool->pending, job, sizeof(*job));
+		pool->in_flight++;
+	}
+
+	pthread_mutex_unlock(&pool->mutex);
+	return running;
+}
+
+/* Waits until all frames submitted before this one have been output, so
+ * that the source sees frames in capture order no matter which worker
+ * finishes first. */
+static bool decode_pool_wait_turn(struct v4l2_decode_pool *pool, const struct v4l2_decode_job *job)
+{
+	pthread_mutex_lock(&pool->mutex);
+
+	while (!pool->stop && pool->next_output != job->sequence)
+		pthread_cond_wait(&pool->output_cond, &pool->mutex);
+
+	const bool running = !pool->stop;
+	pthread_mutex_unlock(&pool->mutex);
+	return running;
+}
+
+static void decode_pool_finish_job(struct v4l2_decode_pool *pool, struct v4l2_decode_job *job, bool failed)
+{
+	pthread_mutex_lock(&pool->mutex);
+
+	if (failed)
+		pool->failed = true;
+
+	pool->next_output++;
+	pool->in_flight--;
+	da_push_back(pool->free_jobs, &job);
+	pthread_cond_broadcast(&pool->output_cond);
+
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+static void *decode_worker_thread(void *param)
+{
+	struct v4l2_decode_worker *worker = param;
+	struct v4l2_decode_pool *pool = worker->pool;
+	struct v4l2_decode_job *job;
+
+	os_set_thread_name("v4l2: decode");
+
+	while (decode_pool_next_job(pool, &job)) {
+		struct obs_source_frame out = job->frame;
+		bool failed = v4l2_decode_frame(&out, job->data, job->size, &worker->decoder) < 0;
+
+		if (failed)
+			blog(LOG_ERROR, "failed to unpack jpeg");
+
+		if (!decode_pool_wait_turn(pool, job))
+			break;
+
+		/* the decoder may need more data before it returns a frame, in
+		 * which case the planes are still unset */
+		if (!failed && out.data[0]) {
+			obs_source_output_video(pool->source, &out);
+			source_profiler_async_frame_decoded(pool->source, os_gettime_ns() - job->queued_ns,
+							    job->queue_depth);
+		}
+
+		decode_pool_finish_job(pool, job, failed);
+	}
+
+	return NULL;
+}
+
+int v4l2_init_decode_pool(struct v4l2_decode_pool *pool, int pixfmt, obs_source_t *source)
+{
+	int cores = os_get_logical_cores();
+
+	memset(pool, 0, sizeof(*pool));
+	pool->source = source;
+	pool->num_workers = cores > 2 ? (size_t)cores - 1 : 1;
+	if (pool->num_workers > MAX_DECODE_WORKERS)
+		pool->num_workers = MAX_DECODE_WORKERS;
+	pool->num_jobs = pool->num_workers + EXTRA_DECODE_JOBS;
+
+	pthread_mutex_init_value(&pool->mutex);
+	if (pthread_mutex_init(&pool->mutex, NULL) != 0)
+		return -1;
+	if (pthread_cond_init(&pool->job_cond, NULL) != 0)
+		return -1;
+	if (pthread_cond_init(&pool->output_cond, NULL) != 0)
+		return -1;
+
+	pool->jobs = bzalloc(sizeof(struct v4l2_decode_job) * pool->num_jobs);
+	for (size_t i = 0; i < pool->num_jobs; i++) {
+		struct v4l2_decode_job *job = &pool->jobs[i];
+		da_push_back(pool->free_jobs, &job);
+	}
+
+	pool->workers = bzalloc(sizeof(struct v4l2_decode_worker) * pool->num_workers);
+	for (size_t i = 0; i < pool->num_workers; i++) {
+		struct v4l2_decode_worker *worker = &pool->workers[i];
+
+		worker->pool = pool;
+		if (v4l2_init_decoder(&worker->decoder, pixfmt) < 0)
+			return -1;
+		if (pthread_create(&worker->thread, NULL, decode_worker_thread, worker) != 0)
+			return -1;
+		worker->thread_created = true;
+	}
+
+	blog(LOG_INFO, "started %zu decode threads", pool->num_workers);
+	return 0;
+}
+
+void v4l2_destroy_decode_pool(struct v4l2_decode_pool *pool)
+{
+	if (!pool->jobs)
+		return;
+
+	pthread_mutex_lock(&pool->mutex);
+	pool->stop = true;
+	pthread_cond_broadcast(&pool->job_cond);
+	pthread_cond_broadcast(&pool->output_cond);
+	pthread_mutex_unlock(&pool->mutex);
+
+	for (size_t i = 0; i < pool->num_workers; i++) {
+		struct v4l2_decode_worker *worker = &pool->workers[i];
+
+		if (worker->thread_created)
+			pthread_join(worker->thread, NULL);
+		v4l2_destroy_decoder(&worker->decoder);
+	}
+
+	if (pool->dropped)
+		blog(LOG_INFO, "dropped %" PRIu64 " frames while all decode threads were busy", pool->dropped);
+
+	for (size_t i = 0; i < pool->num_jobs; i++)
+		bfree(pool->jobs[i].data);
+
+	da_free(pool->free_jobs);
+	deque_free(&pool->pending);
+	bfree(pool->workers);
+	bfree(pool->jobs);
+
+	pthread_cond_destroy(&pool->output_cond);
+	pthread_cond_destroy(&pool->job_cond);
+	pthread_mutex_destroy(&pool->mutex);
+
+	memset(pool, 0, sizeof(*pool));
+}
+
+int v4l2_decode_pool_submit(struct v4l2_decode_pool *pool, const struct obs_source_frame *frame, const uint8_t *data,
+			    size_t length)
+{
+	struct v4l2_decode_job *job = NULL;
+	bool failed;
+
+	pthread_mutex_lock(&pool->mutex);
+	failed = pool->failed;
+	if (pool->free_jobs.num) {
+		job = pool->free_jobs.array[pool->free_jobs.num - 1];
+		da_pop_back(pool->free_jobs);
+	} else {
+		pool->dropped++;
+	}
+	pthread_mutex_unlock(&pool->mutex);
+
+	if (failed)
+		return -1;
+
+	if (!job) {
+		blog(LOG_DEBUG, "all decode threads busy, dropping frame");
+		return 0;
+	}
+
+	/* copied here so the v4l2 buffer can go straight back to the driver */
+	if (job->capacity < length) {
+		job->data = brealloc(job->data, length);
+		job->capacity = length;
+	}
+	memcpy(job->data, data, length);
+	job->size = length;
+	job->frame = *frame;
+	job->queued_ns = os_gettime_ns();
+
+	pthread_mutex_lock(&pool->mutex);
+	job->sequence = pool->next_sequence++;
+	job->queue_depth = (uint32_t)(pool->pending.size / sizeof(job) + pool->in_flight);
+	deque_push_back(&pool->pending, &job, sizeof(job));
+	pthread_cond_signal(&pool->job_cond);
+	pthread_mutex_unlock(&pool->mutex);
+
+	return 0;
+}
@@ -25,6 +25,10 @@ extern "C" {
 #include <libavformat/avformat.h>
 #include <libavutil/pixfmt.h>
 
+#include <util/threading.h>
+#include <util/darray.h>
+#include <util/deque.h>
+
 /**
  * Data structure for decoder
  */
@@ -63,6 +67,94 @@ void v4l2_destroy_decoder(struct v4l2_decoder *decoder);
  */
 int v4l2_decode_frame(struct obs_source_frame *out, uint8_t *data, size_t length, struct v4l2_decoder *decoder);
 
+/**
+ * A compressed frame waiting for or going through decoding
+ */
+struct v4l2_decode_job {
+	struct obs_source_frame frame;
+	uint8_t *data;
+	size_t size;
+	size_t capacity;
+	uint64_t sequence;
+	uint64_t queued_ns;
+	uint32_t queue_depth;
+};
+
+struct v4l2_decode_pool;
+
+/**
+ * A decode thread with its own codec context
+ */
+struct v4l2_decode_worker {
+	struct v4l2_decode_pool *pool;
+	struct v4l2_decoder decoder;
+	pthread_t thread;
+	bool thread_created;
+};
+
+/**
+ * Pipelined decoder for intra-only formats (MJPEG)
+ *
+ * Compressed frames are copied out of the v4l2 buffer so that the buffer
+ * can be requeued right away, and are then decoded by a small pool of
+ * worker threads.  Frames are output in the order they were submitted.
+ */
+struct v4l2_decode_pool {
+	obs_source_t *source;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t job_cond;
+	pthread_cond_t output_cond;
+	bool stop;
+	bool failed;
+
+	struct v4l2_decode_worker *workers;
+	size_t num_workers;
+
+	struct v4l2_decode_job *jobs;
+	size_t num_jobs;
+	DARRAY(struct v4l2_decode_job *) free_jobs;
+	struct deque pending;
+	size_t in_flight;
+
+	uint64_t next_sequence;
+	uint64_t next_output;
+	uint64_t dropped;
+};
+
+/**
+ * Initialize the decode pool and start its worker threads.
+ * The pool must be destroyed on failure.
+ *
+ * @param pool the pool structure
+ * @param pixfmt which codec is used
+ * @param source the source decoded frames are output to
+ * @return non-zero on failure
+ */
+int v4l2_init_decode_pool(struct v4l2_decode_pool *pool, int pixfmt, obs_source_t *source);
+
+/**
+ * Stop the worker threads and free any data associated with the pool.
+ * Frames that have not been decoded yet are discarded.
+ *
+ * @param pool the pool structure
+ */
+void v4l2_destroy_decode_pool(struct v4l2_decode_pool *pool);
+
+/**
+ * Queue a compressed frame for decoding.
+ * The data is copied, so the buffer can be reused as soon as this returns.
+ * If all workers are busy and the queue is full the frame is dropped.
+ *
+ * @param pool the pool as initialized by v4l2_init_decode_pool
+ * @param frame the prepared obs frame, including the timestamp
+ * @param data the codec data
+ * @param length length of the data
+ * @return non-zero if a previous frame failed to decode
+ */
+int v4l2_decode_pool_submit(struct v4l2_decode_pool *pool, const struct obs_source_frame *frame, const uint8_t *data,
+			    size_t length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -82,6 +82,7 @@ struct v4l2_data {
 	pthread_t thread;
 	os_event_t *event;
 	struct v4l2_decoder decoder;
+	struct v4l2_decode_pool decode_pool;
 
 	bool framerate_unchanged;
 	bool resolution_unchanged;
@@ -258,7 +259,12 @@ static void *v4l2_thread(void *vptr)
 
 		start = (uint8_t *)data->buffers.info[buf.index].start;
 
-		if (data->pixfmt == V4L2_PIX_FMT_MJPEG || data->pixfmt == V4L2_PIX_FMT_H264) {
+		if (data->pixfmt == V4L2_PIX_FMT_MJPEG) {
+			/* decoded and output by the decode pool */
+			if (v4l2_decode_pool_submit(&data->decode_pool, &out, start, buf.bytesused) < 0)
+				break;
+			goto continue_queue_buffer;
+		} else if (data->pixfmt == V4L2_PIX_FMT_H264) {
 			if (v4l2_decode_frame(&out, start, buf.bytesused, &data->decoder) < 0) {
 				blog(LOG_ERROR, "failed to unpack jpeg or h264");
 				break;
@@ -838,7 +844,9 @@ static void v4l2_terminate(struct v4l2_data *data)
 		data->thread = 0;
 	}
 
-	if (data->pixfmt == V4L2_PIX_FMT_MJPEG || data->pixfmt == V4L2_PIX_FMT_H264) {
+	if (data->pixfmt == V4L2_PIX_FMT_MJPEG) {
+		v4l2_destroy_decode_pool(&data->decode_pool);
+	} else if (data->pixfmt == V4L2_PIX_FMT_H264) {
 		v4l2_destroy_decoder(&data->decoder);
 	}
 	v4l2_destroy_mmap(&data->buffers);
@@ -958,7 +966,14 @@ static void v4l2_init(struct v4l2_data *data)
 		goto fail;
 	}
 
-	if (data->pixfmt == V4L2_PIX_FMT_MJPEG || data->pixfmt == V4L2_PIX_FMT_H264) {
+	/* MJPEG frames are independent of each other and can be decoded in
+	 * parallel, while H264 has to go through a single decoder */
+	if (data->pixfmt == V4L2_PIX_FMT_MJPEG) {
+		if (v4l2_init_decode_pool(&data->decode_pool, data->pixfmt, data->source) < 0) {
+			blog(LOG_ERROR, "Failed to initialize decoder");
+			goto fail;
+		}
+	} else if (data->pixfmt == V4L2_PIX_FMT_H264) {
 		if (v4l2_init_decoder(&data->decoder, data->pixfmt) < 0) {
 			blog(LOG_ERROR, "Failed to initialize decoder");
 			goto fail;
@@ -1098,7 +1113,7 @@ static void *v4l2_create(obs_data_t *settings, obs_source_t *source)
 struct obs_source_info v4l2_input = {
 	.id = "v4l2_input",
 	.type = OBS_SOURCE_TYPE_INPUT,
-	.output_flags = OBS_SOURCE_ASYNC_VIDEO | OBS_SOURCE_DO_NOT_DUPLICATE,
+	.output_flags = OBS_SOURCE_ASYNC_VIDEO | OBS_SOURCE_DO_NOT_DUPLICATE | OBS_SOURCE_SHAREABLE,
 	.get_name = v4l2_getname,
 	.create = v4l2_create,
 	.destroy = v4l2_destroy,
@@ -3,19 +3,36 @@
 #include <obs-module.h>
 #include <util/dstr.h>
 #include <util/platform.h>
+#include <util/darray.h>
 #include <linux/videodev2.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <errno.h>
 #include <string.h>
+#include <inttypes.h>
+
+#define VCAM_NUM_BUFFERS 4
+
+struct virtualcam_buffer {
+	void *start;
+	size_t length;
+};
 
 struct virtualcam_data {
 	obs_output_t *output;
 	int device;
 	uint32_t frame_size;
 	bool use_caps_workaround;
+
+	/* mmap streaming I/O, used instead of write() when supported */
+	bool streaming;
+	struct virtualcam_buffer *buffers;
+	uint32_t num_buffers;
+	DARRAY(uint32_t) free_buffers;
+	uint64_t dropped;
 };
 
 static const char *virtualcam_name(void *unused)
@@ -24,10 +41,26 @@ static const char *virtualcam_name(void *unused)
 	return "Virtual Camera Output";
 }
 
+static void free_streaming(struct virtualcam_data *vcam)
+{
+	for (uint32_t i = 0; i < vcam->num_buffers; i++) {
+		if (vcam->buffers[i].start != MAP_FAILED)
+			munmap(vcam->buffers[i].start, vcam->buffers[i].length);
+	}
+
+	bfree(vcam->buffers);
+	da_free(vcam->free_buffers);
+
+	vcam->buffers = NULL;
+	vcam->num_buffers = 0;
+	vcam->streaming = false;
+}
+
 static void virtualcam_destroy(void *data)
 {
 	struct virtualcam_data *vcam = (struct virtualcam_data *)data;
 
+	free_streaming(vcam);
 	if (vcam->device >= 0)
 		close(vcam->device);
 
@@ -184,6 +217,62 @@ fail_close_reset_caps_fd:
 	return false;
 }
 
+/* Sets up mmap'd output buffers so frames can be copied straight into
+ * memory shared with the driver, instead of pushing them through blocking
+ * write() calls.  Falls back to write() if the device does not support
+ * streaming I/O. */
+static bool init_streaming(struct virtualcam_data *vcam)
+{
+	struct v4l2_requestbuffers req = {0};
+
+	req.count = VCAM_NUM_BUFFERS;
+	req.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+	req.memory = V4L2_MEMORY_MMAP;
+
+	if (ioctl(vcam->device, VIDIOC_REQBUFS, &req) < 0 || !req.count)
+		return false;
+
+	vcam->buffers = bzalloc(req.count * sizeof(struct virtualcam_buffer));
+	vcam->num_buffers = req.count;
+	for (uint32_t i = 0; i < req.count; i++)
+		vcam->buffers[i].start = MAP_FAILED;
+
+	for (uint32_t i = 0; i < req.count; i++) {
+		struct v4l2_buffer buf = {0};
+
+		buf.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+		buf.memory = V4L2_MEMORY_MMAP;
+		buf.index = i;
+
+		if (ioctl(vcam->device, VIDIOC_QUERYBUF, &buf) < 0 || buf.length < vcam->frame_size)
+			goto fail;
+
+		vcam->buffers[i].length = buf.length;
+		vcam->buffers[i].start =
+			mmap(NULL, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, vcam->device, buf.m.offset);
+		if (vcam->buffers[i].start == MAP_FAILED)
+			goto fail;
+
+		da_push_back(vcam->free_buffers, &i);
+	}
+
+	/* dequeueing must never block the video thread */
+	int flags = fcntl(vcam->device, F_GETFL);
+	if (flags < 0 || fcntl(vcam->device, F_SETFL, flags | O_NONBLOCK) < 0)
+		goto fail;
+
+	vcam->streaming = true;
+	vcam->dropped = 0;
+	return true;
+
+fail:
+	free_streaming(vcam);
+
+	req.count = 0;
+	ioctl(vcam->device, VIDIOC_REQBUFS, &req);
+	return false;
+}
+
 static bool try_connect(void *data, const char *device)
 {
 	static bool use_caps_workaround = false;
@@ -248,17 +337,21 @@ static bool try_connect(void *data, const char *device)
 	memset(&parm, 0, sizeof(parm));
 	parm.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
 
-	if (vcam->use_caps_workaround && ioctl(vcam->device, VIDIOC_STREAMON, &format.type) < 0) {
+	/* buffers have to be requested before streaming is turned on */
+	init_streaming(vcam);
+
+	if ((vcam->streaming || vcam->use_caps_workaround) && ioctl(vcam->device, VIDIOC_STREAMON, &format.type) < 0) {
 		blog(LOG_ERROR, "Failed to start streaming on '%s' (%s)", device, strerror(errno));
 		goto fail_close_device;
 	}
 
-	blog(LOG_INFO, "Virtual camera started");
+	blog(LOG_INFO, "Virtual camera started (%s)", vcam->streaming ? "mmap streaming" : "write");
 	obs_output_begin_data_capture(vcam->output, 0);
 
 	return true;
 
 fail_close_device:
+	free_streaming(vcam);
 	close(vcam->device);
 	vcam->device = -1;
 	return false;
@@ -331,10 +424,14 @@ static void virtualcam_stop(void *data, uint64_t ts)
 
 	uint32_t buf_type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
 
-	if (vcam->use_caps_workaround && ioctl(vcam->device, VIDIOC_STREAMOFF, buf_type) < 0) {
+	if ((vcam->streaming || vcam->use_caps_workaround) && ioctl(vcam->device, VIDIOC_STREAMOFF, &buf_type) < 0) {
 		blog(LOG_WARNING, "Failed to stop streaming on video device %d (%s)", vcam->device, strerror(errno));
 	}
 
+	if (vcam->dropped)
+		blog(LOG_INFO, "Virtual camera dropped %" PRIu64 " frames with no free buffer", vcam->dropped);
+
+	free_streaming(vcam);
 	close(vcam->device);
 	vcam->device = -1;
 	blog(LOG_INFO, "Virtual camera stopped");
@@ -342,9 +439,58 @@ static void virtualcam_stop(void *data, uint64_t ts)
 	UNUSED_PARAMETER(ts);
 }
 
+/* Takes back every buffer the driver is done with */
+static void reclaim_buffers(struct virtualcam_data *vcam)
+{
+	struct v4l2_buffer buf = {0};
+
+	buf.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+	buf.memory = V4L2_MEMORY_MMAP;
+
+	while (ioctl(vcam->device, VIDIOC_DQBUF, &buf) == 0)
+		da_push_back(vcam->free_buffers, &buf.index);
+}
+
+static void virtual_video_stream(struct virtualcam_data *vcam, struct video_data *frame)
+{
+	struct v4l2_buffer buf = {0};
+
+	if (!vcam->free_buffers.num)
+		reclaim_buffers(vcam);
+
+	/* all buffers are still queued; drop the frame rather than wait */
+	if (!vcam->free_buffers.num) {
+		vcam->dropped++;
+		return;
+	}
+
+	buf.index = vcam->free_buffers.array[vcam->free_buffers.num - 1];
+	da_pop_back(vcam->free_buffers);
+
+	memcpy(vcam->buffers[buf.index].start, frame->data[0], vcam->frame_size);
+
+	buf.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+	buf.memory = V4L2_MEMORY_MMAP;
+	buf.bytesused = vcam->frame_size;
+	buf.field = V4L2_FIELD_NONE;
+	buf.timestamp.tv_sec = frame->timestamp / 1000000000;
+	buf.timestamp.tv_usec = (frame->timestamp % 1000000000) / 1000;
+
+	if (ioctl(vcam->device, VIDIOC_QBUF, &buf) < 0) {
+		blog(LOG_DEBUG, "Failed to queue virtual camera buffer (%s)", strerror(errno));
+		da_push_back(vcam->free_buffers, &buf.index);
+	}
+}
+
 static void virtual_video(void *param, struct video_data *frame)
 {
 	struct virtualcam_data *vcam = (struct virtualcam_data *)param;
+
+	if (vcam->streaming) {
+		virtual_video_stream(vcam, frame);
+		return;
+	}
+
 	uint32_t frame_size = vcam->frame_size;
 	while (frame_size > 0) {
 		ssize_t written = write(vcam->device, frame->data[0], vcam->frame_size);
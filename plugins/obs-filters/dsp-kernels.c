@@ -0,0 +1,78 @@
+#include <math.h>
+
+#include "dsp-kernels.h"
+
+void dsp_mul_to_db(float *dst, const float *src, size_t num)
+{
+	for (size_t i = 0; i < num; i++)
+		dst[i] = dsp_fast_mul_to_db(src[i]);
+}
+
+void dsp_db_to_mul(float *dst, const float *src, size_t num)
+{
+	for (size_t i = 0; i < num; i++)
+		dst[i] = dsp_clamp_exp2(DSP_LOG2_PER_DB * src[i]);
+	for (size_t i = 0; i < num; i++)
+		dst[i] = dsp_fast_exp2(dst[i]);
+}
+
+float dsp_envelope_follow(float *env_buf, const float *samples, size_t num, float env, float attack_gain,
+			  float release_gain)
+{
+	/* the recursion is inherently serial, but selecting the coefficient
+	 * instead of branching keeps the loop free of mispredictions */
+	for (size_t i = 0; i < num; i++) {
+		const float env_in = fabsf(samples[i]);
+		const float coef = env < env_in ? attack_gain : release_gain;
+
+		env = env_in + coef * (env - env_in);
+		env_buf[i] = fmaxf(env_buf[i], env);
+	}
+
+	return env;
+}
+
+void dsp_compressor_gain(float *gain, const float *env_buf, size_t num, float threshold_db, float slope)
+{
+	for (size_t i = 0; i < num; i++) {
+		const float env_db = dsp_fast_mul_to_db(env_buf[i]);
+		const float gain_db = slope * (threshold_db - env_db);
+
+		/* plain compare rather than fminf, which is a libm call unless
+		 * NaN handling is relaxed */
+		gain[i] = gain_db < 0.0f ? gain_db : 0.0f;
+	}
+
+	dsp_db_to_mul(gain, gain, num);
+}
+
+void dsp_apply_gain(float *samples, const float *gain, size_t num, float output_gain)
+{
+	for (size_t i = 0; i < num; i++)
+		samples[i] *= gain[i] * output_gain;
+}
+
+#define LP4_EPSILON (1.0f / 4294967295.0f)
+
+void dsp_lp4_process(struct dsp_lp4 *lp, float *dst, const float *src, size_t num, float coef)
+{
+	/* keep the filter state in locals for the whole block rather than
+	 * going through memory on every sample */
+	float d0 = lp->delay0;
+	float d1 = lp->delay1;
+	float d2 = lp->delay2;
+	float d3 = lp->delay3;
+
+	for (size_t i = 0; i < num; i++) {
+		d0 += coef * (src[i] - d0) + LP4_EPSILON;
+		d1 += coef * (d0 - d1);
+		d2 += coef * (d1 - d2);
+		d3 += coef * (d2 - d3);
+		dst[i] = d3;
+	}
+
+	lp->delay0 = d0;
+	lp->delay1 = d1;
+	lp->delay2 = d2;
+	lp->delay3 = d3;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Block-processing kernels shared by the audio dynamics filters.
+ *
+ * Each kernel works on a whole block of samples at a time and keeps the
+ * per-sample work free of branches and libm calls, so the compiler can
+ * vectorize the loops.  The dB conversions are polynomial approximations
+ * that stay within 1e-5 dB of log10f/powf; silence maps to about -765 dB
+ * rather than -INFINITY.
+ */
+
+#define DSP_BLOCK_SIZE 1024
+
+struct dsp_lp4 {
+	float delay0;
+	float delay1;
+	float delay2;
+	float delay3;
+};
+
+static inline float dsp_fast_log2(float x)
+{
+	union {
+		float f;
+		int32_t i;
+	} u = {x};
+
+	/* split into exponent and a mantissa in [1, 2) */
+	const float e = (float)((u.i >> 23) & 0xff) - 127.0f;
+	u.i = (u.i & 0x007fffff) | 0x3f800000;
+	const float t = u.f - 1.0f;
+
+	float p = 1.512791605e-02f;
+	p = p * t - 7.815820827e-02f;
+	p = p * t + 1.923850549e-01f;
+	p = p * t - 3.246163836e-01f;
+	p = p * t + 4.731133450e-01f;
+	p = p * t - 7.205155141e-01f;
+	p = p * t + 1.442664046e+00f;
+	return e + p * t;
+}
+
+/* x has to be within [-126, 126]; see dsp_clamp_exp2 */
+static inline float dsp_fast_exp2(float x)
+{
+	union {
+		float f;
+		int32_t i;
+	} u;
+
+	/* floor without a libm call so the loop stays vectorizable */
+	int32_t i = (int32_t)x;
+	i -= x < (float)i;
+	const float t = x - (float)i;
+
+	/* constant term is exactly 1 so that 0 dB maps to unity gain */
+	float p = 1.885403786e-03f;
+	p = p * t + 8.972899304e-03f;
+	p = p * t + 5.583659802e-02f;
+	p = p * t + 2.401524446e-01f;
+	p = p * t + 6.931525353e-01f;
+
+	u.i = (i + 127) << 23;
+	return u.f + u.f * p * t;
+}
+
+/* Kept separate from dsp_fast_exp2: GCC will not vectorize a loop that
+ * clamps and then converts to an integer, so block kernels clamp in a pass
+ * of their own. */
+static inline float dsp_clamp_exp2(float x)
+{
+	x = x > -126.0f ? x : -126.0f;
+	return x < 126.0f ? x : 126.0f;
+}
+
+/* 20 * log10(2) and its inverse */
+#define DSP_DB_PER_LOG2 6.020599913f
+#define DSP_LOG2_PER_DB 0.166096405f
+
+static inline float dsp_fast_mul_to_db(float mul)
+{
+	return DSP_DB_PER_LOG2 * dsp_fast_log2(mul);
+}
+
+static inline float dsp_fast_db_to_mul(float db)
+{
+	return dsp_fast_exp2(dsp_clamp_exp2(DSP_LOG2_PER_DB * db));
+}
+
+extern void dsp_mul_to_db(float *dst, const float *src, size_t num);
+extern void dsp_db_to_mul(float *dst, const float *src, size_t num);
+
+/* Peak envelope follower.  The per-sample envelope is max-combined into
+ * env_buf so several channels can share one detector; returns the envelope
+ * after the last sample. */
+extern float dsp_envelope_follow(float *env_buf, const float *samples, size_t num, float env, float attack_gain,
+				 float release_gain);
+
+/* Downward compression gain from a linear envelope:
+ * gain = 10^(min(0, slope * (threshold_db - env_db)) / 20) */
+extern void dsp_compressor_gain(float *gain, const float *env_buf, size_t num, float threshold_db, float slope);
+
+extern void dsp_apply_gain(float *samples, const float *gain, size_t num, float output_gain);
+
+/* Four cascaded one-pole lowpass stages, as used by the 3-band EQ */
+extern void dsp_lp4_process(struct dsp_lp4 *lp, float *dst, const float *src, size_t num, float coef);
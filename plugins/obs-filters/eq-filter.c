@@ -5,19 +5,14 @@
 
 #include <math.h>
 
+#include "dsp-kernels.h"
+
 #define LOW_FREQ 800.0f
 #define HIGH_FREQ 5000.0f
 
 struct eq_channel_state {
-	float lf_delay0;
-	float lf_delay1;
-	float lf_delay2;
-	float lf_delay3;
-
-	float hf_delay0;
-	float hf_delay1;
-	float hf_delay2;
-	float hf_delay3;
+	struct dsp_lp4 lf;
+	struct dsp_lp4 hf;
 
 	float sample_delay1;
 	float sample_delay2;
@@ -94,36 +89,45 @@ static void eq_destroy(void *data)
 	bfree(eq);
 }
 
-#define EQ_EPSILON (1.0f / 4294967295.0f)
-
-static inline float eq_process(struct eq_data *eq, struct eq_channel_state *c, float sample)
+/* The low and high bands are each four cascaded one-pole lowpass filters,
+ * and the mid band is whatever is left of the input delayed by three samples
+ * to line up with them.  Each block is run through both cascades first and
+ * then mixed in a single pass. */
+static void eq_process(struct eq_data *eq, struct eq_channel_state *c, float *samples, size_t frames)
 {
-	float l, m, h;
-
-	c->lf_delay0 += eq->lf * (sample - c->lf_delay0) + EQ_EPSILON;
-	c->lf_delay1 += eq->lf * (c->lf_delay0 - c->lf_delay1);
-	c->lf_delay2 += eq->lf * (c->lf_delay1 - c->lf_delay2);
-	c->lf_delay3 += eq->lf * (c->lf_delay2 - c->lf_delay3);
-
-	l = c->lf_delay3;
-
-	c->hf_delay0 += eq->hf * (sample - c->hf_delay0) + EQ_EPSILON;
-	c->hf_delay1 += eq->hf * (c->hf_delay0 - c->hf_delay1);
-	c->hf_delay2 += eq->hf * (c->hf_delay1 - c->hf_delay2);
-	c->hf_delay3 += eq->hf * (c->hf_delay2 - c->hf_delay3);
-
-	h = c->sample_delay3 - c->hf_delay3;
-	m = c->sample_delay3 - (h + l);
-
-	l *= eq->low_gain;
-	m *= eq->mid_gain;
-	h *= eq->high_gain;
-
-	c->sample_delay3 = c->sample_delay2;
-	c->sample_delay2 = c->sample_delay1;
-	c->sample_delay1 = sample;
+	float lf[DSP_BLOCK_SIZE];
+	float hf[DSP_BLOCK_SIZE];
+	float delayed[DSP_BLOCK_SIZE + 3];
+	const float low_gain = eq->low_gain;
+	const float mid_gain = eq->mid_gain;
+	const float high_gain = eq->high_gain;
+
+	while (frames) {
+		const size_t num = frames < DSP_BLOCK_SIZE ? frames : DSP_BLOCK_SIZE;
+
+		dsp_lp4_process(&c->lf, lf, samples, num, eq->lf);
+		dsp_lp4_process(&c->hf, hf, samples, num, eq->hf);
+
+		delayed[0] = c->sample_delay3;
+		delayed[1] = c->sample_delay2;
+		delayed[2] = c->sample_delay1;
+		memcpy(delayed + 3, samples, num * sizeof(float));
+
+		c->sample_delay3 = delayed[num];
+		c->sample_delay2 = delayed[num + 1];
+		c->sample_delay1 = delayed[num + 2];
+
+		for (size_t i = 0; i < num; i++) {
+			const float l = lf[i];
+			const float h = delayed[i] - hf[i];
+			const float m = delayed[i] - (h + l);
+
+			samples[i] = l * low_gain + m * mid_gain + h * high_gain;
+		}
 
-	return l + m + h;
+		samples += num;
+		frames -= num;
+	}
 }
 
 static struct obs_audio_data *eq_filter_audio(void *data, struct obs_audio_data *audio)
@@ -131,14 +135,8 @@ static struct obs_audio_data *eq_filter_audio(void *data, struct obs_audio_data
 	struct eq_data *eq = data;
 	const uint32_t frames = audio->frames;
 
-	for (size_t c = 0; c < eq->channels; c++) {
-		float *adata = (float *)audio->data[c];
-		struct eq_channel_state *channel = &eq->eqs[c];
-
-		for (size_t i = 0; i < frames; i++) {
-			adata[i] = eq_process(eq, channel, adata[i]);
-		}
-	}
+	for (size_t c = 0; c < eq->channels; c++)
+		eq_process(eq, &eq->eqs[c], (float *)audio->data[c], frames);
 
 	return audio;
 }
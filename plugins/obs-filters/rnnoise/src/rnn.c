@@ -76,22 +76,36 @@ static OPUS_INLINE float relu(float x)
    return x < 0 ? 0 : x;
 }
 
-static void compute_dense(const DenseLayer *layer, float *output, const float *input)
+/* Weights are stored input-major (all neurons for input 0, then input 1,
+   ...), so accumulate one input at a time across every neuron.  This walks
+   the weights contiguously and lets the compiler vectorize the inner loops,
+   while keeping the per-neuron summation order of the original code. */
+static OPUS_INLINE void accumulate_weights(float *sum, const rnn_weight *weights, int stride, int n,
+                                           const float *input, int m)
 {
    int i, j;
+   for (j=0;j<m;j++)
+   {
+      const rnn_weight *w = &weights[j*stride];
+      float x = input[j];
+      for (i=0;i<n;i++)
+         sum[i] += w[i]*x;
+   }
+}
+
+static void compute_dense(const DenseLayer *layer, float *output, const float *input)
+{
+   int i;
    int N, M;
    int stride;
    M = layer->nb_inputs;
    N = layer->nb_neurons;
    stride = N;
    for (i=0;i<N;i++)
-   {
-      /* Compute update gate. */
-      float sum = layer->bias[i];
-      for (j=0;j<M;j++)
-         sum += layer->input_weights[j*stride + i]*input[j];
-      output[i] = WEIGHTS_SCALE*sum;
-   }
+      output[i] = layer->bias[i];
+   accumulate_weights(output, layer->input_weights, stride, N, input, M);
+   for (i=0;i<N;i++)
+      output[i] *= WEIGHTS_SCALE;
    if (layer->activation == ACTIVATION_SIGMOID) {
       for (i=0;i<N;i++)
          output[i] = sigmoid_approx(output[i]);
@@ -111,45 +125,39 @@ static void compute_gru(const GRULayer *gru, float *state, const float *input)
    int i, j;
    int N, M;
    int stride;
-   float z[MAX_NEURONS];
-   float r[MAX_NEURONS];
+   float sum[3*MAX_NEURONS];
+   float *z, *r;
    float h[MAX_NEURONS];
    M = gru->nb_inputs;
    N = gru->nb_neurons;
    stride = 3*N;
-   for (i=0;i<N;i++)
+   z = sum;
+   r = sum + N;
+   /* Update gate, reset gate and output share the same input weight rows,
+      so all three are accumulated in a single pass over the input. */
+   for (i=0;i<3*N;i++)
+      sum[i] = gru->bias[i];
+   accumulate_weights(sum, gru->input_weights, stride, 3*N, input, M);
+   accumulate_weights(sum, gru->recurrent_weights, stride, 2*N, state, N);
+   for (i=0;i<2*N;i++)
+      sum[i] = sigmoid_approx(WEIGHTS_SCALE*sum[i]);
+   for (j=0;j<N;j++)
    {
-      /* Compute update gate. */
-      float sum = gru->bias[i];
-      for (j=0;j<M;j++)
-         sum += gru->input_weights[j*stride + i]*input[j];
-      for (j=0;j<N;j++)
-         sum += gru->recurrent_weights[j*stride + i]*state[j];
-      z[i] = sigmoid_approx(WEIGHTS_SCALE*sum);
-   }
-   for (i=0;i<N;i++)
-   {
-      /* Compute reset gate. */
-      float sum = gru->bias[N + i];
-      for (j=0;j<M;j++)
-         sum += gru->input_weights[N + j*stride + i]*input[j];
-      for (j=0;j<N;j++)
-         sum += gru->recurrent_weights[N + j*stride + i]*state[j];
-      r[i] = sigmoid_approx(WEIGHTS_SCALE*sum);
+      const rnn_weight *w = &gru->recurrent_weights[2*N + j*stride];
+      float s = state[j];
+      float g = r[j];
+      for (i=0;i<N;i++)
+         sum[2*N + i] += w[i]*s*g;
    }
    for (i=0;i<N;i++)
    {
       /* Compute output. */
-      float sum = gru->bias[2*N + i];
-      for (j=0;j<M;j++)
-         sum += gru->input_weights[2*N + j*stride + i]*input[j];
-      for (j=0;j<N;j++)
-         sum += gru->recurrent_weights[2*N + j*stride + i]*state[j]*r[j];
-      if (gru->activation == ACTIVATION_SIGMOID) sum = sigmoid_approx(WEIGHTS_SCALE*sum);
-      else if (gru->activation == ACTIVATION_TANH) sum = tansig_approx(WEIGHTS_SCALE*sum);
-      else if (gru->activation == ACTIVATION_RELU) sum = relu(WEIGHTS_SCALE*sum);
+      float out = sum[2*N + i];
+      if (gru->activation == ACTIVATION_SIGMOID) out = sigmoid_approx(WEIGHTS_SCALE*out);
+      else if (gru->activation == ACTIVATION_TANH) out = tansig_approx(WEIGHTS_SCALE*out);
+      else if (gru->activation == ACTIVATION_RELU) out = relu(WEIGHTS_SCALE*out);
       else *(int*)0=0;
-      h[i] = z[i]*state[i] + (1-z[i])*sum;
+      h[i] = z[i]*state[i] + (1-z[i])*out;
    }
    for (i=0;i<N;i++)
       state[i] = h[i];
@@ -0,0 +1,520 @@
+/******************************************************************************
+Copyright (C) 2026 by agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <util/threading.h>
+#include <util/platform.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include "file-watcher.h"
+#include "text-freetype2.h"
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+/* writers often update a file in several steps, so wait for it to go quiet
+ * before reading, but not forever for one that is written continuously */
+#define SETTLE_NS 50000000ULL
+#define MAX_DELAY_NS 250000000ULL
+#define POLL_INTERVAL_NS 1000000000ULL
+
+struct file_watch {
+	uint64_t id;
+	char *path;
+	const char *name;
+	bool log_mode;
+	uint32_t log_lines;
+
+	int wd;
+	time_t timestamp;
+	uint64_t last_poll;
+
+	bool changed;
+	uint64_t first_event;
+	uint64_t last_event;
+
+	wchar_t *text;
+	volatile bool has_text;
+
+	/* set if the watcher thread could not be started, in which case the
+	 * file is checked from the source tick instead */
+	volatile bool poll_on_tick;
+};
+
+struct pending_load {
+	uint64_t id;
+	char *path;
+	bool log_mode;
+	uint32_t log_lines;
+};
+
+static pthread_mutex_t watcher_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct {
+	DARRAY(struct file_watch *) watches;
+	uint64_t next_id;
+
+	pthread_t thread;
+	bool thread_active;
+	volatile bool stop;
+
+#ifdef __linux__
+	int inotify_fd;
+	int wake_fd;
+#else
+	os_event_t *wake_event;
+#endif
+} watcher;
+
+static void mark_changed(struct file_watch *watch, uint64_t now)
+{
+	if (!watch->changed)
+		watch->first_event = now;
+	watch->last_event = now;
+	watch->changed = true;
+}
+
+static void wake_watcher(void)
+{
+#ifdef __linux__
+	uint64_t val = 1;
+	if (write(watcher.wake_fd, &val, sizeof(val)) < 0)
+		blog(LOG_DEBUG, "FT2-text: Failed to wake file watcher");
+#else
+	os_event_signal(watcher.wake_event);
+#endif
+}
+
+/* how long the thread may sleep before something needs looking at */
+static uint64_t get_wait_ns(uint64_t now)
+{
+	uint64_t wait = UINT64_MAX;
+
+	for (size_t i = 0; i < watcher.watches.num; i++) {
+		const struct file_watch *watch = watcher.watches.array[i];
+		uint64_t next = UINT64_MAX;
+
+		if (watch->changed) {
+			const uint64_t settled = watch->last_event + SETTLE_NS;
+			const uint64_t overdue = watch->first_event + MAX_DELAY_NS;
+			next = settled < overdue ? settled : overdue;
+		} else if (watch->path && watch->wd < 0 && !watch->poll_on_tick) {
+			next = watch->last_poll + POLL_INTERVAL_NS;
+		}
+
+		if (next != UINT64_MAX) {
+			next = next > now ? next - now : 0;
+			if (next < wait)
+				wait = next;
+		}
+	}
+
+	return wait;
+}
+
+#ifdef __linux__
+static void add_inotify_watch(struct file_watch *watch)
+{
+	struct dstr dir = {0};
+
+	watch->wd = -1;
+	if (watcher.inotify_fd < 0)
+		return;
+
+	/* watch the directory rather than the file, so files that get replaced
+	 * by renaming a new one over them keep being followed */
+	if (watch->name != watch->path)
+		dstr_ncopy(&dir, watch->path, watch->name - watch->path);
+	else
+		dstr_copy(&dir, ".");
+
+	watch->wd = inotify_add_watch(watcher.inotify_fd, dir.array,
+				      IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE);
+	if (watch->wd < 0)
+		blog(LOG_DEBUG, "FT2-text: Could not watch '%s', polling it instead", dir.array);
+
+	dstr_free(&dir);
+}
+
+static void remove_inotify_watch(struct file_watch *watch)
+{
+	const int wd = watch->wd;
+
+	if (wd < 0)
+		return;
+
+	watch->wd = -1;
+
+	/* watches on the same directory share a descriptor */
+	for (size_t i = 0; i < watcher.watches.num; i++) {
+		if (watcher.watches.array[i]->wd == wd)
+			return;
+	}
+
+	inotify_rm_watch(watcher.inotify_fd, wd);
+}
+
+static void read_inotify_events(void)
+{
+	char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	const uint64_t now = os_gettime_ns();
+	ssize_t len;
+
+	while ((len = read(watcher.inotify_fd, buf, sizeof(buf))) > 0) {
+		char *ptr = buf;
+
+		pthread_mutex_lock(&watcher_mutex);
+
+		while (ptr < buf + len) {
+			const struct inotify_event *event = (const struct inotify_event *)ptr;
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			if (!event->len)
+				continue;
+
+			for (size_t i = 0; i < watcher.watches.num; i++) {
+				struct file_watch *watch = watcher.watches.array[i];
+
+				if (watch->path && watch->wd == event->wd && strcmp(watch->name, event->name) == 0)
+					mark_changed(watch, now);
+			}
+		}
+
+		pthread_mutex_unlock(&watcher_mutex);
+	}
+}
+
+static void wait_for_events(uint64_t wait_ns)
+{
+	struct pollfd fds[2] = {
+		{.fd = watcher.inotify_fd, .events = POLLIN},
+		{.fd = watcher.wake_fd, .events = POLLIN},
+	};
+	int timeout = wait_ns == UINT64_MAX ? -1 : (int)((wait_ns + 999999) / 1000000);
+
+	if (poll(fds, 2, timeout) <= 0)
+		return;
+
+	if (fds[0].revents & POLLIN)
+		read_inotify_events();
+	if (fds[1].revents & POLLIN) {
+		uint64_t val;
+		if (read(watcher.wake_fd, &val, sizeof(val)) < 0)
+			blog(LOG_DEBUG, "FT2-text: Failed to reset file watcher wakeup");
+	}
+}
+#else
+static inline void add_inotify_watch(struct file_watch *watch)
+{
+	watch->wd = -1;
+}
+
+static inline void remove_inotify_watch(struct file_watch *watch)
+{
+	UNUSED_PARAMETER(watch);
+}
+
+static void wait_for_events(uint64_t wait_ns)
+{
+	unsigned long ms = wait_ns == UINT64_MAX ? 1000 : (unsigned long)((wait_ns + 999999) / 1000000);
+	os_event_timedwait(watcher.wake_event, ms);
+}
+#endif
+
+static void poll_timestamps(uint64_t now)
+{
+	for (size_t i = 0; i < watcher.watches.num; i++) {
+		struct file_watch *watch = watcher.watches.array[i];
+
+		if (!watch->path || watch->wd >= 0 || watch->poll_on_tick || now - watch->last_poll < POLL_INTERVAL_NS)
+			continue;
+
+		time_t t = get_modified_timestamp(watch->path);
+		watch->last_poll = now;
+
+		if (watch->timestamp != t) {
+			watch->timestamp = t;
+			mark_changed(watch, now);
+		}
+	}
+}
+
+static struct file_watch *find_watch(uint64_t id)
+{
+	for (size_t i = 0; i < watcher.watches.num; i++) {
+		if (watcher.watches.array[i]->id == id)
+			return watcher.watches.array[i];
+	}
+
+	return NULL;
+}
+
+static void load_changed_files(void)
+{
+	DARRAY(struct pending_load) loads = {0};
+	const uint64_t now = os_gettime_ns();
+
+	pthread_mutex_lock(&watcher_mutex);
+
+	poll_timestamps(now);
+
+	for (size_t i = 0; i < watcher.watches.num; i++) {
+		struct file_watch *watch = watcher.watches.array[i];
+
+		if (!watch->changed)
+			continue;
+		if (now - watch->last_event < SETTLE_NS && now - watch->first_event < MAX_DELAY_NS)
+			continue;
+
+		struct pending_load *load = da_push_back_new(loads);
+		load->id = watch->id;
+		load->path = bstrdup(watch->path);
+		load->log_mode = watch->log_mode;
+		load->log_lines = watch->log_lines;
+		watch->changed = false;
+	}
+
+	pthread_mutex_unlock(&watcher_mutex);
+
+	/* read and decode without holding the lock; the source may have gone
+	 * away in the meantime, hence looking it up again by id */
+	for (size_t i = 0; i < loads.num; i++) {
+		struct pending_load *load = loads.array + i;
+		wchar_t *text = load->log_mode ? read_text_file_end(load->path, load->log_lines)
+					       : load_text_file(load->path);
+
+		/* the file may be missing for a moment while it is being
+		 * replaced; keep showing the old text until it is back */
+		if (text) {
+			pthread_mutex_lock(&watcher_mutex);
+
+			struct file_watch *watch = find_watch(load->id);
+			if (watch) {
+				bfree(watch->text);
+				watch->text = text;
+				os_atomic_set_bool(&watch->has_text, true);
+				text = NULL;
+			}
+
+			pthread_mutex_unlock(&watcher_mutex);
+			bfree(text);
+		}
+
+		bfree(load->path);
+	}
+
+	da_free(loads);
+}
+
+static void *watcher_thread(void *unused)
+{
+	os_set_thread_name("ft2: file watcher");
+
+	while (!os_atomic_load_bool(&watcher.stop)) {
+		pthread_mutex_lock(&watcher_mutex);
+		uint64_t wait_ns = get_wait_ns(os_gettime_ns());
+		pthread_mutex_unlock(&watcher_mutex);
+
+		wait_for_events(wait_ns);
+		load_changed_files();
+	}
+
+	UNUSED_PARAMETER(unused);
+	return NULL;
+}
+
+static bool start_watcher(void)
+{
+#ifdef __linux__
+	watcher.inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (watcher.inotify_fd < 0)
+		blog(LOG_WARNING, "FT2-text: inotify unavailable, falling back to polling text files");
+
+	watcher.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (watcher.wake_fd < 0)
+		goto fail;
+#else
+	if (os_event_init(&watcher.wake_event, OS_EVENT_TYPE_AUTO) != 0)
+		goto fail;
+#endif
+
+	watcher.stop = false;
+	if (pthread_create(&watcher.thread, NULL, watcher_thread, NULL) != 0)
+		goto fail;
+
+	watcher.thread_active = true;
+	return true;
+
+fail:
+	blog(LOG_WARNING, "FT2-text: Failed to start file watcher");
+#ifdef __linux__
+	if (watcher.inotify_fd >= 0)
+		close(watcher.inotify_fd);
+	if (watcher.wake_fd >= 0)
+		close(watcher.wake_fd);
+	watcher.inotify_fd = -1;
+	watcher.wake_fd = -1;
+#else
+	os_event_destroy(watcher.wake_event);
+	watcher.wake_event = NULL;
+#endif
+	return false;
+}
+
+struct file_watch *file_watch_create(void)
+{
+	struct file_watch *watch = bzalloc(sizeof(struct file_watch));
+	watch->wd = -1;
+
+	pthread_mutex_lock(&watcher_mutex);
+	da_push_back(watcher.watches, &watch);
+	pthread_mutex_unlock(&watcher_mutex);
+
+	return watch;
+}
+
+void file_watch_set_file(struct file_watch *watch, const char *path, bool log_mode, uint32_t log_lines)
+{
+	if (!watch)
+		return;
+
+	pthread_mutex_lock(&watcher_mutex);
+
+	remove_inotify_watch(watch);
+	bfree(watch->path);
+	bfree(watch->text);
+
+	/* a new id makes the thread drop any load of the old file that is
+	 * still in flight */
+	watch->id = ++watcher.next_id;
+	watch->path = NULL;
+	watch->name = NULL;
+	watch->text = NULL;
+	watch->changed = false;
+	os_atomic_set_bool(&watch->has_text, false);
+
+	if (path) {
+		const char *slash;
+
+		watch->path = bstrdup(path);
+		watch->log_mode = log_mode;
+		watch->log_lines = log_lines;
+		watch->timestamp = get_modified_timestamp(watch->path);
+		watch->last_poll = os_gettime_ns();
+
+		slash = strrchr(watch->path, '/');
+		watch->name = slash ? slash + 1 : watch->path;
+
+		if (watcher.thread_active || start_watcher())
+			add_inotify_watch(watch);
+	}
+
+	const bool wake = watch->path && watcher.thread_active;
+	os_atomic_set_bool(&watch->poll_on_tick, watch->path && !watcher.thread_active);
+
+	pthread_mutex_unlock(&watcher_mutex);
+
+	if (wake)
+		wake_watcher();
+}
+
+void file_watch_destroy(struct file_watch *watch)
+{
+	if (!watch)
+		return;
+
+	pthread_mutex_lock(&watcher_mutex);
+	da_erase_item(watcher.watches, &watch);
+	remove_inotify_watch(watch);
+	pthread_mutex_unlock(&watcher_mutex);
+
+	bfree(watch->text);
+	bfree(watch->path);
+	bfree(watch);
+}
+
+/* Without a watcher thread, check the file once a second and load it right
+ * away, like text sources did before the thread existed */
+static wchar_t *poll_file(struct file_watch *watch)
+{
+	const uint64_t now = os_gettime_ns();
+
+	if (!watch->path || now - watch->last_poll < POLL_INTERVAL_NS)
+		return NULL;
+
+	time_t t = get_modified_timestamp(watch->path);
+	watch->last_poll = now;
+
+	if (watch->timestamp == t)
+		return NULL;
+
+	watch->timestamp = t;
+	return watch->log_mode ? read_text_file_end(watch->path, watch->log_lines) : load_text_file(watch->path);
+}
+
+wchar_t *file_watch_get_text(struct file_watch *watch)
+{
+	wchar_t *text;
+
+	if (!watch)
+		return NULL;
+
+	if (os_atomic_load_bool(&watch->poll_on_tick)) {
+		pthread_mutex_lock(&watcher_mutex);
+		text = poll_file(watch);
+		pthread_mutex_unlock(&watcher_mutex);
+		return text;
+	}
+
+	/* called every tick, so skip the lock unless there is something new */
+	if (!os_atomic_load_bool(&watch->has_text))
+		return NULL;
+
+	pthread_mutex_lock(&watcher_mutex);
+	text = watch->text;
+	watch->text = NULL;
+	os_atomic_set_bool(&watch->has_text, false);
+	pthread_mutex_unlock(&watcher_mutex);
+
+	return text;
+}
+
+void file_watcher_free(void)
+{
+	if (!watcher.thread_active)
+		return;
+
+	os_atomic_set_bool(&watcher.stop, true);
+	wake_watcher();
+	pthread_join(watcher.thread, NULL);
+
+#ifdef __linux__
+	if (watcher.inotify_fd >= 0)
+		close(watcher.inotify_fd);
+	close(watcher.wake_fd);
+#else
+	os_event_destroy(watcher.wake_event);
+#endif
+
+	da_free(watcher.watches);
+	memset(&watcher, 0, sizeof(watcher));
+}
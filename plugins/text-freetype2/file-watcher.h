@@ -0,0 +1,41 @@
+/******************************************************************************
+Copyright (C) 2026 by agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <obs-module.h>
+
+/*
+ * Watches the files text sources read from and loads them on a thread shared
+ * by all sources, so the source tick only has to pick up text that is already
+ * decoded.  Uses inotify where available and falls back to checking the
+ * modification time once a second otherwise.
+ */
+
+struct file_watch;
+
+extern struct file_watch *file_watch_create(void);
+extern void file_watch_destroy(struct file_watch *watch);
+
+/* Starts following path, or stops watching altogether if path is NULL */
+extern void file_watch_set_file(struct file_watch *watch, const char *path, bool log_mode, uint32_t log_lines);
+
+/* Returns the text loaded since the last call, or NULL if the file has not
+ * changed.  The caller takes ownership of the returned string. */
+extern wchar_t *file_watch_get_text(struct file_watch *watch);
+
+extern void file_watcher_free(void);
@@ -0,0 +1,474 @@
+/******************************************************************************
+Copyright (C) 2026 by agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <util/darray.h>
+#include <util/threading.h>
+#include "glyph-atlas.h"
+#include "text-freetype2.h"
+
+#define ATLAS_SIZE 2048
+#define STAGING_ROWS 64
+#define GLYPH_PADDING 1
+#define NO_SHELF ((size_t)-1)
+
+struct atlas_glyph {
+	/* must stay first; sources only ever see this part */
+	struct glyph_info info;
+
+	struct glyph_atlas_font *font;
+	FT_UInt index;
+	long refs;
+	size_t shelf;
+};
+
+struct atlas_shelf {
+	uint32_t x, y, h;
+	uint64_t last_used;
+	DARRAY(struct atlas_glyph *) glyphs;
+};
+
+struct glyph_atlas_font {
+	char *path;
+	FT_Long face_index;
+	uint16_t size;
+	FT_Render_Mode render_mode;
+	long refs;
+
+	struct atlas_glyph *glyphs[num_cache_slots];
+};
+
+/* Text sources are ticked from within the graphics context, so anything that
+ * needs both has to enter graphics before taking the atlas mutex */
+static pthread_mutex_t atlas_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct {
+	DARRAY(struct glyph_atlas_font *) fonts;
+	DARRAY(struct atlas_shelf) shelves;
+	uint32_t next_y;
+	uint64_t clock;
+
+	uint8_t *texbuf;
+	gs_texture_t *tex;
+	gs_texture_t *staging;
+
+	bool dirty;
+	uint32_t dirty_x, dirty_y, dirty_x2, dirty_y2;
+
+	uint64_t hits;
+	uint64_t rasterized;
+	uint64_t evicted;
+	uint64_t upload_bytes;
+} atlas;
+
+static void mark_dirty(uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+{
+	if (!atlas.dirty) {
+		atlas.dirty_x = x;
+		atlas.dirty_y = y;
+		atlas.dirty_x2 = x + w;
+		atlas.dirty_y2 = y + h;
+		atlas.dirty = true;
+		return;
+	}
+
+	if (x < atlas.dirty_x)
+		atlas.dirty_x = x;
+	if (y < atlas.dirty_y)
+		atlas.dirty_y = y;
+	if (x + w > atlas.dirty_x2)
+		atlas.dirty_x2 = x + w;
+	if (y + h > atlas.dirty_y2)
+		atlas.dirty_y2 = y + h;
+}
+
+static inline void touch_shelf(size_t shelf)
+{
+	if (shelf != NO_SHELF)
+		atlas.shelves.array[shelf].last_used = ++atlas.clock;
+}
+
+/* Clears whatever was packed into the shelf so that stale pixels cannot
+ * bleed into glyphs placed next to the padding later on */
+static void reset_shelf(struct atlas_shelf *shelf)
+{
+	if (shelf->x) {
+		for (uint32_t y = 0; y < shelf->h; y++)
+			memset(atlas.texbuf + (size_t)(shelf->y + y) * ATLAS_SIZE, 0, shelf->x);
+		mark_dirty(0, shelf->y, shelf->x, shelf->h);
+	}
+
+	shelf->x = 0;
+}
+
+static void remove_glyph(struct atlas_glyph *glyph)
+{
+	if (glyph->shelf != NO_SHELF) {
+		struct atlas_shelf *shelf = atlas.shelves.array + glyph->shelf;
+
+		da_erase_item(shelf->glyphs, &glyph);
+		if (!shelf->glyphs.num)
+			reset_shelf(shelf);
+	}
+
+	glyph->font->glyphs[glyph->index] = NULL;
+	bfree(glyph);
+}
+
+static bool shelf_in_use(const struct atlas_shelf *shelf)
+{
+	for (size_t i = 0; i < shelf->glyphs.num; i++) {
+		if (shelf->glyphs.array[i]->refs > 0)
+			return true;
+	}
+
+	return false;
+}
+
+static void evict_shelf(struct atlas_shelf *shelf)
+{
+	for (size_t i = 0; i < shelf->glyphs.num; i++) {
+		struct atlas_glyph *glyph = shelf->glyphs.array[i];
+
+		glyph->font->glyphs[glyph->index] = NULL;
+		bfree(glyph);
+	}
+
+	atlas.evicted += shelf->glyphs.num;
+	da_resize(shelf->glyphs, 0);
+	reset_shelf(shelf);
+}
+
+static size_t find_shelf(uint32_t w, uint32_t h)
+{
+	/* round shelf heights up so that glyphs of similar size can share */
+	const uint32_t shelf_h = (h + 3) & ~3u;
+	size_t best = NO_SHELF;
+
+	if (w + GLYPH_PADDING > ATLAS_SIZE || h > ATLAS_SIZE)
+		return NO_SHELF;
+
+	for (size_t i = 0; i < atlas.shelves.num; i++) {
+		const struct atlas_shelf *shelf = atlas.shelves.array + i;
+
+		if (shelf->h < h || shelf->h > shelf_h + shelf_h / 2)
+			continue;
+		if (shelf->x + w + GLYPH_PADDING > ATLAS_SIZE)
+			continue;
+		if (best == NO_SHELF || shelf->h < atlas.shelves.array[best].h)
+			best = i;
+	}
+
+	if (best != NO_SHELF)
+		return best;
+
+	if (atlas.next_y + shelf_h <= ATLAS_SIZE) {
+		struct atlas_shelf *shelf = da_push_back_new(atlas.shelves);
+		shelf->y = atlas.next_y;
+		shelf->h = shelf_h;
+		atlas.next_y += shelf_h + GLYPH_PADDING;
+		return atlas.shelves.num - 1;
+	}
+
+	/* out of room; reuse the least recently used shelf that no source is
+	 * drawing from anymore */
+	for (size_t i = 0; i < atlas.shelves.num; i++) {
+		const struct atlas_shelf *shelf = atlas.shelves.array + i;
+
+		if (shelf->h < h || shelf_in_use(shelf))
+			continue;
+		if (best == NO_SHELF || shelf->last_used < atlas.shelves.array[best].last_used)
+			best = i;
+	}
+
+	if (best != NO_SHELF)
+		evict_shelf(atlas.shelves.array + best);
+
+	return best;
+}
+
+static uint8_t get_pixel_value(const unsigned char *buf_row, FT_Render_Mode render_mode, const uint32_t x)
+{
+	if (render_mode == FT_RENDER_MODE_NORMAL) {
+		return buf_row[x];
+	}
+
+	const uint32_t byte_index = x / 8;
+	const uint8_t bit_index = x % 8;
+	const bool pixel_set = (buf_row[byte_index] >> (7 - bit_index)) & 1;
+	return pixel_set ? 255 : 0;
+}
+
+static void rasterize(FT_GlyphSlot slot, const FT_Render_Mode render_mode, const uint32_t dx, const uint32_t dy)
+{
+	/**
+	 * The pitch's absolute value is the number of bytes taken by one bitmap
+	 * row, including padding.
+	 *
+	 * Source: https://www.freetype.org/freetype2/docs/reference/ft2-basic_types.html
+	 */
+	const int pitch = abs(slot->bitmap.pitch);
+
+	for (uint32_t y = 0; y < slot->bitmap.rows; y++) {
+		const uint32_t row_start = y * pitch;
+		uint8_t *row = atlas.texbuf + (size_t)(dy + y) * ATLAS_SIZE + dx;
+
+		for (uint32_t x = 0; x < slot->bitmap.width; x++)
+			row[x] = get_pixel_value(&slot->bitmap.buffer[row_start], render_mode, x);
+	}
+}
+
+static void free_atlas(void)
+{
+	blog(LOG_INFO,
+	     "FT2-text: glyph atlas released: %" PRIu64 " shared hits, %" PRIu64 " glyphs rasterized, %" PRIu64
+	     " evicted, %" PRIu64 " bytes uploaded",
+	     atlas.hits, atlas.rasterized, atlas.evicted, atlas.upload_bytes);
+
+	gs_texture_destroy(atlas.tex);
+	gs_texture_destroy(atlas.staging);
+
+	for (size_t i = 0; i < atlas.shelves.num; i++)
+		da_free(atlas.shelves.array[i].glyphs);
+	da_free(atlas.shelves);
+	da_free(atlas.fonts);
+	bfree(atlas.texbuf);
+
+	memset(&atlas, 0, sizeof(atlas));
+}
+
+struct glyph_atlas_font *glyph_atlas_get_font(const char *path, FT_Long face_index, uint16_t size,
+					      FT_Render_Mode render_mode)
+{
+	struct glyph_atlas_font *font = NULL;
+
+	pthread_mutex_lock(&atlas_mutex);
+
+	for (size_t i = 0; i < atlas.fonts.num; i++) {
+		struct glyph_atlas_font *cur = atlas.fonts.array[i];
+
+		if (cur->face_index == face_index && cur->size == size && cur->render_mode == render_mode &&
+		    strcmp(cur->path, path) == 0) {
+			font = cur;
+			break;
+		}
+	}
+
+	if (!font) {
+		font = bzalloc(sizeof(struct glyph_atlas_font));
+		font->path = bstrdup(path);
+		font->face_index = face_index;
+		font->size = size;
+		font->render_mode = render_mode;
+		da_push_back(atlas.fonts, &font);
+
+		if (!atlas.texbuf)
+			atlas.texbuf = bzalloc((size_t)ATLAS_SIZE * ATLAS_SIZE);
+	}
+
+	font->refs++;
+
+	pthread_mutex_unlock(&atlas_mutex);
+	return font;
+}
+
+void glyph_atlas_release_font(struct glyph_atlas_font *font)
+{
+	if (!font)
+		return;
+
+	obs_enter_graphics();
+	pthread_mutex_lock(&atlas_mutex);
+
+	if (--font->refs == 0) {
+		for (uint32_t i = 0; i < num_cache_slots; i++) {
+			if (font->glyphs[i])
+				remove_glyph(font->glyphs[i]);
+		}
+
+		da_erase_item(atlas.fonts, &font);
+		bfree(font->path);
+		bfree(font);
+
+		if (!atlas.fonts.num)
+			free_atlas();
+	}
+
+	pthread_mutex_unlock(&atlas_mutex);
+	obs_leave_graphics();
+}
+
+struct glyph_info *glyph_atlas_find(struct glyph_atlas_font *font, FT_UInt glyph_index)
+{
+	struct atlas_glyph *glyph;
+
+	pthread_mutex_lock(&atlas_mutex);
+
+	glyph = font->glyphs[glyph_index];
+	if (glyph) {
+		glyph->refs++;
+		touch_shelf(glyph->shelf);
+		atlas.hits++;
+	}
+
+	pthread_mutex_unlock(&atlas_mutex);
+	return glyph ? &glyph->info : NULL;
+}
+
+struct glyph_info *glyph_atlas_insert(struct glyph_atlas_font *font, FT_UInt glyph_index, FT_GlyphSlot slot)
+{
+	const uint32_t g_w = slot->bitmap.width;
+	const uint32_t g_h = slot->bitmap.rows;
+	struct atlas_glyph *glyph;
+	size_t shelf = NO_SHELF;
+
+	pthread_mutex_lock(&atlas_mutex);
+
+	/* another source using the same font may have got here first */
+	glyph = font->glyphs[glyph_index];
+	if (glyph) {
+		glyph->refs++;
+		touch_shelf(glyph->shelf);
+		goto done;
+	}
+
+	/* glyphs without a bitmap (spaces) only need their metrics */
+	if (g_w && g_h) {
+		shelf = find_shelf(g_w, g_h);
+		if (shelf == NO_SHELF)
+			goto done;
+	}
+
+	glyph = bzalloc(sizeof(struct atlas_glyph));
+	glyph->font = font;
+	glyph->index = glyph_index;
+	glyph->refs = 1;
+	glyph->shelf = shelf;
+	glyph->info.w = g_w;
+	glyph->info.h = g_h;
+	glyph->info.yoff = slot->bitmap_top;
+	glyph->info.xoff = slot->bitmap_left;
+	glyph->info.xadv = slot->advance.x >> 6;
+
+	if (shelf != NO_SHELF) {
+		struct atlas_shelf *s = atlas.shelves.array + shelf;
+		const uint32_t dx = s->x;
+		const uint32_t dy = s->y;
+
+		glyph->info.u = (float)dx / (float)ATLAS_SIZE;
+		glyph->info.u2 = (float)(dx + g_w) / (float)ATLAS_SIZE;
+		glyph->info.v = (float)dy / (float)ATLAS_SIZE;
+		glyph->info.v2 = (float)(dy + g_h) / (float)ATLAS_SIZE;
+
+		rasterize(slot, font->render_mode, dx, dy);
+		mark_dirty(dx, dy, g_w, g_h);
+
+		s->x += g_w + GLYPH_PADDING;
+		da_push_back(s->glyphs, &glyph);
+		touch_shelf(shelf);
+	}
+
+	font->glyphs[glyph_index] = glyph;
+	atlas.rasterized++;
+
+done:
+	pthread_mutex_unlock(&atlas_mutex);
+	return glyph ? &glyph->info : NULL;
+}
+
+void glyph_atlas_release_glyph(struct glyph_atlas_font *font, FT_UInt glyph_index)
+{
+	pthread_mutex_lock(&atlas_mutex);
+
+	/* unreferenced glyphs stay cached until their shelf gets evicted */
+	struct atlas_glyph *glyph = font->glyphs[glyph_index];
+	if (glyph && glyph->refs > 0)
+		glyph->refs--;
+
+	pthread_mutex_unlock(&atlas_mutex);
+}
+
+/* Returns false if part of the dirty region could not be uploaded, in which
+ * case only that part is left dirty to be retried on the next flush */
+static bool upload_dirty_region(void)
+{
+	const uint32_t x = atlas.dirty_x;
+	const uint32_t w = atlas.dirty_x2 - atlas.dirty_x;
+
+	if (!atlas.staging)
+		atlas.staging = gs_texture_create(ATLAS_SIZE, STAGING_ROWS, GS_A8, 1, NULL, GS_DYNAMIC);
+	if (!atlas.staging)
+		return false;
+
+	/* copy the dirty rectangle through a small dynamic texture instead of
+	 * re-creating the whole atlas every time a glyph is added */
+	for (uint32_t y = atlas.dirty_y; y < atlas.dirty_y2; y += STAGING_ROWS) {
+		const uint32_t rows = atlas.dirty_y2 - y < STAGING_ROWS ? atlas.dirty_y2 - y : STAGING_ROWS;
+		uint32_t linesize;
+		uint8_t *ptr;
+
+		if (!gs_texture_map(atlas.staging, &ptr, &linesize)) {
+			atlas.dirty_y = y;
+			return false;
+		}
+
+		for (uint32_t row = 0; row < rows; row++)
+			memcpy(ptr + (size_t)row * linesize, atlas.texbuf + (size_t)(y + row) * ATLAS_SIZE + x, w);
+
+		gs_texture_unmap(atlas.staging);
+		gs_copy_texture_region(atlas.tex, x, y, atlas.staging, 0, 0, w, rows);
+
+		atlas.upload_bytes += (uint64_t)w * rows;
+	}
+
+	return true;
+}
+
+void glyph_atlas_flush(void)
+{
+	obs_enter_graphics();
+	pthread_mutex_lock(&atlas_mutex);
+
+	if (atlas.dirty && atlas.texbuf) {
+		bool uploaded;
+
+		if (!atlas.tex) {
+			const uint8_t *data = atlas.texbuf;
+
+			atlas.tex = gs_texture_create(ATLAS_SIZE, ATLAS_SIZE, GS_A8, 1, &data, 0);
+			uploaded = atlas.tex != NULL;
+			if (uploaded)
+				atlas.upload_bytes += (uint64_t)ATLAS_SIZE * ATLAS_SIZE;
+		} else {
+			uploaded = upload_dirty_region();
+		}
+
+		if (uploaded)
+			atlas.dirty = false;
+	}
+
+	pthread_mutex_unlock(&atlas_mutex);
+	obs_leave_graphics();
+}
+
+gs_texture_t *glyph_atlas_get_texture(void)
+{
+	/* only ever created or destroyed inside the graphics context, which
+	 * the caller holds */
+	return atlas.tex;
+}
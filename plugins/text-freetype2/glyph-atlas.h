@@ -0,0 +1,57 @@
+/******************************************************************************
+Copyright (C) 2026 by agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <obs-module.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+/*
+ * Process-wide glyph atlas shared by every FreeType text source.
+ *
+ * Glyphs are keyed by font file, face index, pixel size and render mode, so
+ * sources using the same font share one rasterized copy of each glyph and one
+ * texture.  Glyphs are packed into shelves; when the atlas fills up, the
+ * least recently used shelf whose glyphs are no longer referenced by any
+ * source is evicted.  Only the region touched since the last upload is copied
+ * to the GPU.
+ */
+
+struct glyph_info;
+struct glyph_atlas_font;
+
+/* Returns the shared font entry for the given key, creating it if needed.
+ * Every call must be balanced with glyph_atlas_release_font. */
+extern struct glyph_atlas_font *glyph_atlas_get_font(const char *path, FT_Long face_index, uint16_t size,
+						     FT_Render_Mode render_mode);
+extern void glyph_atlas_release_font(struct glyph_atlas_font *font);
+
+/* Returns an already cached glyph and takes a reference to it, or NULL */
+extern struct glyph_info *glyph_atlas_find(struct glyph_atlas_font *font, FT_UInt glyph_index);
+
+/* Copies the glyph rendered into slot into the atlas and takes a reference
+ * to it.  Returns NULL if there is no room left even after eviction. */
+extern struct glyph_info *glyph_atlas_insert(struct glyph_atlas_font *font, FT_UInt glyph_index, FT_GlyphSlot slot);
+
+extern void glyph_atlas_release_glyph(struct glyph_atlas_font *font, FT_UInt glyph_index);
+
+/* Uploads everything rasterized since the last flush to the atlas texture */
+extern void glyph_atlas_flush(void);
+
+/* Must be called from within the graphics context */
+extern gs_texture_t *glyph_atlas_get_texture(void);
@@ -23,6 +23,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "text-freetype2.h"
 #include "obs-convenience.h"
 #include "find-font.h"
+#include "glyph-atlas.h"
+#include "file-watcher.h"
 
 FT_Library ft2_lib;
 
@@ -33,8 +35,6 @@ MODULE_EXPORT const char *obs_module_description(void)
 	return "FreeType2 text source";
 }
 
-uint32_t texbuf_w = 2048, texbuf_h = 2048;
-
 static const char *ft2_source_get_name(void *unused);
 static void *ft2_source_create(obs_data_t *settings, obs_source_t *source);
 static void ft2_source_destroy(void *data);
@@ -126,6 +126,8 @@ bool obs_module_load()
 
 void obs_module_unload(void)
 {
+	file_watcher_free();
+
 	if (plugin_initialized) {
 		free_os_font_list();
 		FT_Done_FreeType(ft2_lib);
@@ -224,12 +226,9 @@ static void ft2_source_destroy(void *data)
 		srcdata->font_face = NULL;
 	}
 
-	for (uint32_t i = 0; i < num_cache_slots; i++) {
-		if (srcdata->cacheglyphs[i] != NULL) {
-			bfree(srcdata->cacheglyphs[i]);
-			srcdata->cacheglyphs[i] = NULL;
-		}
-	}
+	release_glyphs(srcdata);
+	glyph_atlas_release_font(srcdata->atlas_font);
+	srcdata->atlas_font = NULL;
 
 	if (srcdata->font_name != NULL)
 		bfree(srcdata->font_name);
@@ -237,17 +236,16 @@ static void ft2_source_destroy(void *data)
 		bfree(srcdata->font_style);
 	if (srcdata->text != NULL)
 		bfree(srcdata->text);
-	if (srcdata->texbuf != NULL)
-		bfree(srcdata->texbuf);
+	if (srcdata->font_path != NULL)
+		bfree(srcdata->font_path);
 	if (srcdata->text_file != NULL)
 		bfree(srcdata->text_file);
 
+	file_watch_destroy(srcdata->file_watch);
+	da_free(srcdata->line_starts);
+
 	obs_enter_graphics();
 
-	if (srcdata->tex != NULL) {
-		gs_texture_destroy(srcdata->tex);
-		srcdata->tex = NULL;
-	}
 	if (srcdata->vbuf != NULL) {
 		gs_vertexbuffer_destroy(srcdata->vbuf);
 		srcdata->vbuf = NULL;
@@ -268,7 +266,7 @@ static void ft2_source_render(void *data, gs_effect_t *effect)
 	if (srcdata == NULL)
 		return;
 
-	if (srcdata->tex == NULL || srcdata->vbuf == NULL)
+	if (srcdata->tex == NULL || srcdata->vbuf == NULL || srcdata->num_glyphs == 0)
 		return;
 	if (srcdata->text == NULL || *srcdata->text == 0)
 		return;
@@ -279,7 +277,7 @@ static void ft2_source_render(void *data, gs_effect_t *effect)
 	if (srcdata->drop_shadow)
 		draw_drop_shadow(srcdata);
 
-	draw_uv_vbuffer(srcdata->vbuf, srcdata->tex, srcdata->draw_effect, (uint32_t)wcslen(srcdata->text) * 6, true);
+	draw_uv_vbuffer(srcdata->vbuf, srcdata->tex, srcdata->draw_effect, srcdata->num_glyphs * 6, true);
 
 	UNUSED_PARAMETER(effect);
 }
@@ -289,27 +287,16 @@ static void ft2_video_tick(void *data, float seconds)
 	struct ft2_source *srcdata = data;
 	if (srcdata == NULL)
 		return;
-	if (!srcdata->from_file || !srcdata->text_file)
-		return;
-
-	if (os_gettime_ns() - srcdata->last_checked >= 1000000000) {
-		time_t t = get_modified_timestamp(srcdata->text_file);
-		srcdata->last_checked = os_gettime_ns();
 
-		if (srcdata->update_file) {
-			if (srcdata->log_mode)
-				read_from_end(srcdata, srcdata->text_file);
-			else
-				load_text_from_file(srcdata, srcdata->text_file);
-			cache_glyphs(srcdata, srcdata->text);
-			set_up_vertex_buffer(srcdata);
-			srcdata->update_file = false;
-		}
+	wchar_t *text = file_watch_get_text(srcdata->file_watch);
+	if (text) {
+		wchar_t *old_text = srcdata->text;
+		const uint32_t old_max_h = srcdata->max_h;
 
-		if (srcdata->m_timestamp != t) {
-			srcdata->m_timestamp = t;
-			srcdata->update_file = true;
-		}
+		srcdata->text = text;
+		cache_glyphs(srcdata, srcdata->text);
+		update_vertex_buffer(srcdata, old_text, old_max_h);
+		bfree(old_text);
 	}
 
 	UNUSED_PARAMETER(seconds);
@@ -328,6 +315,10 @@ static bool init_font(struct ft2_source *srcdata)
 		srcdata->font_face = NULL;
 	}
 
+	bfree(srcdata->font_path);
+	srcdata->font_path = bstrdup(path);
+	srcdata->font_index = index;
+
 	return FT_New_Face(ft2_lib, path, index, &srcdata->font_face) == 0;
 }
 
@@ -402,8 +393,6 @@ static void ft2_source_update(void *data, obs_data_t *settings)
 	if (ft2_lib == NULL)
 		goto error;
 
-	const size_t texbuf_size = (size_t)texbuf_w * (size_t)texbuf_h;
-
 	if (srcdata->draw_effect == NULL) {
 		char *effect_file = NULL;
 		char *error_string = NULL;
@@ -428,9 +417,6 @@ static void ft2_source_update(void *data, obs_data_t *settings)
 	const bool aa_changed = srcdata->antialiasing != new_aa_setting;
 	if (aa_changed) {
 		srcdata->antialiasing = new_aa_setting;
-		if (srcdata->texbuf != NULL) {
-			memset(srcdata->texbuf, 0, texbuf_size);
-		}
 		cache_standard_glyphs(srcdata);
 	}
 
@@ -463,12 +449,6 @@ static void ft2_source_update(void *data, obs_data_t *settings)
 		FT_Select_Charmap(srcdata->font_face, FT_ENCODING_UNICODE);
 	}
 
-	if (srcdata->texbuf != NULL) {
-		bfree(srcdata->texbuf);
-		srcdata->texbuf = NULL;
-	}
-	srcdata->texbuf = bzalloc(texbuf_size);
-
 	if (srcdata->font_face)
 		cache_standard_glyphs(srcdata);
 
@@ -483,6 +463,7 @@ skip_font_load:
 			srcdata->text = NULL;
 
 			os_utf8_to_wcs_ptr(emptystr, strlen(emptystr), &srcdata->text);
+			file_watch_set_file(srcdata->file_watch, NULL, false, 0);
 			blog(LOG_WARNING,
 			     "FT2-text: Failed to open %s for "
 			     "reading",
@@ -498,9 +479,12 @@ skip_font_load:
 				read_from_end(srcdata, tmp);
 			else
 				load_text_from_file(srcdata, tmp);
-			srcdata->last_checked = os_gettime_ns();
+
+			file_watch_set_file(srcdata->file_watch, tmp, chat_log_mode, log_lines);
 		}
 	} else {
+		file_watch_set_file(srcdata->file_watch, NULL, false, 0);
+
 		const char *tmp = obs_data_get_string(settings, "text");
 		if (!tmp)
 			goto error;
@@ -534,6 +518,7 @@ static void *ft2_source_create(obs_data_t *settings, obs_source_t *source)
 {
 	struct ft2_source *srcdata = bzalloc(sizeof(struct ft2_source));
 	srcdata->src = source;
+	srcdata->file_watch = file_watch_create();
 
 	init_plugin();
 
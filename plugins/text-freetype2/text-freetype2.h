@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <obs-module.h>
+#include <util/darray.h>
 #include <ft2build.h>
 
 #define num_cache_slots 65535
@@ -29,6 +30,16 @@ struct glyph_info {
 	FT_Pos xadv;
 };
 
+/* layout state at the first glyph of a line, so that a change further down
+ * the text only needs the lines from there on laid out again */
+struct ft2_line_start {
+	size_t pos;
+	uint32_t glyph;
+	uint32_t dy, max_y;
+};
+
+struct file_watch;
+
 struct ft2_source {
 	char *font_name;
 	char *font_style;
@@ -40,25 +51,27 @@ struct ft2_source {
 	bool antialiasing;
 	char *text_file;
 	wchar_t *text;
-	time_t m_timestamp;
-	bool update_file;
-	uint64_t last_checked;
+	struct file_watch *file_watch;
 
 	uint32_t cx, cy, max_h, custom_width;
 	uint32_t outline_width;
-	uint32_t texbuf_x, texbuf_y;
 	uint32_t color[2];
 
 	int32_t cur_scroll, scroll_speed;
 
+	/* owned by the shared glyph atlas */
 	gs_texture_t *tex;
 
+	struct glyph_atlas_font *atlas_font;
 	struct glyph_info *cacheglyphs[num_cache_slots];
 
+	char *font_path;
+	FT_Long font_index;
 	FT_Face font_face;
 
-	uint8_t *texbuf;
 	gs_vertbuffer_t *vbuf;
+	uint32_t vbuf_glyphs, num_glyphs;
+	DARRAY(struct ft2_line_start) line_starts;
 
 	gs_effect_t *draw_effect;
 	bool outline_text, drop_shadow;
@@ -76,11 +89,15 @@ void draw_drop_shadow(struct ft2_source *srcdata);
 uint32_t get_ft2_text_width(wchar_t *text, struct ft2_source *srcdata);
 
 time_t get_modified_timestamp(char *filename);
+wchar_t *load_text_file(const char *filename);
+wchar_t *read_text_file_end(const char *filename, uint32_t log_lines);
 void load_text_from_file(struct ft2_source *srcdata, const char *filename);
 void read_from_end(struct ft2_source *srcdata, const char *filename);
 
 void cache_standard_glyphs(struct ft2_source *srcdata);
+void release_glyphs(struct ft2_source *srcdata);
 void cache_glyphs(struct ft2_source *srcdata, wchar_t *cache_glyphs);
 
 void set_up_vertex_buffer(struct ft2_source *srcdata);
-void fill_vertex_buffer(struct ft2_source *srcdata);
+void update_vertex_buffer(struct ft2_source *srcdata, const wchar_t *old_text, uint32_t old_max_h);
+void fill_vertex_buffer(struct ft2_source *srcdata, size_t from);
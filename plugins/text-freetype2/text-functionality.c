@@ -22,12 +22,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <sys/stat.h>
 #include "text-freetype2.h"
 #include "obs-convenience.h"
+#include "glyph-atlas.h"
 
 float offsets[16] = {-2.0f, 0.0f, 0.0f, -2.0f, 2.0f,  0.0f, 2.0f,  0.0f,
 		     0.0f,  2.0f, 0.0f, 2.0f,  -2.0f, 0.0f, -2.0f, 0.0f};
 
-extern uint32_t texbuf_w, texbuf_h;
-
 void draw_outlines(struct ft2_source *srcdata)
 {
 	if (!srcdata->text)
@@ -36,8 +35,7 @@ void draw_outlines(struct ft2_source *srcdata)
 	gs_matrix_push();
 	for (int32_t i = 0; i < 8; i++) {
 		gs_matrix_translate3f(offsets[i * 2], offsets[(i * 2) + 1], 0.0f);
-		draw_uv_vbuffer(srcdata->vbuf, srcdata->tex, srcdata->draw_effect, (uint32_t)wcslen(srcdata->text) * 6,
-				false);
+		draw_uv_vbuffer(srcdata->vbuf, srcdata->tex, srcdata->draw_effect, srcdata->num_glyphs * 6, false);
 	}
 	gs_matrix_identity();
 	gs_matrix_pop();
@@ -50,7 +48,7 @@ void draw_drop_shadow(struct ft2_source *srcdata)
 
 	gs_matrix_push();
 	gs_matrix_translate3f(4.0f, 4.0f, 0.0f);
-	draw_uv_vbuffer(srcdata->vbuf, srcdata->tex, srcdata->draw_effect, (uint32_t)wcslen(srcdata->text) * 6, false);
+	draw_uv_vbuffer(srcdata->vbuf, srcdata->tex, srcdata->draw_effect, srcdata->num_glyphs * 6, false);
 	gs_matrix_identity();
 	gs_matrix_pop();
 }
@@ -77,12 +75,19 @@ void set_up_vertex_buffer(struct ft2_source *srcdata)
 		gs_vertexbuffer_destroy(tmpvbuf);
 	}
 
+	srcdata->num_glyphs = 0;
+	da_resize(srcdata->line_starts, 0);
+
 	if (*srcdata->text == 0) {
 		obs_leave_graphics();
 		return;
 	}
 
-	srcdata->vbuf = create_uv_vbuffer((uint32_t)wcslen(srcdata->text) * 6, true);
+	/* leave some headroom so text that keeps growing a little at a time
+	 * can be laid out again without a new buffer */
+	len = wcslen(srcdata->text);
+	srcdata->vbuf_glyphs = (uint32_t)(len + len / 4 + 16);
+	srcdata->vbuf = create_uv_vbuffer(srcdata->vbuf_glyphs * 6, true);
 
 	if (srcdata->custom_width <= 100)
 		goto skip_word_wrap;
@@ -121,12 +126,42 @@ void set_up_vertex_buffer(struct ft2_source *srcdata)
 	}
 
 skip_word_wrap:;
-	fill_vertex_buffer(srcdata);
+	fill_vertex_buffer(srcdata, 0);
 	gs_vertexbuffer_flush(srcdata->vbuf);
 	obs_leave_graphics();
 }
 
-void fill_vertex_buffer(struct ft2_source *srcdata)
+void update_vertex_buffer(struct ft2_source *srcdata, const wchar_t *old_text, uint32_t old_max_h)
+{
+	const bool word_wrap = srcdata->word_wrap && srcdata->custom_width > 100;
+	size_t from = 0;
+
+	if (!srcdata->text)
+		return;
+
+	/* word wrapping rewrites the text itself, and a new line height
+	 * moves every line, so both need a full layout */
+	if (!old_text || !srcdata->vbuf || word_wrap || srcdata->max_h != old_max_h || *srcdata->text == 0 ||
+	    wcslen(srcdata->text) > srcdata->vbuf_glyphs) {
+		set_up_vertex_buffer(srcdata);
+		return;
+	}
+
+	while (old_text[from] && old_text[from] == srcdata->text[from])
+		from++;
+	if (!old_text[from] && !srcdata->text[from])
+		return;
+
+	if (srcdata->custom_width < 100)
+		srcdata->cx = get_ft2_text_width(srcdata->text, srcdata);
+
+	obs_enter_graphics();
+	fill_vertex_buffer(srcdata, from);
+	gs_vertexbuffer_flush(srcdata->vbuf);
+	obs_leave_graphics();
+}
+
+void fill_vertex_buffer(struct ft2_source *srcdata, size_t from)
 {
 	struct gs_vb_data *vdata = gs_vertexbuffer_get_data(srcdata->vbuf);
 	if (vdata == NULL || !srcdata->text)
@@ -141,13 +176,31 @@ void fill_vertex_buffer(struct ft2_source *srcdata)
 	uint32_t cur_glyph = 0;
 	uint32_t offset = 0;
 	size_t len = wcslen(srcdata->text);
+	size_t first = 0;
+	size_t line = srcdata->line_starts.num;
 
 	if (srcdata->outline_text) {
 		offset = 2;
 		dx = offset;
 	}
 
-	for (size_t i = 0; i < len; i++) {
+	/* everything before the last line start at or before 'from' is laid
+	 * out exactly as it was, so pick up from there */
+	while (line > 0 && srcdata->line_starts.array[line - 1].pos > from)
+		line--;
+
+	if (line > 0) {
+		const struct ft2_line_start *start = &srcdata->line_starts.array[--line];
+
+		first = start->pos;
+		cur_glyph = start->glyph;
+		dy = start->dy;
+		max_y = start->max_y;
+	}
+
+	da_resize(srcdata->line_starts, line);
+
+	for (size_t i = first; i < len; i++) {
 	add_linebreak:;
 		if (srcdata->text[i] != L'\n')
 			goto draw_glyph;
@@ -159,6 +212,14 @@ void fill_vertex_buffer(struct ft2_source *srcdata)
 		if (srcdata->text[i] == L'\n')
 			goto add_linebreak;
 	draw_glyph:;
+		if (i == 0 || srcdata->text[i - 1] == L'\n') {
+			struct ft2_line_start *start = da_push_back_new(srcdata->line_starts);
+			start->pos = i;
+			start->glyph = cur_glyph;
+			start->dy = dy;
+			start->max_y = max_y;
+		}
+
 		// Skip filthy dual byte Windows line breaks
 		if (srcdata->text[i] == L'\r')
 			goto skip_glyph;
@@ -188,160 +249,109 @@ void fill_vertex_buffer(struct ft2_source *srcdata)
 	skip_glyph:;
 	}
 
+	srcdata->num_glyphs = cur_glyph;
 	srcdata->cy = max_y;
 }
 
-void cache_standard_glyphs(struct ft2_source *srcdata)
-{
-	for (uint32_t i = 0; i < num_cache_slots; i++) {
-		if (srcdata->cacheglyphs[i] != NULL) {
-			bfree(srcdata->cacheglyphs[i]);
-			srcdata->cacheglyphs[i] = NULL;
-		}
-	}
-
-	srcdata->texbuf_x = 0;
-	srcdata->texbuf_y = 0;
-
-	cache_glyphs(srcdata, L"abcdefghijklmnopqrstuvwxyz"
-			      L"ABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890"
-			      L"!@#$%^&*()-_=+,<.>/?\\|[]{}`~ \'\"\0");
-}
+#define STANDARD_GLYPHS                         \
+	L"abcdefghijklmnopqrstuvwxyz"           \
+	L"ABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890" \
+	L"!@#$%^&*()-_=+,<.>/?\\|[]{}`~ \'\"\0"
 
 FT_Render_Mode get_render_mode(struct ft2_source *srcdata)
 {
 	return srcdata->antialiasing ? FT_RENDER_MODE_NORMAL : FT_RENDER_MODE_MONO;
 }
 
-void load_glyph(struct ft2_source *srcdata, const FT_UInt glyph_index, const FT_Render_Mode render_mode)
+void release_glyphs(struct ft2_source *srcdata)
 {
-	const FT_Int32 load_mode = render_mode == FT_RENDER_MODE_MONO ? FT_LOAD_TARGET_MONO : FT_LOAD_DEFAULT;
-	FT_Load_Glyph(srcdata->font_face, glyph_index, load_mode);
-}
+	obs_enter_graphics();
+	srcdata->tex = NULL;
+	obs_leave_graphics();
 
-struct glyph_info *init_glyph(FT_GlyphSlot slot, const uint32_t dx, const uint32_t dy, const uint32_t g_w,
-			      const uint32_t g_h)
-{
-	struct glyph_info *glyph = bzalloc(sizeof(struct glyph_info));
-	glyph->u = (float)dx / (float)texbuf_w;
-	glyph->u2 = (float)(dx + g_w) / (float)texbuf_w;
-	glyph->v = (float)dy / (float)texbuf_h;
-	glyph->v2 = (float)(dy + g_h) / (float)texbuf_h;
-	glyph->w = g_w;
-	glyph->h = g_h;
-	glyph->yoff = slot->bitmap_top;
-	glyph->xoff = slot->bitmap_left;
-	glyph->xadv = slot->advance.x >> 6;
-
-	return glyph;
+	for (uint32_t i = 0; i < num_cache_slots; i++) {
+		if (srcdata->cacheglyphs[i] != NULL) {
+			glyph_atlas_release_glyph(srcdata->atlas_font, i);
+			srcdata->cacheglyphs[i] = NULL;
+		}
+	}
 }
 
-uint8_t get_pixel_value(const unsigned char *buf_row, FT_Render_Mode render_mode, const uint32_t x)
+void cache_standard_glyphs(struct ft2_source *srcdata)
 {
-	if (render_mode == FT_RENDER_MODE_NORMAL) {
-		return buf_row[x];
-	}
+	struct glyph_atlas_font *old_font = srcdata->atlas_font;
+
+	release_glyphs(srcdata);
+	srcdata->atlas_font = NULL;
 
-	const uint32_t byte_index = x / 8;
-	const uint8_t bit_index = x % 8;
-	const bool pixel_set = (buf_row[byte_index] >> (7 - bit_index)) & 1;
-	return pixel_set ? 255 : 0;
+	/* take the new font before dropping the old one so the atlas is not
+	 * torn down and rebuilt when both resolve to the same entry */
+	if (srcdata->font_face && srcdata->font_path)
+		srcdata->atlas_font = glyph_atlas_get_font(srcdata->font_path, srcdata->font_index,
+							   srcdata->font_size, get_render_mode(srcdata));
+	glyph_atlas_release_font(old_font);
+
+	cache_glyphs(srcdata, STANDARD_GLYPHS);
 }
 
-void rasterize(struct ft2_source *srcdata, FT_GlyphSlot slot, const FT_Render_Mode render_mode, const uint32_t dx,
-	       const uint32_t dy)
+void load_glyph(struct ft2_source *srcdata, const FT_UInt glyph_index, const FT_Render_Mode render_mode)
 {
-	/**
-	 * The pitch's absolute value is the number of bytes taken by one bitmap
-	 * row, including padding.
-	 *
-	 * Source: https://www.freetype.org/freetype2/docs/reference/ft2-basic_types.html
-	 */
-	const int pitch = abs(slot->bitmap.pitch);
-
-	for (uint32_t y = 0; y < slot->bitmap.rows; y++) {
-		const uint32_t row_start = y * pitch;
-		const uint32_t row = (dy + y) * texbuf_w;
-
-		for (uint32_t x = 0; x < slot->bitmap.width; x++) {
-			const uint32_t row_pixel_position = dx + x;
-			const uint8_t pixel_value = get_pixel_value(&slot->bitmap.buffer[row_start], render_mode, x);
-			srcdata->texbuf[row_pixel_position + row] = pixel_value;
-		}
-	}
+	const FT_Int32 load_mode = render_mode == FT_RENDER_MODE_MONO ? FT_LOAD_TARGET_MONO : FT_LOAD_DEFAULT;
+	FT_Load_Glyph(srcdata->font_face, glyph_index, load_mode);
 }
 
-void cache_glyphs(struct ft2_source *srcdata, wchar_t *cache_glyphs)
+static bool cache_glyph_list(struct ft2_source *srcdata, const wchar_t *glyphs)
 {
-	if (!srcdata->font_face || !cache_glyphs)
-		return;
-
 	FT_GlyphSlot slot = srcdata->font_face->glyph;
 
-	uint32_t dx = srcdata->texbuf_x;
-	uint32_t dy = srcdata->texbuf_y;
-
-	int32_t cached_glyphs = 0;
-	const size_t len = wcslen(cache_glyphs);
+	const size_t len = wcslen(glyphs);
 
 	const FT_Render_Mode render_mode = get_render_mode(srcdata);
 
 	for (size_t i = 0; i < len; i++) {
-		const FT_UInt glyph_index = FT_Get_Char_Index(srcdata->font_face, cache_glyphs[i]);
+		const FT_UInt glyph_index = FT_Get_Char_Index(srcdata->font_face, glyphs[i]);
 
 		if (src_glyph != NULL) {
 			continue;
 		}
 
-		load_glyph(srcdata, glyph_index, render_mode);
-		FT_Render_Glyph(slot, render_mode);
-
-		const uint32_t g_w = slot->bitmap.width;
-		const uint32_t g_h = slot->bitmap.rows;
-
-		if (srcdata->max_h < g_h) {
-			srcdata->max_h = g_h;
-		}
-
-		if (dx + g_w >= texbuf_w) {
-			dx = 0;
-			dy += srcdata->max_h + 1;
-		}
+		src_glyph = glyph_atlas_find(srcdata->atlas_font, glyph_index);
+		if (src_glyph == NULL) {
+			load_glyph(srcdata, glyph_index, render_mode);
+			FT_Render_Glyph(slot, render_mode);
 
-		if (dy + g_h >= texbuf_h) {
-			blog(LOG_WARNING, "Out of space trying to render glyphs");
-			break;
+			src_glyph = glyph_atlas_insert(srcdata->atlas_font, glyph_index, slot);
+			if (src_glyph == NULL)
+				return false;
 		}
 
-		src_glyph = init_glyph(slot, dx, dy, g_w, g_h);
-		rasterize(srcdata, slot, render_mode, dx, dy);
-
-		dx += (g_w + 1);
-		if (dx >= texbuf_w) {
-			dx = 0;
-			dy += srcdata->max_h;
+		if (srcdata->max_h < (uint32_t)src_glyph->h) {
+			srcdata->max_h = src_glyph->h;
 		}
-
-		cached_glyphs++;
 	}
 
-	srcdata->texbuf_x = dx;
-	srcdata->texbuf_y = dy;
+	return true;
+}
 
-	if (cached_glyphs > 0) {
+void cache_glyphs(struct ft2_source *srcdata, wchar_t *cache_glyphs)
+{
+	if (!srcdata->font_face || !srcdata->atlas_font || !cache_glyphs)
+		return;
 
-		obs_enter_graphics();
+	if (!cache_glyph_list(srcdata, cache_glyphs)) {
+		/* the atlas is full of glyphs that are still referenced; let go
+		 * of the ones only earlier text needed and try once more */
+		release_glyphs(srcdata);
 
-		if (srcdata->tex != NULL) {
-			gs_texture_t *tmp_texture = srcdata->tex;
-			srcdata->tex = NULL;
-			gs_texture_destroy(tmp_texture);
-		}
+		if (!cache_glyph_list(srcdata, STANDARD_GLYPHS) || !cache_glyph_list(srcdata, cache_glyphs))
+			blog(LOG_WARNING, "Out of space trying to render glyphs");
+	}
 
-		srcdata->tex = gs_texture_create(texbuf_w, texbuf_h, GS_A8, 1, (const uint8_t **)&srcdata->texbuf, 0);
+	glyph_atlas_flush();
 
-		obs_leave_graphics();
-	}
+	obs_enter_graphics();
+	srcdata->tex = glyph_atlas_get_texture();
+	obs_leave_graphics();
 }
 
 time_t get_modified_timestamp(char *filename)
@@ -367,22 +377,19 @@ static void remove_cr(wchar_t *source)
 	source[j] = '\0';
 }
 
-void load_text_from_file(struct ft2_source *srcdata, const char *filename)
+wchar_t *load_text_file(const char *filename)
 {
 	FILE *tmp_file = NULL;
 	uint32_t filesize = 0;
 	char *tmp_read = NULL;
 	uint16_t header = 0;
 	size_t bytes_read;
+	wchar_t *text;
 
 	tmp_file = os_fopen(filename, "rb");
-	if (tmp_file == NULL) {
-		if (!srcdata->file_load_failed) {
-			blog(LOG_WARNING, "Failed to open file %s", filename);
-			srcdata->file_load_failed = true;
-		}
-		return;
-	}
+	if (tmp_file == NULL)
+		return NULL;
+
 	fseek(tmp_file, 0, SEEK_END);
 	filesize = (uint32_t)ftell(tmp_file);
 	fseek(tmp_file, 0, SEEK_SET);
@@ -390,17 +397,11 @@ void load_text_from_file(struct ft2_source *srcdata, const char *filename)
 
 	if (bytes_read == 2 && header == 0xFEFF) {
 		// File is already in UTF-16 format
-		if (srcdata->text != NULL) {
-			bfree(srcdata->text);
-			srcdata->text = NULL;
-		}
-		srcdata->text = bzalloc(filesize);
-		bytes_read = fread(srcdata->text, filesize - 2, 1, tmp_file);
+		text = bzalloc(filesize);
+		bytes_read = fread(text, filesize - 2, 1, tmp_file);
 
-		bfree(tmp_read);
 		fclose(tmp_file);
-
-		return;
+		return text;
 	}
 
 	fseek(tmp_file, 0, SEEK_SET);
@@ -409,36 +410,30 @@ void load_text_from_file(struct ft2_source *srcdata, const char *filename)
 	bytes_read = fread(tmp_read, filesize, 1, tmp_file);
 	fclose(tmp_file);
 
-	if (srcdata->text != NULL) {
-		bfree(srcdata->text);
-		srcdata->text = NULL;
-	}
-	srcdata->text = bzalloc((strlen(tmp_read) + 1) * sizeof(wchar_t));
-	os_utf8_to_wcs(tmp_read, strlen(tmp_read), srcdata->text, (strlen(tmp_read) + 1));
+	text = bzalloc((strlen(tmp_read) + 1) * sizeof(wchar_t));
+	os_utf8_to_wcs(tmp_read, strlen(tmp_read), text, (strlen(tmp_read) + 1));
 
-	remove_cr(srcdata->text);
+	remove_cr(text);
 	bfree(tmp_read);
+	return text;
 }
 
-void read_from_end(struct ft2_source *srcdata, const char *filename)
+wchar_t *read_text_file_end(const char *filename, uint32_t log_lines)
 {
 	FILE *tmp_file = NULL;
-	uint32_t filesize = 0, cur_pos = 0, log_lines = 0;
+	uint32_t filesize = 0, cur_pos = 0;
 	char *tmp_read = NULL;
 	uint16_t value = 0, line_breaks = 0;
 	size_t bytes_read;
 	char bvalue;
+	wchar_t *text;
 
 	bool utf16 = false;
 
 	tmp_file = fopen(filename, "rb");
-	if (tmp_file == NULL) {
-		if (!srcdata->file_load_failed) {
-			blog(LOG_WARNING, "Failed to open file %s", filename);
-			srcdata->file_load_failed = true;
-		}
-		return;
-	}
+	if (tmp_file == NULL)
+		return NULL;
+
 	bytes_read = fread(&value, 1, 2, tmp_file);
 
 	if (bytes_read == 2 && value == 0xFEFF)
@@ -447,7 +442,6 @@ void read_from_end(struct ft2_source *srcdata, const char *filename)
 	fseek(tmp_file, 0, SEEK_END);
 	filesize = (uint32_t)ftell(tmp_file);
 	cur_pos = filesize;
-	log_lines = srcdata->log_lines;
 
 	while (line_breaks <= log_lines && cur_pos != 0) {
 		if (!utf16)
@@ -473,33 +467,48 @@ void read_from_end(struct ft2_source *srcdata, const char *filename)
 	fseek(tmp_file, cur_pos, SEEK_SET);
 
 	if (utf16) {
-		if (srcdata->text != NULL) {
-			bfree(srcdata->text);
-			srcdata->text = NULL;
-		}
-		srcdata->text = bzalloc(filesize - cur_pos);
-		bytes_read = fread(srcdata->text, (filesize - cur_pos), 1, tmp_file);
+		text = bzalloc(filesize - cur_pos);
+		bytes_read = fread(text, (filesize - cur_pos), 1, tmp_file);
 
-		remove_cr(srcdata->text);
-		bfree(tmp_read);
+		remove_cr(text);
 		fclose(tmp_file);
-
-		return;
+		return text;
 	}
 
 	tmp_read = bzalloc((filesize - cur_pos) + 1);
 	bytes_read = fread(tmp_read, filesize - cur_pos, 1, tmp_file);
 	fclose(tmp_file);
 
-	if (srcdata->text != NULL) {
-		bfree(srcdata->text);
-		srcdata->text = NULL;
-	}
-	srcdata->text = bzalloc((strlen(tmp_read) + 1) * sizeof(wchar_t));
-	os_utf8_to_wcs(tmp_read, strlen(tmp_read), srcdata->text, (strlen(tmp_read) + 1));
+	text = bzalloc((strlen(tmp_read) + 1) * sizeof(wchar_t));
+	os_utf8_to_wcs(tmp_read, strlen(tmp_read), text, (strlen(tmp_read) + 1));
 
-	remove_cr(srcdata->text);
+	remove_cr(text);
 	bfree(tmp_read);
+	return text;
+}
+
+static void set_file_text(struct ft2_source *srcdata, const char *filename, wchar_t *text)
+{
+	if (text == NULL) {
+		if (!srcdata->file_load_failed) {
+			blog(LOG_WARNING, "Failed to open file %s", filename);
+			srcdata->file_load_failed = true;
+		}
+		return;
+	}
+
+	bfree(srcdata->text);
+	srcdata->text = text;
+}
+
+void load_text_from_file(struct ft2_source *srcdata, const char *filename)
+{
+	set_file_text(srcdata, filename, load_text_file(filename));
+}
+
+void read_from_end(struct ft2_source *srcdata, const char *filename)
+{
+	set_file_text(srcdata, filename, read_text_file_end(filename, srcdata->log_lines));
 }
 
 uint32_t get_ft2_text_width(wchar_t *text, struct ft2_source *srcdata)
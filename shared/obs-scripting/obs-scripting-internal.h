@@ -18,9 +18,43 @@
 #pragma once
 
 #include <util/dstr.h>
+#include <util/darray.h>
+#include <util/threading.h>
 #include <callback/calldata.h>
 #include "obs-scripting.h"
 
+struct script_callback;
+struct script_event;
+
+typedef void (*script_event_cb)(struct script_event *event);
+
+struct script_event {
+	script_event_cb call;
+	obs_script_t *script;
+	struct script_callback *cb;
+
+	float seconds;
+};
+
+/* Ticks and timers of the scripts of a language.  These are queued by the
+ * graphics tick and run in batches on a thread of their own, which only has
+ * to lock the interpreter once per batch if it has a lock of its own.
+ * Signals are not queued: they are called on the thread that sends them. */
+struct script_events {
+	void (*lock)(void);
+	void (*unlock)(void);
+
+	pthread_mutex_t mutex;
+	pthread_cond_t done;
+	DARRAY(struct script_event) queue;
+	bool running;
+
+	os_sem_t *sem;
+	pthread_t thread;
+	bool active;
+	bool exit;
+};
+
 struct obs_script {
 	enum obs_script_lang type;
 	bool loaded;
@@ -30,13 +64,25 @@ struct obs_script {
 	struct dstr path;
 	struct dstr file;
 	struct dstr desc;
+
+	uint64_t event_time;
+	uint64_t event_count;
 };
 
-struct script_callback;
 typedef void (*defer_call_cb)(void *param);
 
 extern void defer_call_post(defer_call_cb call, void *cb);
 
+extern bool script_events_start(struct script_events *events, void (*lock)(void), void (*unlock)(void));
+extern void script_events_stop(struct script_events *events);
+
+/* Queues an event without waiting for it.  If the same call for the same
+ * script and callback is still queued, the two are merged and their seconds
+ * added. */
+extern void script_events_post(struct script_events *events, obs_script_t *script, const struct script_event *event);
+/* Drops the queued events of a script and waits for the ones being run. */
+extern void script_events_remove(struct script_events *events, obs_script_t *script);
+
 extern void script_log(obs_script_t *script, int level, const char *format, ...);
 extern void script_log_va(obs_script_t *script, int level, const char *format, va_list args);
 
@@ -58,6 +58,10 @@ static char *startup_script = NULL;
 static pthread_mutex_t tick_mutex;
 static struct obs_lua_script *first_tick_script = NULL;
 
+/* one thread for all Lua scripts, so that two scripts never wait for each
+ * other from two threads */
+static struct script_events lua_events;
+
 pthread_mutex_t lua_source_def_mutex;
 
 #define ls_get_libobs_obj(type, lua_index, obs_obj) \
@@ -286,11 +290,11 @@ static int timer_remove(lua_State *script)
 	return 0;
 }
 
-static void timer_call(struct script_callback *p_cb)
+static void timer_call(struct script_event *event)
 {
-	struct lua_obs_callback *cb = (struct lua_obs_callback *)p_cb;
+	struct lua_obs_callback *cb = (struct lua_obs_callback *)event->cb;
 
-	if (script_callback_removed(p_cb))
+	if (script_callback_removed(&cb->base))
 		return;
 
 	lock_callback();
@@ -372,24 +376,35 @@ static int obs_lua_add_main_render_callback(lua_State *script)
 
 /* -------------------------------------------- */
 
-static void obs_lua_tick_callback(void *priv, float seconds)
+static void tick_callback_call(struct script_event *event)
 {
-	struct lua_obs_callback *cb = priv;
+	struct lua_obs_callback *cb = (struct lua_obs_callback *)event->cb;
 	lua_State *script = cb->script;
 
-	if (script_callback_removed(&cb->base)) {
-		obs_remove_tick_callback(obs_lua_tick_callback, cb);
+	if (script_callback_removed(&cb->base))
 		return;
-	}
 
 	lock_callback();
 
-	lua_pushnumber(script, (lua_Number)seconds);
+	lua_pushnumber(script, (lua_Number)event->seconds);
 	call_func(obs_lua_tick_callback, 1, 0);
 
 	unlock_callback();
 }
 
+static void obs_lua_tick_callback(void *priv, float seconds)
+{
+	struct lua_obs_callback *cb = priv;
+
+	if (script_callback_removed(&cb->base)) {
+		obs_remove_tick_callback(obs_lua_tick_callback, cb);
+		return;
+	}
+
+	struct script_event event = {.call = tick_callback_call, .cb = &cb->base, .seconds = seconds};
+	script_events_post(&lua_events, cb->base.script, &event);
+}
+
 static int obs_lua_remove_tick_callback(lua_State *script)
 {
 	if (!verify_args1(script, is_function))
@@ -925,6 +940,27 @@ static int sceneitem_list_release(lua_State *script)
 
 /* -------------------------------------------- */
 
+/* The graphics thread calls into scripts with the graphics context entered,
+ * so the script is not kept locked while waiting for the context, unless this
+ * thread has it already. */
+static int enter_graphics(lua_State *script)
+{
+	struct obs_lua_script *data = current_lua_script;
+
+	if (data && !gs_get_context()) {
+		pthread_mutex_unlock(&data->mutex);
+		obs_enter_graphics();
+		pthread_mutex_lock(&data->mutex);
+	} else {
+		obs_enter_graphics();
+	}
+
+	UNUSED_PARAMETER(script);
+	return 0;
+}
+
+/* -------------------------------------------- */
+
 static int hook_print(lua_State *script)
 {
 	struct obs_lua_script *data = current_lua_script;
@@ -1014,6 +1050,7 @@ static void add_hook_functions(lua_State *script)
 	add_func("obs_sceneitem_group_enum_items", sceneitem_group_enum_items);
 	add_func("source_list_release", source_list_release);
 	add_func("sceneitem_list_release", sceneitem_list_release);
+	add_func("obs_enter_graphics", enter_graphics);
 	add_func("calldata_source", calldata_source);
 	add_func("calldata_sceneitem", calldata_sceneitem);
 	add_func("obs_add_main_render_callback", obs_lua_add_main_render_callback);
@@ -1036,6 +1073,23 @@ static void add_hook_functions(lua_State *script)
 
 /* -------------------------------------------- */
 
+static void script_tick_call(struct script_event *event)
+{
+	struct obs_lua_script *data = (struct obs_lua_script *)event->script;
+	lua_State *script = data->script;
+
+	pthread_mutex_lock(&data->mutex);
+	current_lua_script = data;
+
+	lua_pushnumber(script, (double)event->seconds);
+	call_func_(script, data->tick, 1, 0, "tick", __FUNCTION__);
+
+	current_lua_script = NULL;
+	pthread_mutex_unlock(&data->mutex);
+}
+
+/* Only queues script_tick calls and timers that are due, they are run on the
+ * Lua events thread */
 static void lua_tick(void *param, float seconds)
 {
 	struct obs_lua_script *data;
@@ -1043,28 +1097,20 @@ static void lua_tick(void *param, float seconds)
 	uint64_t ts = obs_get_video_frame_time();
 
 	/* --------------------------------- */
-	/* process script_tick calls         */
+	/* queue script_tick calls           */
 
 	pthread_mutex_lock(&tick_mutex);
 	data = first_tick_script;
 	while (data) {
-		lua_State *script = data->script;
-		current_lua_script = data;
-
-		pthread_mutex_lock(&data->mutex);
-
-		lua_pushnumber(script, (double)seconds);
-		call_func_(script, data->tick, 1, 0, "tick", __FUNCTION__);
-
-		pthread_mutex_unlock(&data->mutex);
+		struct script_event event = {.call = script_tick_call, .seconds = seconds};
+		script_events_post(&lua_events, &data->base, &event);
 
 		data = data->next_tick;
 	}
-	current_lua_script = NULL;
 	pthread_mutex_unlock(&tick_mutex);
 
 	/* --------------------------------- */
-	/* process timers                    */
+	/* queue timers                      */
 
 	pthread_mutex_lock(&timer_mutex);
 	timer = first_timer;
@@ -1078,7 +1124,9 @@ static void lua_tick(void *param, float seconds)
 			uint64_t elapsed = ts - timer->last_ts;
 
 			if (elapsed >= timer->interval) {
-				timer_call(&cb->base);
+				struct script_event event = {.call = timer_call, .cb = &cb->base};
+				script_events_post(&lua_events, cb->base.script, &event);
+
 				timer->last_ts += timer->interval;
 			}
 		}
@@ -1192,6 +1240,11 @@ void obs_lua_script_unload(obs_script_t *s)
 		data->next_tick = NULL;
 	}
 
+	/* ---------------------------- */
+	/* drop queued events           */
+
+	script_events_remove(&lua_events, s);
+
 	/* ---------------------------- */
 	/* call script_unload           */
 
@@ -1364,12 +1417,14 @@ void obs_lua_load(void)
 	dstr_free(&package_cpath);
 	startup_script = tmp.array;
 
+	script_events_start(&lua_events, NULL, NULL);
 	obs_add_tick_callback(lua_tick, NULL);
 }
 
 void obs_lua_unload(void)
 {
 	obs_remove_tick_callback(lua_tick, NULL);
+	script_events_stop(&lua_events);
 
 	bfree(startup_script);
 	pthread_mutex_destroy(&tick_mutex);
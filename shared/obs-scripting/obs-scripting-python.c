@@ -58,6 +58,9 @@ static bool mutexes_loaded = false;
 static pthread_mutex_t tick_mutex;
 static struct obs_python_script *first_tick_script = NULL;
 
+/* one thread for all Python scripts, as they share the GIL anyway */
+static struct script_events python_events;
+
 static PyObject *py_obspython = NULL;
 struct obs_python_script *cur_python_script = NULL;
 struct python_obs_callback *cur_python_cb = NULL;
@@ -416,11 +419,11 @@ static PyObject *timer_remove(PyObject *self, PyObject *args)
 	return python_none();
 }
 
-static void timer_call(struct script_callback *p_cb)
+static void timer_call(struct script_event *event)
 {
-	struct python_obs_callback *cb = (struct python_obs_callback *)p_cb;
+	struct python_obs_callback *cb = (struct python_obs_callback *)event->cb;
 
-	if (script_callback_removed(p_cb))
+	if (script_callback_removed(&cb->base))
 		return;
 
 	lock_callback(cb);
@@ -460,18 +463,16 @@ static PyObject *timer_add(PyObject *self, PyObject *args)
 
 /* -------------------------------------------- */
 
-static void obs_python_tick_callback(void *priv, float seconds)
+static void tick_callback_call(struct script_event *event)
 {
-	struct python_obs_callback *cb = priv;
+	struct python_obs_callback *cb = (struct python_obs_callback *)event->cb;
 
-	if (script_callback_removed(&cb->base)) {
-		obs_remove_tick_callback(obs_python_tick_callback, cb);
+	if (script_callback_removed(&cb->base))
 		return;
-	}
 
 	lock_callback(cb);
 
-	PyObject *args = Py_BuildValue("(f)", seconds);
+	PyObject *args = Py_BuildValue("(f)", event->seconds);
 	PyObject *py_ret = PyObject_CallObject(cb->func, args);
 	py_error();
 	Py_XDECREF(py_ret);
@@ -480,6 +481,19 @@ static void obs_python_tick_callback(void *priv, float seconds)
 	unlock_callback();
 }
 
+static void obs_python_tick_callback(void *priv, float seconds)
+{
+	struct python_obs_callback *cb = priv;
+
+	if (script_callback_removed(&cb->base)) {
+		obs_remove_tick_callback(obs_python_tick_callback, cb);
+		return;
+	}
+
+	struct script_event event = {.call = tick_callback_call, .cb = &cb->base, .seconds = seconds};
+	script_events_post(&python_events, cb->base.script, &event);
+}
+
 static PyObject *obs_python_remove_tick_callback(PyObject *self, PyObject *args)
 {
 	struct obs_python_script *script = cur_python_script;
@@ -1193,6 +1207,27 @@ static PyObject *py_script_log(PyObject *self, PyObject *args)
 
 /* -------------------------------------------- */
 
+/* The graphics thread calls into scripts with the graphics context entered,
+ * so the GIL is not kept while waiting for the context, unless this thread
+ * has it already. */
+static PyObject *enter_graphics(PyObject *self, PyObject *args)
+{
+	UNUSED_PARAMETER(self);
+	UNUSED_PARAMETER(args);
+
+	if (!gs_get_context()) {
+		PyThreadState *state = PyEval_SaveThread();
+		obs_enter_graphics();
+		PyEval_RestoreThread(state);
+	} else {
+		obs_enter_graphics();
+	}
+
+	return python_none();
+}
+
+/* -------------------------------------------- */
+
 static void add_hook_functions(PyObject *module)
 {
 	static PyMethodDef funcs[] = {
@@ -1206,6 +1241,7 @@ static void add_hook_functions(PyObject *module)
 		DEF_FUNC("calldata_sceneitem", calldata_sceneitem),
 		DEF_FUNC("source_list_release", source_list_release),
 		DEF_FUNC("sceneitem_list_release", sceneitem_list_release),
+		DEF_FUNC("obs_enter_graphics", enter_graphics),
 		DEF_FUNC("obs_enum_sources", enum_sources),
 		DEF_FUNC("obs_scene_enum_items", scene_enum_items),
 		DEF_FUNC("obs_sceneitem_group_enum_items", sceneitem_group_enum_items),
@@ -1229,6 +1265,20 @@ static void add_hook_functions(PyObject *module)
 
 /* -------------------------------------------- */
 
+static THREAD_LOCAL PyGILState_STATE events_gstate;
+
+static void python_events_lock(void)
+{
+	events_gstate = PyGILState_Ensure();
+}
+
+static void python_events_unlock(void)
+{
+	PyGILState_Release(events_gstate);
+}
+
+/* -------------------------------------------- */
+
 void obs_python_script_update(obs_script_t *script, obs_data_t *settings);
 
 bool obs_python_script_load(obs_script_t *s)
@@ -1339,6 +1389,11 @@ void obs_python_script_unload(obs_script_t *s)
 		data->next_tick = NULL;
 	}
 
+	/* ---------------------------- */
+	/* drop queued events           */
+
+	script_events_remove(&python_events, s);
+
 	relock_python();
 
 	Py_XDECREF(data->tick);
@@ -1474,61 +1529,50 @@ void obs_python_script_save(obs_script_t *s)
 
 /* -------------------------------------------- */
 
-static void python_tick(void *param, float seconds)
+static void script_tick_call(struct script_event *event)
 {
-	struct obs_python_script *data;
-	/* When loading a new Python script, the GIL might be released while
-	 * importing the module, allowing the tick to run and change and reset
-	 * the cur_python_script state variable. Use the busy_script variable
-	 * to save and restore the value if not null.
-	 */
-	struct obs_python_script *busy_script = NULL;
-	bool valid;
-	uint64_t ts = obs_get_video_frame_time();
+	struct obs_python_script *data = (struct obs_python_script *)event->script;
 
-	pthread_mutex_lock(&tick_mutex);
-	valid = !!first_tick_script;
-	pthread_mutex_unlock(&tick_mutex);
-
-	/* --------------------------------- */
-	/* process script_tick calls         */
-
-	if (valid) {
-		lock_python();
-
-		PyObject *args = Py_BuildValue("(f)", seconds);
-
-		pthread_mutex_lock(&tick_mutex);
-		data = first_tick_script;
-
-		if (cur_python_script)
-			busy_script = cur_python_script;
+	if (!data->tick)
+		return;
 
-		while (data) {
-			cur_python_script = data;
+	/* When loading a new Python script, the GIL might be released while
+	 * importing the module, allowing the tick to run, so the previous
+	 * cur_python_script is restored afterwards. */
+	struct obs_python_script *last_script = cur_python_script;
+	cur_python_script = data;
 
-			PyObject *py_ret = PyObject_CallObject(data->tick, args);
-			Py_XDECREF(py_ret);
-			py_error();
+	PyObject *args = Py_BuildValue("(f)", event->seconds);
+	PyObject *py_ret = PyObject_CallObject(data->tick, args);
+	Py_XDECREF(py_ret);
+	py_error();
+	Py_XDECREF(args);
 
-			data = data->next_tick;
-		}
+	cur_python_script = last_script;
+}
 
-		cur_python_script = NULL;
-		if (busy_script) {
-			cur_python_script = busy_script;
-			busy_script = NULL;
-		}
+/* Only queues script_tick calls and timers that are due, they are run on the
+ * Python events thread */
+static void python_tick(void *param, float seconds)
+{
+	struct obs_python_script *data;
+	uint64_t ts = obs_get_video_frame_time();
 
-		pthread_mutex_unlock(&tick_mutex);
+	/* --------------------------------- */
+	/* queue script_tick calls           */
 
-		Py_XDECREF(args);
+	pthread_mutex_lock(&tick_mutex);
+	data = first_tick_script;
+	while (data) {
+		struct script_event event = {.call = script_tick_call, .seconds = seconds};
+		script_events_post(&python_events, &data->base, &event);
 
-		unlock_python();
+		data = data->next_tick;
 	}
+	pthread_mutex_unlock(&tick_mutex);
 
 	/* --------------------------------- */
-	/* process timers                    */
+	/* queue timers                      */
 
 	pthread_mutex_lock(&timer_mutex);
 	struct python_obs_timer *timer = first_timer;
@@ -1542,9 +1586,8 @@ static void python_tick(void *param, float seconds)
 			uint64_t elapsed = ts - timer->last_ts;
 
 			if (elapsed >= timer->interval) {
-				lock_python();
-				timer_call(&cb->base);
-				unlock_python();
+				struct script_event event = {.call = timer_call, .cb = &cb->base};
+				script_events_post(&python_events, cb->base.script, &event);
 
 				timer->last_ts += timer->interval;
 			}
@@ -1732,8 +1775,10 @@ out:
 
 	python_loaded_at_all = success;
 
-	if (python_loaded)
+	if (python_loaded) {
+		script_events_start(&python_events, python_events_lock, python_events_unlock);
 		obs_add_tick_callback(python_tick, NULL);
+	}
 
 	return python_loaded;
 }
@@ -1748,6 +1793,10 @@ void obs_python_unload(void)
 	if (!python_loaded_at_all)
 		return;
 
+	/* the events thread needs the interpreter */
+	obs_remove_tick_callback(python_tick, NULL);
+	script_events_stop(&python_events);
+
 	if (python_loaded && Py_IsInitialized()) {
 		PyGILState_Ensure();
 
@@ -1757,8 +1806,6 @@ void obs_python_unload(void)
 
 	/* ---------------------- */
 
-	obs_remove_tick_callback(python_tick, NULL);
-
 	for (size_t i = 0; i < python_paths.num; i++)
 		bfree(python_paths.array[i]);
 	da_free(python_paths);
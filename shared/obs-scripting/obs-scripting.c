@@ -15,11 +15,14 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+#include <inttypes.h>
+
 #include <obs.h>
 #include <util/dstr.h>
 #include <util/platform.h>
 #include <util/threading.h>
 #include <util/deque.h>
+#include <util/source-profiler.h>
 
 #include "obs-scripting-internal.h"
 #include "obs-scripting-callback.h"
@@ -129,6 +132,203 @@ void defer_call_post(defer_call_cb call, void *cb)
 
 /* -------------------------------------------- */
 
+static THREAD_LOCAL struct script_events *current_events = NULL;
+
+static inline void run_script_event(struct script_event *event)
+{
+	obs_script_t *script = event->script;
+	uint64_t start = os_gettime_ns();
+
+	event->call(event);
+
+	uint64_t elapsed = os_gettime_ns() - start;
+	source_profiler_client_time(script, elapsed, 1);
+	script->event_time += elapsed;
+	script->event_count++;
+}
+
+static void *script_events_thread(void *param)
+{
+	struct script_events *events = param;
+	DARRAY(struct script_event) batch;
+
+	da_init(batch);
+	os_set_thread_name("scripting: events");
+	current_events = events;
+
+	while (os_sem_wait(events->sem) == 0) {
+		pthread_mutex_lock(&events->mutex);
+		if (events->exit) {
+			pthread_mutex_unlock(&events->mutex);
+			break;
+		}
+
+		/* swap so both arrays keep their memory */
+		struct darray queued = events->queue.da;
+		events->queue.da = batch.da;
+		batch.da = queued;
+		events->running = batch.num != 0;
+		pthread_mutex_unlock(&events->mutex);
+
+		if (!batch.num)
+			continue;
+
+		if (events->lock)
+			events->lock();
+		for (size_t i = 0; i < batch.num; i++)
+			run_script_event(&batch.array[i]);
+		if (events->unlock)
+			events->unlock();
+
+		pthread_mutex_lock(&events->mutex);
+		events->running = false;
+		pthread_cond_broadcast(&events->done);
+		pthread_mutex_unlock(&events->mutex);
+
+		da_resize(batch, 0);
+	}
+
+	da_free(batch);
+	return NULL;
+}
+
+bool script_events_start(struct script_events *events, void (*lock)(void), void (*unlock)(void))
+{
+	memset(events, 0, sizeof(*events));
+	events->lock = lock;
+	events->unlock = unlock;
+
+	if (pthread_mutex_init(&events->mutex, NULL) != 0)
+		goto fail;
+	if (pthread_cond_init(&events->done, NULL) != 0) {
+		pthread_mutex_destroy(&events->mutex);
+		goto fail;
+	}
+	if (os_sem_init(&events->sem, 0) != 0) {
+		pthread_cond_destroy(&events->done);
+		pthread_mutex_destroy(&events->mutex);
+		goto fail;
+	}
+	if (pthread_create(&events->thread, NULL, script_events_thread, events) != 0) {
+		os_sem_destroy(events->sem);
+		pthread_cond_destroy(&events->done);
+		pthread_mutex_destroy(&events->mutex);
+		goto fail;
+	}
+
+	events->active = true;
+	return true;
+
+fail:
+	blog(LOG_WARNING, "[obs-scripting]: Failed to create event thread, running events where they come from");
+	return false;
+}
+
+void script_events_stop(struct script_events *events)
+{
+	if (!events->active) {
+		events->exit = true;
+		return;
+	}
+
+	/* events still queued are dropped */
+	pthread_mutex_lock(&events->mutex);
+	events->exit = true;
+	da_resize(events->queue, 0);
+	pthread_mutex_unlock(&events->mutex);
+
+	os_sem_post(events->sem);
+	pthread_join(events->thread, NULL);
+	events->active = false;
+
+	da_free(events->queue);
+	os_sem_destroy(events->sem);
+	pthread_cond_destroy(&events->done);
+	pthread_mutex_destroy(&events->mutex);
+}
+
+void script_events_post(struct script_events *events, obs_script_t *script, const struct script_event *event)
+{
+	bool wake;
+
+	/* if the thread failed to start, events run right away like they did
+	 * before there was one */
+	if (!events->active) {
+		struct script_event now = *event;
+
+		if (events->exit)
+			return;
+
+		now.script = script;
+		if (events->lock)
+			events->lock();
+		run_script_event(&now);
+		if (events->unlock)
+			events->unlock();
+		return;
+	}
+
+	pthread_mutex_lock(&events->mutex);
+
+	if (events->exit) {
+		pthread_mutex_unlock(&events->mutex);
+		return;
+	}
+
+	for (size_t i = 0; i < events->queue.num; i++) {
+		struct script_event *queued = &events->queue.array[i];
+
+		if (queued->call == event->call && queued->script == script && queued->cb == event->cb) {
+			queued->seconds += event->seconds;
+			pthread_mutex_unlock(&events->mutex);
+			return;
+		}
+	}
+
+	wake = !events->queue.num;
+
+	struct script_event *queued = da_push_back_new(events->queue);
+	*queued = *event;
+	queued->script = script;
+
+	pthread_mutex_unlock(&events->mutex);
+
+	if (wake)
+		os_sem_post(events->sem);
+}
+
+void script_events_remove(struct script_events *events, obs_script_t *script)
+{
+	if (events->active) {
+		pthread_mutex_lock(&events->mutex);
+
+		for (size_t i = events->queue.num; i > 0; i--) {
+			if (events->queue.array[i - 1].script == script)
+				da_erase(events->queue, i - 1);
+		}
+
+		/* the batch being run may still have events of this script */
+		if (current_events != events) {
+			while (events->running)
+				pthread_cond_wait(&events->done, &events->mutex);
+		}
+
+		pthread_mutex_unlock(&events->mutex);
+	}
+
+	source_profiler_remove_client(script);
+
+	if (script->event_count) {
+		blog(LOG_INFO, "[obs-scripting]: %s: %" PRIu64 " events, %.3f ms in script", script->file.array,
+		     script->event_count, (double)script->event_time / 1000000.0);
+	}
+
+	script->event_time = 0;
+	script->event_count = 0;
+}
+
+/* -------------------------------------------- */
+
 bool obs_scripting_load(void)
 {
 	deque_init(&defer_call_queue);
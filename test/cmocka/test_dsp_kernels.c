@@ -0,0 +1,123 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <util/c99defs.h>
+#include <media-io/audio-math.h>
+
+#include "dsp-kernels.h"
+
+static void fill_noise(float *buf, size_t num, float amplitude)
+{
+	srand(1);
+	for (size_t i = 0; i < num; i++)
+		buf[i] = amplitude * ((float)rand() / (float)RAND_MAX * 2.0f - 1.0f);
+}
+
+static void db_conversion_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	for (float db = -120.0f; db <= 40.0f; db += 0.01f) {
+		const float mul = db_to_mul(db);
+
+		assert_true(fabsf(dsp_fast_db_to_mul(db) - mul) <= mul * 2e-6f);
+		assert_true(fabsf(dsp_fast_mul_to_db(mul) - db) <= 1e-4f);
+	}
+
+	/* unity gain has to survive the round trip untouched */
+	assert_true(dsp_fast_db_to_mul(0.0f) == 1.0f);
+	assert_true(dsp_fast_mul_to_db(1.0f) == 0.0f);
+
+	/* silence is a very large attenuation rather than -inf */
+	assert_true(dsp_fast_mul_to_db(0.0f) < -700.0f);
+	assert_true(dsp_fast_db_to_mul(-INFINITY) < 1e-30f);
+}
+
+static void envelope_follow_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	float samples[DSP_BLOCK_SIZE];
+	float env_buf[DSP_BLOCK_SIZE] = {0};
+	const float attack = 0.9f;
+	const float release = 0.999f;
+	float env = 0.25f;
+
+	fill_noise(samples, DSP_BLOCK_SIZE, 1.0f);
+	float out = dsp_envelope_follow(env_buf, samples, DSP_BLOCK_SIZE, env, attack, release);
+
+	for (size_t i = 0; i < DSP_BLOCK_SIZE; i++) {
+		const float env_in = fabsf(samples[i]);
+		if (env < env_in)
+			env = env_in + attack * (env - env_in);
+		else
+			env = env_in + release * (env - env_in);
+
+		assert_true(env_buf[i] == env);
+	}
+
+	assert_true(out == env);
+}
+
+static void compressor_gain_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	float env[DSP_BLOCK_SIZE];
+	float gain[DSP_BLOCK_SIZE];
+	const float threshold = -18.0f;
+	const float slope = 1.0f - 1.0f / 4.0f;
+
+	fill_noise(env, DSP_BLOCK_SIZE, 1.0f);
+	for (size_t i = 0; i < DSP_BLOCK_SIZE; i++)
+		env[i] = fabsf(env[i]);
+
+	dsp_compressor_gain(gain, env, DSP_BLOCK_SIZE, threshold, slope);
+
+	for (size_t i = 0; i < DSP_BLOCK_SIZE; i++) {
+		const float expected = db_to_mul(fminf(0.0f, slope * (threshold - mul_to_db(env[i]))));
+		assert_true(fabsf(gain[i] - expected) <= 1e-5f);
+	}
+}
+
+static void lp4_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	float samples[DSP_BLOCK_SIZE];
+	float out[DSP_BLOCK_SIZE];
+	struct dsp_lp4 lp = {0};
+	float d0 = 0.0f, d1 = 0.0f, d2 = 0.0f, d3 = 0.0f;
+	const float coef = 2.0f * sinf((float)M_PI * 800.0f / 48000.0f);
+
+	fill_noise(samples, DSP_BLOCK_SIZE, 1.0f);
+	dsp_lp4_process(&lp, out, samples, DSP_BLOCK_SIZE, coef);
+
+	for (size_t i = 0; i < DSP_BLOCK_SIZE; i++) {
+		d0 += coef * (samples[i] - d0) + (1.0f / 4294967295.0f);
+		d1 += coef * (d0 - d1);
+		d2 += coef * (d1 - d2);
+		d3 += coef * (d2 - d3);
+
+		assert_true(out[i] == d3);
+	}
+
+	assert_true(lp.delay3 == d3);
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(db_conversion_test),
+		cmocka_unit_test(envelope_follow_test),
+		cmocka_unit_test(compressor_gain_test),
+		cmocka_unit_test(lp4_test),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,154 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+
+#include <obs.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+#include <obs-nix-platform.h>
+#endif
+
+#define INJECT_ITERATIONS 50
+
+struct hotkey_state {
+	volatile long presses;
+	volatile long releases;
+	uint64_t press_ts;
+	os_event_t *released;
+};
+
+static void hotkey_func(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+	UNUSED_PARAMETER(id);
+	UNUSED_PARAMETER(hotkey);
+
+	struct hotkey_state *state = data;
+
+	if (pressed) {
+		state->press_ts = os_gettime_ns();
+		os_atomic_inc_long(&state->presses);
+	} else {
+		os_atomic_inc_long(&state->releases);
+		os_event_signal(state->released);
+	}
+}
+
+static bool started = false;
+
+static int setup(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+	/* The hotkey backend needs a display server */
+	if (!getenv("DISPLAY"))
+		return 0;
+	obs_set_nix_platform(OBS_NIX_PLATFORM_X11_EGL);
+#endif
+
+	started = obs_startup("en-US", NULL, NULL);
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	if (started)
+		obs_shutdown();
+	return 0;
+}
+
+static void inject_latency_test(void **unused)
+{
+	UNUSED_PARAMETER(unused);
+
+	if (!started)
+		skip();
+
+	struct hotkey_state state = {0};
+	obs_key_combination_t combo = {INTERACT_CONTROL_KEY, OBS_KEY_F24};
+	uint64_t press_ns_total = 0;
+	uint64_t release_ns_total = 0;
+
+	assert_int_equal(os_event_init(&state.released, OS_EVENT_TYPE_AUTO), 0);
+
+	obs_hotkey_id id = obs_hotkey_register_frontend("test-hotkey", "Test hotkey", hotkey_func, &state);
+	obs_hotkey_load_bindings(id, &combo, 1);
+
+	for (int i = 0; i < INJECT_ITERATIONS; i++) {
+		uint64_t start = os_gettime_ns();
+		obs_hotkey_inject_event(combo, true);
+
+		/* injected presses fire right away */
+		assert_int_equal(os_atomic_load_long(&state.presses), i + 1);
+		press_ns_total += state.press_ts - start;
+
+		/* and the hotkey thread releases them once it sees the key
+		 * is not actually held */
+		start = os_gettime_ns();
+		assert_int_equal(os_event_timedwait(state.released, 500), 0);
+		assert_int_equal(os_atomic_load_long(&state.releases), i + 1);
+		release_ns_total += os_gettime_ns() - start;
+	}
+
+	print_message("inject: press %.3f ms, release %.3f ms average\n",
+		      (double)press_ns_total / INJECT_ITERATIONS / 1000000.0,
+		      (double)release_ns_total / INJECT_ITERATIONS / 1000000.0);
+
+	obs_hotkey_unregister(id);
+	os_event_destroy(state.released);
+}
+
+static void modifiers_test(void **unused)
+{
+	UNUSED_PARAMETER(unused);
+
+	if (!started)
+		skip();
+
+	struct hotkey_state state = {0};
+	obs_key_combination_t combo = {INTERACT_CONTROL_KEY | INTERACT_SHIFT_KEY, OBS_KEY_F23};
+	obs_key_combination_t partial = {INTERACT_CONTROL_KEY, OBS_KEY_F23};
+	obs_key_combination_t other_key = {INTERACT_CONTROL_KEY | INTERACT_SHIFT_KEY, OBS_KEY_F22};
+
+	assert_int_equal(os_event_init(&state.released, OS_EVENT_TYPE_AUTO), 0);
+
+	obs_hotkey_id id = obs_hotkey_register_frontend("test-modifiers", "Test modifiers", hotkey_func, &state);
+	obs_hotkey_load_bindings(id, &combo, 1);
+
+	/* modifiers are strict by default */
+	obs_hotkey_inject_event(partial, true);
+	assert_int_equal(os_atomic_load_long(&state.presses), 0);
+
+	obs_hotkey_inject_event(other_key, true);
+	assert_int_equal(os_atomic_load_long(&state.presses), 0);
+
+	obs_hotkey_inject_event(combo, true);
+	assert_int_equal(os_atomic_load_long(&state.presses), 1);
+	assert_int_equal(os_event_timedwait(state.released, 500), 0);
+
+	/* bindings removed while pressed are released */
+	obs_hotkey_inject_event(combo, true);
+	assert_int_equal(os_atomic_load_long(&state.presses), 2);
+	obs_hotkey_load_bindings(id, NULL, 0);
+	assert_int_equal(os_atomic_load_long(&state.releases), 2);
+
+	obs_hotkey_unregister(id);
+	os_event_destroy(state.released);
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(inject_latency_test),
+		cmocka_unit_test(modifiers_test),
+	};
+
+	return cmocka_run_group_tests(tests, setup, teardown);
+}
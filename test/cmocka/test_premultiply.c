@@ -0,0 +1,80 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdint.h>
+
+#include <util/bmem.h>
+#include <graphics/srgb.h>
+
+/* One texel for every color and alpha pair, plus a few left over so the
+ * texels after the last full SIMD block are covered too */
+#define ALL_PAIRS (256 * 256 + 3)
+
+static void fill_all_pairs(uint8_t *data)
+{
+	for (size_t i = 0; i < ALL_PAIRS; i++) {
+		data[i * 4 + 0] = (uint8_t)i;
+		data[i * 4 + 1] = (uint8_t)(255 - i);
+		data[i * 4 + 2] = (uint8_t)(i * 7);
+		data[i * 4 + 3] = (uint8_t)(i >> 8);
+	}
+}
+
+static void premultiply_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	uint8_t *src = bmalloc(ALL_PAIRS * 4);
+	uint8_t *dst = bmalloc(ALL_PAIRS * 4);
+
+	fill_all_pairs(src);
+	gs_premultiply_xyza_texels(dst, src, ALL_PAIRS);
+
+	for (size_t i = 0; i < ALL_PAIRS; i++) {
+		uint8_t expected[4];
+		gs_premultiply_xyza_restrict(expected, src + i * 4);
+		assert_memory_equal(dst + i * 4, expected, 4);
+	}
+
+	/* in place */
+	gs_premultiply_xyza_loop(src, ALL_PAIRS);
+	assert_memory_equal(src, dst, ALL_PAIRS * 4);
+
+	bfree(src);
+	bfree(dst);
+}
+
+static void premultiply_srgb_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	uint8_t *src = bmalloc(ALL_PAIRS * 4);
+	uint8_t *dst = bmalloc(ALL_PAIRS * 4);
+
+	fill_all_pairs(src);
+	gs_premultiply_xyza_srgb_texels(dst, src, ALL_PAIRS);
+
+	for (size_t i = 0; i < ALL_PAIRS; i++) {
+		uint8_t expected[4];
+		gs_premultiply_xyza_srgb_restrict(expected, src + i * 4);
+		assert_memory_equal(dst + i * 4, expected, 4);
+	}
+
+	gs_premultiply_xyza_srgb_loop(src, ALL_PAIRS);
+	assert_memory_equal(src, dst, ALL_PAIRS * 4);
+
+	bfree(src);
+	bfree(dst);
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(premultiply_test),
+		cmocka_unit_test(premultiply_srgb_test),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,253 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <obs.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <util/source-profiler.h>
+
+#define BASE_SIZE 64
+#define SOURCE_SIZE 16
+#define WAIT_FRAMES 10
+
+struct counting_source {
+	volatile long renders;
+};
+
+static pthread_mutex_t frames_mutex;
+static long frames = 0;
+static bool started = false;
+
+static const char *counting_get_name(void *type_data)
+{
+	UNUSED_PARAMETER(type_data);
+	return "Counting";
+}
+
+static void *counting_create(obs_data_t *settings, obs_source_t *source)
+{
+	UNUSED_PARAMETER(settings);
+	UNUSED_PARAMETER(source);
+
+	return bzalloc(sizeof(struct counting_source));
+}
+
+static void counting_destroy(void *data)
+{
+	bfree(data);
+}
+
+static uint32_t counting_get_size(void *data)
+{
+	UNUSED_PARAMETER(data);
+	return SOURCE_SIZE;
+}
+
+/* draws nothing, only the number of times the scene rendered it matters */
+static void counting_render(void *data, gs_effect_t *effect)
+{
+	UNUSED_PARAMETER(effect);
+
+	struct counting_source *context = data;
+	os_atomic_inc_long(&context->renders);
+}
+
+static struct obs_source_info counting_source_info = {
+	.id = "test_counting",
+	.type = OBS_SOURCE_TYPE_INPUT,
+	.output_flags = OBS_SOURCE_VIDEO,
+	.get_name = counting_get_name,
+	.create = counting_create,
+	.destroy = counting_destroy,
+	.get_width = counting_get_size,
+	.get_height = counting_get_size,
+	.video_render = counting_render,
+};
+
+static void raw_video(void *param, struct video_data *frame)
+{
+	UNUSED_PARAMETER(param);
+	UNUSED_PARAMETER(frame);
+
+	pthread_mutex_lock(&frames_mutex);
+	frames++;
+	pthread_mutex_unlock(&frames_mutex);
+}
+
+static int setup(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	struct obs_video_info ovi = {
+		.graphics_module = "libobs-null",
+		.fps_num = 60,
+		.fps_den = 1,
+		.base_width = BASE_SIZE,
+		.base_height = BASE_SIZE,
+		.output_width = BASE_SIZE,
+		.output_height = BASE_SIZE,
+		.output_format = VIDEO_FORMAT_RGBA,
+		.colorspace = VIDEO_CS_SRGB,
+		.range = VIDEO_RANGE_FULL,
+		.scale_type = OBS_SCALE_BILINEAR,
+	};
+
+	pthread_mutex_init(&frames_mutex, NULL);
+
+	if (!obs_startup("en-US", NULL, NULL))
+		return 0;
+
+	obs_register_source(&counting_source_info);
+
+	/* needs the null renderer module and the libobs effects */
+	if (obs_reset_video(&ovi) != OBS_VIDEO_SUCCESS) {
+		print_message("Could not start video with the null renderer\n");
+		return 0;
+	}
+
+	obs_add_raw_video_callback(NULL, raw_video, NULL);
+	started = true;
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	if (started)
+		obs_remove_raw_video_callback(raw_video, NULL);
+
+	if (obs_initialized())
+		obs_shutdown();
+	pthread_mutex_destroy(&frames_mutex);
+	return 0;
+}
+
+static void wait_frames(long count)
+{
+	long start, current;
+
+	pthread_mutex_lock(&frames_mutex);
+	start = frames;
+	pthread_mutex_unlock(&frames_mutex);
+
+	for (int i = 0; i < 500; i++) {
+		os_sleep_ms(10);
+
+		pthread_mutex_lock(&frames_mutex);
+		current = frames;
+		pthread_mutex_unlock(&frames_mutex);
+
+		if (current - start >= count)
+			return;
+	}
+
+	fail_msg("Timed out waiting for video frames");
+}
+
+static long get_renders(obs_source_t *source)
+{
+	struct counting_source *context = obs_obj_get_data(source);
+	return os_atomic_load_long(&context->renders);
+}
+
+static obs_sceneitem_t *add_item(obs_scene_t *scene, obs_source_t *source, float x, float y)
+{
+	obs_sceneitem_t *item = obs_scene_add(scene, source);
+	struct vec2 pos;
+
+	vec2_set(&pos, x, y);
+	obs_sceneitem_set_pos(item, &pos);
+	return item;
+}
+
+/* Only items that reach into the canvas are drawn, the others are counted
+ * as culled by the scene that skipped them */
+static void off_canvas_item_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	if (!started)
+		skip();
+
+	obs_source_t *visible = obs_source_create_private("test_counting", "visible", NULL);
+	obs_source_t *hidden = obs_source_create_private("test_counting", "hidden", NULL);
+	obs_scene_t *scene = obs_scene_create_private("cull test");
+	profiler_result_t result = {0};
+
+	add_item(scene, visible, 8.0f, 8.0f);
+	obs_sceneitem_t *item = add_item(scene, hidden, BASE_SIZE + 8.0f, 8.0f);
+
+	obs_set_output_source(0, obs_scene_get_source(scene));
+	wait_frames(WAIT_FRAMES);
+
+	assert_true(get_renders(visible) > 0);
+	assert_int_equal(get_renders(hidden), 0);
+
+	/* only sample frames in which the scene was shown */
+	source_profiler_enable(true);
+	wait_frames(WAIT_FRAMES);
+	assert_true(source_profiler_fill_result(obs_scene_get_source(scene), &result));
+	source_profiler_enable(false);
+
+	assert_int_equal(result.items_culled_avg, 1);
+
+	/* moving it back onto the canvas draws it again */
+	struct vec2 pos;
+	vec2_set(&pos, BASE_SIZE - 8.0f, 8.0f);
+	obs_sceneitem_set_pos(item, &pos);
+	wait_frames(WAIT_FRAMES);
+
+	assert_true(get_renders(hidden) > 0);
+
+	obs_set_output_source(0, NULL);
+	obs_scene_release(scene);
+	obs_source_release(visible);
+	obs_source_release(hidden);
+}
+
+/* A nested scene that is off-canvas is culled as a whole, but still has to
+ * drop the items of sources that were removed while it was culled */
+static void off_canvas_nested_scene_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	if (!started)
+		skip();
+
+	obs_source_t *nested_source = obs_source_create_private("test_counting", "nested", NULL);
+	obs_scene_t *nested = obs_scene_create_private("nested cull test");
+	obs_scene_t *scene = obs_scene_create_private("cull test");
+
+	add_item(nested, nested_source, 8.0f, 8.0f);
+	add_item(scene, obs_scene_get_source(nested), -2.0f * BASE_SIZE, 0.0f);
+
+	obs_set_output_source(0, obs_scene_get_source(scene));
+	wait_frames(WAIT_FRAMES);
+
+	assert_int_equal(get_renders(nested_source), 0);
+	assert_non_null(obs_scene_find_source(nested, "nested"));
+
+	obs_source_remove(nested_source);
+	wait_frames(WAIT_FRAMES);
+
+	assert_null(obs_scene_find_source(nested, "nested"));
+	assert_int_equal(get_renders(nested_source), 0);
+
+	obs_set_output_source(0, NULL);
+	obs_scene_release(scene);
+	obs_scene_release(nested);
+	obs_source_release(nested_source);
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(off_canvas_item_test),
+		cmocka_unit_test(off_canvas_nested_scene_test),
+	};
+
+	return cmocka_run_group_tests(tests, setup, teardown);
+}
@@ -0,0 +1,106 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <obs-scene.h>
+
+/* Builds the box transform the same way update_item_transform does for an
+ * item without alignment offsets */
+static void set_box(struct obs_scene_item *item, float x, float y, float cx, float cy, float rot)
+{
+	matrix4_identity(&item->box_transform);
+	matrix4_scale3f(&item->box_transform, &item->box_transform, cx, cy, 1.0f);
+	matrix4_rotate_aa4f(&item->box_transform, &item->box_transform, 0.0f, 0.0f, 1.0f, RAD(rot));
+	matrix4_translate3f(&item->box_transform, &item->box_transform, x, y, 0.0f);
+}
+
+static void item_inside_canvas_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	struct obs_scene_item item = {0};
+
+	set_box(&item, 100.0f, 100.0f, 200.0f, 200.0f, 0.0f);
+	assert_true(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+
+	/* item covering the entire canvas */
+	set_box(&item, -100.0f, -100.0f, 4000.0f, 4000.0f, 0.0f);
+	assert_true(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+}
+
+static void item_partially_inside_canvas_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	struct obs_scene_item item = {0};
+
+	set_box(&item, -100.0f, 500.0f, 150.0f, 100.0f, 0.0f);
+	assert_true(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+
+	set_box(&item, 1900.0f, 1000.0f, 100.0f, 100.0f, 0.0f);
+	assert_true(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+}
+
+static void item_outside_canvas_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	struct obs_scene_item item = {0};
+
+	/* left, right, above and below the canvas */
+	set_box(&item, -300.0f, 500.0f, 200.0f, 100.0f, 0.0f);
+	assert_false(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+
+	set_box(&item, 1920.0f, 500.0f, 200.0f, 100.0f, 0.0f);
+	assert_false(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+
+	set_box(&item, 500.0f, -100.0f, 200.0f, 100.0f, 0.0f);
+	assert_false(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+
+	set_box(&item, 500.0f, 1080.0f, 200.0f, 100.0f, 0.0f);
+	assert_false(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+}
+
+static void rotated_item_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	struct obs_scene_item item = {0};
+
+	/* rotated 90 degrees around its top left corner at the left edge of
+	 * the canvas, which moves it entirely off-canvas */
+	set_box(&item, 0.0f, 500.0f, 200.0f, 100.0f, 90.0f);
+	assert_false(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+
+	/* rotated 45 degrees with only a corner reaching into the canvas */
+	set_box(&item, -50.0f, 500.0f, 100.0f, 100.0f, -45.0f);
+	assert_true(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+}
+
+static void flipped_item_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	struct obs_scene_item item = {0};
+
+	/* negative scale flips the item to the left of its position */
+	set_box(&item, 100.0f, 500.0f, -200.0f, 100.0f, 0.0f);
+	assert_true(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+
+	set_box(&item, 0.0f, 500.0f, -200.0f, 100.0f, 0.0f);
+	assert_false(obs_scene_item_box_on_canvas(&item, 1920.0f, 1080.0f));
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(item_inside_canvas_test),
+		cmocka_unit_test(item_partially_inside_canvas_test),
+		cmocka_unit_test(item_outside_canvas_test),
+		cmocka_unit_test(rotated_item_test),
+		cmocka_unit_test(flipped_item_test),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,261 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <obs.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#define BASE_SIZE 64
+#define CANVAS_SIZE 32
+#define PATTERN_SIZE 16
+#define WAIT_FRAMES 10
+
+struct pattern_source {
+	gs_texture_t *tex;
+};
+
+struct capture {
+	pthread_mutex_t mutex;
+	uint8_t pixels[BASE_SIZE * BASE_SIZE * 4];
+	long frames;
+};
+
+static struct capture capture;
+static obs_canvas_t *canvas = NULL;
+static bool started = false;
+
+static const char *pattern_get_name(void *type_data)
+{
+	UNUSED_PARAMETER(type_data);
+	return "Pattern";
+}
+
+/* every alpha from fully transparent to opaque, so that blending the shared
+ * texture differently from the source would show */
+static void *pattern_create(obs_data_t *settings, obs_source_t *source)
+{
+	UNUSED_PARAMETER(settings);
+	UNUSED_PARAMETER(source);
+
+	struct pattern_source *context = bzalloc(sizeof(struct pattern_source));
+	uint8_t data[PATTERN_SIZE * PATTERN_SIZE * 4];
+	const uint8_t *planes[] = {data};
+
+	for (int y = 0; y < PATTERN_SIZE; y++) {
+		for (int x = 0; x < PATTERN_SIZE; x++) {
+			uint8_t *pixel = data + (y * PATTERN_SIZE + x) * 4;
+			pixel[0] = (uint8_t)(x * 16);
+			pixel[1] = (uint8_t)(y * 16);
+			pixel[2] = (uint8_t)(255 - x * 8);
+			pixel[3] = (uint8_t)(y * PATTERN_SIZE + x);
+		}
+	}
+
+	obs_enter_graphics();
+	context->tex = gs_texture_create(PATTERN_SIZE, PATTERN_SIZE, GS_RGBA, 1, planes, 0);
+	obs_leave_graphics();
+	return context;
+}
+
+static void pattern_destroy(void *data)
+{
+	struct pattern_source *context = data;
+
+	obs_enter_graphics();
+	gs_texture_destroy(context->tex);
+	obs_leave_graphics();
+	bfree(context);
+}
+
+static uint32_t pattern_get_size(void *data)
+{
+	UNUSED_PARAMETER(data);
+	return PATTERN_SIZE;
+}
+
+static void pattern_render(void *data, gs_effect_t *effect)
+{
+	UNUSED_PARAMETER(effect);
+
+	struct pattern_source *context = data;
+	obs_source_draw(context->tex, 0, 0, 0, 0, false);
+}
+
+static struct obs_source_info pattern_source_info = {
+	.id = "test_pattern",
+	.type = OBS_SOURCE_TYPE_INPUT,
+	.output_flags = OBS_SOURCE_VIDEO,
+	.get_name = pattern_get_name,
+	.create = pattern_create,
+	.destroy = pattern_destroy,
+	.get_width = pattern_get_size,
+	.get_height = pattern_get_size,
+	.video_render = pattern_render,
+};
+
+static void raw_video(void *param, struct video_data *frame)
+{
+	UNUSED_PARAMETER(param);
+
+	pthread_mutex_lock(&capture.mutex);
+	for (int y = 0; y < BASE_SIZE; y++)
+		memcpy(capture.pixels + y * BASE_SIZE * 4, frame->data[0] + y * frame->linesize[0], BASE_SIZE * 4);
+	capture.frames++;
+	pthread_mutex_unlock(&capture.mutex);
+}
+
+static void set_video_info(struct obs_video_info *ovi, uint32_t size)
+{
+	ovi->graphics_module = "libobs-null";
+	ovi->fps_num = 60;
+	ovi->fps_den = 1;
+	ovi->base_width = size;
+	ovi->base_height = size;
+	ovi->output_width = size;
+	ovi->output_height = size;
+	ovi->output_format = VIDEO_FORMAT_RGBA;
+	ovi->colorspace = VIDEO_CS_SRGB;
+	ovi->range = VIDEO_RANGE_FULL;
+	ovi->scale_type = OBS_SCALE_BILINEAR;
+	ovi->gpu_conversion = false;
+}
+
+static int setup(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	struct obs_video_info ovi = {0};
+
+	pthread_mutex_init(&capture.mutex, NULL);
+
+	if (!obs_startup("en-US", NULL, NULL))
+		return 0;
+
+	/* the same source, once as a shareable one */
+	obs_register_source(&pattern_source_info);
+	pattern_source_info.id = "test_pattern_shareable";
+	pattern_source_info.output_flags |= OBS_SOURCE_SHAREABLE;
+	obs_register_source(&pattern_source_info);
+
+	/* needs the null renderer module and the libobs effects */
+	set_video_info(&ovi, BASE_SIZE);
+	if (obs_reset_video(&ovi) != OBS_VIDEO_SUCCESS) {
+		print_message("Could not start video with the null renderer\n");
+		return 0;
+	}
+
+	set_video_info(&ovi, CANVAS_SIZE);
+	canvas = obs_canvas_create_private("shared render test", &ovi, 0);
+	if (!canvas)
+		return 0;
+
+	obs_add_raw_video_callback(NULL, raw_video, NULL);
+	started = true;
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	if (canvas) {
+		obs_remove_raw_video_callback(raw_video, NULL);
+		obs_canvas_remove(canvas);
+		obs_canvas_release(canvas);
+	}
+
+	if (obs_initialized())
+		obs_shutdown();
+	pthread_mutex_destroy(&capture.mutex);
+	return 0;
+}
+
+static void wait_frames(long count)
+{
+	long start, frames;
+
+	pthread_mutex_lock(&capture.mutex);
+	start = capture.frames;
+	pthread_mutex_unlock(&capture.mutex);
+
+	for (int i = 0; i < 500; i++) {
+		os_sleep_ms(10);
+
+		pthread_mutex_lock(&capture.mutex);
+		frames = capture.frames;
+		pthread_mutex_unlock(&capture.mutex);
+
+		if (frames - start >= count)
+			return;
+	}
+
+	fail_msg("Timed out waiting for video frames");
+}
+
+/* Shows the source twice, overlapping, in the main canvas and once in the
+ * second canvas, and captures the main canvas output */
+static uint64_t render_pattern(const char *id, uint8_t *pixels)
+{
+	struct obs_canvas_render_stats before, after;
+	obs_canvas_t *main_canvas = obs_get_main_canvas();
+	obs_source_t *source = obs_source_create_private(id, "pattern", NULL);
+	obs_scene_t *scene = obs_scene_create_private("shared render test");
+	struct vec2 pos;
+
+	assert_non_null(source);
+
+	vec2_set(&pos, 4.0f, 4.0f);
+	obs_sceneitem_set_pos(obs_scene_add(scene, source), &pos);
+	vec2_set(&pos, 12.0f, 10.0f);
+	obs_sceneitem_set_pos(obs_scene_add(scene, source), &pos);
+
+	obs_set_output_source(0, obs_scene_get_source(scene));
+	obs_canvas_set_channel(canvas, 0, source);
+
+	wait_frames(WAIT_FRAMES);
+
+	obs_canvas_get_render_stats(main_canvas, &before);
+	wait_frames(WAIT_FRAMES);
+	obs_canvas_get_render_stats(main_canvas, &after);
+
+	pthread_mutex_lock(&capture.mutex);
+	memcpy(pixels, capture.pixels, sizeof(capture.pixels));
+	pthread_mutex_unlock(&capture.mutex);
+
+	obs_set_output_source(0, NULL);
+	obs_canvas_set_channel(canvas, 0, NULL);
+	obs_scene_release(scene);
+	obs_source_release(source);
+	obs_canvas_release(main_canvas);
+
+	return after.shared_renders - before.shared_renders;
+}
+
+static void shared_render_pixels_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	static uint8_t rendered[BASE_SIZE * BASE_SIZE * 4];
+	static uint8_t shared[BASE_SIZE * BASE_SIZE * 4];
+	static const uint8_t cleared[BASE_SIZE * BASE_SIZE * 4] = {0};
+
+	if (!started)
+		skip();
+
+	assert_int_equal(render_pattern("test_pattern", rendered), 0);
+	assert_true(render_pattern("test_pattern_shareable", shared) > 0);
+
+	assert_memory_not_equal(rendered, cleared, sizeof(rendered));
+	assert_memory_equal(rendered, shared, sizeof(rendered));
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(shared_render_pixels_test),
+	};
+
+	return cmocka_run_group_tests(tests, setup, teardown);
+}
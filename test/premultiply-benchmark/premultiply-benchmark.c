@@ -0,0 +1,65 @@
+/*
+ * Measures premultiplying an RGBA image with the row functions image loading
+ * uses against the per-texel float path it used before.
+ *
+ * Usage: premultiply-benchmark [width height]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <graphics/srgb.h>
+
+int main(int argc, char *argv[])
+{
+	uint32_t cx = 3840;
+	uint32_t cy = 2160;
+
+	if (argc == 3) {
+		cx = (uint32_t)strtoul(argv[1], NULL, 10);
+		cy = (uint32_t)strtoul(argv[2], NULL, 10);
+	}
+	if (!cx || !cy) {
+		fprintf(stderr, "Usage: %s [width height]\n", argv[0]);
+		return 1;
+	}
+
+	const size_t count = (size_t)cx * cy;
+	uint8_t *src = bmalloc(count * 4);
+	uint8_t *dst = bmalloc(count * 4);
+	uint64_t start;
+
+	srand(1);
+	for (size_t i = 0; i < count * 4; i++)
+		src[i] = (uint8_t)rand();
+
+	start = os_gettime_ns();
+	for (size_t i = 0; i < count; i++)
+		gs_premultiply_xyza_restrict(dst + i * 4, src + i * 4);
+	const uint64_t scalar_ns = os_gettime_ns() - start;
+
+	start = os_gettime_ns();
+	gs_premultiply_xyza_texels(dst, src, count);
+	const uint64_t simd_ns = os_gettime_ns() - start;
+
+	start = os_gettime_ns();
+	for (size_t i = 0; i < count; i++)
+		gs_premultiply_xyza_srgb_restrict(dst + i * 4, src + i * 4);
+	const uint64_t srgb_scalar_ns = os_gettime_ns() - start;
+
+	start = os_gettime_ns();
+	gs_premultiply_xyza_srgb_texels(dst, src, count);
+	const uint64_t srgb_table_ns = os_gettime_ns() - start;
+
+	printf("premultiply %" PRIu32 "x%" PRIu32 ":      scalar %8.2f ms, SIMD  %8.2f ms\n", cx, cy,
+	       (double)scalar_ns / 1000000.0, (double)simd_ns / 1000000.0);
+	printf("premultiply sRGB %" PRIu32 "x%" PRIu32 ": scalar %8.2f ms, table %8.2f ms\n", cx, cy,
+	       (double)srgb_scalar_ns / 1000000.0, (double)srgb_table_ns / 1000000.0);
+
+	bfree(src);
+	bfree(dst);
+	return 0;
+}
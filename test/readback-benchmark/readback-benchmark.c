@@ -0,0 +1,105 @@
+/*
+ * Measures raw video readback with the null renderer for every supported
+ * readback depth.  Set OBS_NULL_READBACK_LATENCY_MS to simulate the time a GPU
+ * takes to finish copying a frame into a stage surface.
+ *
+ * Usage: readback-benchmark [width height fps seconds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <util/platform.h>
+#include <util/threading.h>
+#include <obs.h>
+
+static volatile long frames_received = 0;
+
+static void raw_video(void *param, struct video_data *frame)
+{
+	os_atomic_inc_long(&frames_received);
+
+	UNUSED_PARAMETER(param);
+	UNUSED_PARAMETER(frame);
+}
+
+static bool run(uint32_t depth, uint32_t cx, uint32_t cy, uint32_t fps, uint32_t seconds)
+{
+	struct obs_video_readback_stats stats;
+	struct obs_video_info ovi = {0};
+	uint32_t lagged;
+
+	ovi.graphics_module = "libobs-null";
+	ovi.fps_num = fps;
+	ovi.fps_den = 1;
+	ovi.base_width = cx;
+	ovi.base_height = cy;
+	ovi.output_width = cx;
+	ovi.output_height = cy;
+	ovi.output_format = VIDEO_FORMAT_NV12;
+	ovi.colorspace = VIDEO_CS_709;
+	ovi.range = VIDEO_RANGE_PARTIAL;
+	ovi.scale_type = OBS_SCALE_BICUBIC;
+	ovi.gpu_conversion = true;
+
+	if (!obs_set_video_readback_depth(depth))
+		return false;
+	if (obs_reset_video(&ovi) != OBS_VIDEO_SUCCESS) {
+		fprintf(stderr, "Failed to start video with the null renderer\n");
+		return false;
+	}
+
+	os_atomic_set_long(&frames_received, 0);
+	lagged = obs_get_lagged_frames();
+	obs_add_raw_video_callback(NULL, raw_video, NULL);
+	os_sleep_ms(seconds * 1000);
+	obs_remove_raw_video_callback(raw_video, NULL);
+
+	obs_get_video_readback_stats(&stats);
+
+	printf("%5" PRIu32 " %8ld %8" PRIu32 " %10.2f %10.2f %8.3f %8.3f %8.3f\n", depth,
+	       os_atomic_load_long(&frames_received), obs_get_lagged_frames() - lagged,
+	       (double)stats.avg_latency_ns / 1000000.0, (double)stats.max_latency_ns / 1000000.0,
+	       (double)stats.avg_map_ns / 1000000.0, (double)stats.avg_copy_ns / 1000000.0,
+	       (double)stats.avg_wait_ns / 1000000.0);
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t cx = 3840;
+	uint32_t cy = 2160;
+	uint32_t fps = 60;
+	uint32_t seconds = 10;
+	int ret = 0;
+
+	if (argc == 5) {
+		cx = (uint32_t)strtoul(argv[1], NULL, 10);
+		cy = (uint32_t)strtoul(argv[2], NULL, 10);
+		fps = (uint32_t)strtoul(argv[3], NULL, 10);
+		seconds = (uint32_t)strtoul(argv[4], NULL, 10);
+	} else if (argc != 1) {
+		fprintf(stderr, "Usage: %s [width height fps seconds]\n", argv[0]);
+		return 1;
+	}
+
+	if (!obs_startup("en-US", NULL, NULL)) {
+		fprintf(stderr, "Failed to start libobs\n");
+		return 1;
+	}
+
+	printf("%" PRIu32 "x%" PRIu32 " NV12 at %" PRIu32 " fps, %" PRIu32 " seconds per depth\n\n", cx, cy, fps,
+	       seconds);
+	printf("depth   frames   lagged latency ms     max ms   map ms  copy ms  wait ms\n");
+
+	for (uint32_t depth = 2; depth <= 4; depth++) {
+		if (!run(depth, cx, cy, fps, seconds)) {
+			ret = 1;
+			break;
+		}
+	}
+
+	obs_shutdown();
+	return ret;
+}
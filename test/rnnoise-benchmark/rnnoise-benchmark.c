@@ -0,0 +1,286 @@
+/*
+ * Runs the bundled RNNoise denoiser over synthetic 48 kHz stereo audio and
+ * reports how many times faster than realtime it is.  The network alone is
+ * also run with the scalar dense/GRU layers RNNoise originally shipped with,
+ * which gives the realtime factor of the denoiser before the layers were
+ * vectorized.
+ *
+ * Usage: rnnoise-benchmark [seconds]  (default: one hour)
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rnnoise.h"
+#include "rnn.h"
+#include "rnn_data.h"
+#include "tansig_table.h"
+
+#define SAMPLE_RATE 48000
+#define FRAME_SIZE 480
+#define CHANNELS 2
+#define FEATURES 42
+#define TWO_PI 6.283185307179586
+
+/* Ten seconds of audio, looped */
+#define SIGNAL_FRAMES (SAMPLE_RATE / FRAME_SIZE * 10)
+
+extern const struct RNNModel rnnoise_model_orig;
+
+static double now(void)
+{
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+static uint32_t rng_state = 1;
+
+static float random_float(void)
+{
+	rng_state = rng_state * 1664525u + 1013904223u;
+	return (float)(rng_state >> 8) / (float)(1 << 24) * 2.0f - 1.0f;
+}
+
+/* Speech-ish tones with noise on top, in the 16-bit range RNNoise expects */
+static float *generate_signal(int channel)
+{
+	float *signal = malloc(sizeof(float) * SIGNAL_FRAMES * FRAME_SIZE);
+	const double freq = 180.0 + 40.0 * channel;
+
+	for (size_t i = 0; i < (size_t)SIGNAL_FRAMES * FRAME_SIZE; i++) {
+		const double t = (double)i / SAMPLE_RATE;
+		const double envelope = 0.5 + 0.5 * sin(TWO_PI * 3.0 * t);
+		const double voice = sin(TWO_PI * freq * t) + 0.5 * sin(TWO_PI * freq * 2.0 * t);
+
+		signal[i] = (float)(8000.0 * envelope * voice) + 1500.0f * random_float();
+	}
+
+	return signal;
+}
+
+/* ------------------------------------------------------------------------- */
+/* The network as originally shipped, one neuron at a time                   */
+
+static float ref_tansig_approx(float x)
+{
+	int i;
+	float y, dy;
+	float sign = 1;
+	if (!(x < 8))
+		return 1;
+	if (!(x > -8))
+		return -1;
+	if (x != x)
+		return 0;
+	if (x < 0) {
+		x = -x;
+		sign = -1;
+	}
+	i = (int)floor(.5f + 25 * x);
+	x -= .04f * i;
+	y = tansig_table[i];
+	dy = 1 - y * y;
+	y = y + x * dy * (1 - y * x);
+	return sign * y;
+}
+
+static float ref_sigmoid_approx(float x)
+{
+	return (float)(.5 + .5 * ref_tansig_approx(.5f * x));
+}
+
+static float ref_activation(int activation, float x)
+{
+	if (activation == ACTIVATION_SIGMOID)
+		return ref_sigmoid_approx(x);
+	if (activation == ACTIVATION_TANH)
+		return ref_tansig_approx(x);
+	return x < 0 ? 0 : x;
+}
+
+static void ref_compute_dense(const DenseLayer *layer, float *output, const float *input)
+{
+	const int M = layer->nb_inputs;
+	const int N = layer->nb_neurons;
+
+	for (int i = 0; i < N; i++) {
+		float sum = layer->bias[i];
+		for (int j = 0; j < M; j++)
+			sum += layer->input_weights[j * N + i] * input[j];
+		output[i] = ref_activation(layer->activation, WEIGHTS_SCALE * sum);
+	}
+}
+
+static void ref_compute_gru(const GRULayer *gru, float *state, const float *input)
+{
+	const int M = gru->nb_inputs;
+	const int N = gru->nb_neurons;
+	const int stride = 3 * N;
+	float z[MAX_NEURONS];
+	float r[MAX_NEURONS];
+	float h[MAX_NEURONS];
+
+	for (int i = 0; i < N; i++) {
+		float sum = gru->bias[i];
+		for (int j = 0; j < M; j++)
+			sum += gru->input_weights[j * stride + i] * input[j];
+		for (int j = 0; j < N; j++)
+			sum += gru->recurrent_weights[j * stride + i] * state[j];
+		z[i] = ref_sigmoid_approx(WEIGHTS_SCALE * sum);
+	}
+	for (int i = 0; i < N; i++) {
+		float sum = gru->bias[N + i];
+		for (int j = 0; j < M; j++)
+			sum += gru->input_weights[N + j * stride + i] * input[j];
+		for (int j = 0; j < N; j++)
+			sum += gru->recurrent_weights[N + j * stride + i] * state[j];
+		r[i] = ref_sigmoid_approx(WEIGHTS_SCALE * sum);
+	}
+	for (int i = 0; i < N; i++) {
+		float sum = gru->bias[2 * N + i];
+		for (int j = 0; j < M; j++)
+			sum += gru->input_weights[2 * N + j * stride + i] * input[j];
+		for (int j = 0; j < N; j++)
+			sum += gru->recurrent_weights[2 * N + j * stride + i] * state[j] * r[j];
+		sum = ref_activation(gru->activation, WEIGHTS_SCALE * sum);
+		h[i] = z[i] * state[i] + (1 - z[i]) * sum;
+	}
+	memcpy(state, h, sizeof(float) * N);
+}
+
+static void ref_compute_rnn(RNNState *rnn, float *gains, float *vad, const float *input)
+{
+	const RNNModel *model = rnn->model;
+	float dense_out[MAX_NEURONS];
+	float noise_input[MAX_NEURONS * 3];
+	float denoise_input[MAX_NEURONS * 3];
+	int i;
+
+	ref_compute_dense(model->input_dense, dense_out, input);
+	ref_compute_gru(model->vad_gru, rnn->vad_gru_state, dense_out);
+	ref_compute_dense(model->vad_output, vad, rnn->vad_gru_state);
+	for (i = 0; i < model->input_dense_size; i++)
+		noise_input[i] = dense_out[i];
+	for (i = 0; i < model->vad_gru_size; i++)
+		noise_input[i + model->input_dense_size] = rnn->vad_gru_state[i];
+	for (i = 0; i < FEATURES; i++)
+		noise_input[i + model->input_dense_size + model->vad_gru_size] = input[i];
+	ref_compute_gru(model->noise_gru, rnn->noise_gru_state, noise_input);
+
+	for (i = 0; i < model->vad_gru_size; i++)
+		denoise_input[i] = rnn->vad_gru_state[i];
+	for (i = 0; i < model->noise_gru_size; i++)
+		denoise_input[i + model->vad_gru_size] = rnn->noise_gru_state[i];
+	for (i = 0; i < FEATURES; i++)
+		denoise_input[i + model->vad_gru_size + model->noise_gru_size] = input[i];
+	ref_compute_gru(model->denoise_gru, rnn->denoise_gru_state, denoise_input);
+	ref_compute_dense(model->denoise_output, gains, rnn->denoise_gru_state);
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void init_rnn_state(RNNState *rnn, float *state)
+{
+	const RNNModel *model = &rnnoise_model_orig;
+
+	rnn->model = model;
+	rnn->vad_gru_state = state;
+	rnn->noise_gru_state = state + model->vad_gru_size;
+	rnn->denoise_gru_state = state + model->vad_gru_size + model->noise_gru_size;
+	memset(state, 0, sizeof(float) * (model->vad_gru_size + model->noise_gru_size + model->denoise_gru_size));
+}
+
+/* Runs the network alone on random features and returns the time taken.
+ * gains_sum is used to check that both implementations agree. */
+static double run_network(size_t frames, bool reference, float *gains_sum)
+{
+	float state[CHANNELS][MAX_NEURONS * 3];
+	RNNState rnn[CHANNELS];
+	float input[FEATURES];
+	float gains[22];
+	float vad;
+
+	for (int c = 0; c < CHANNELS; c++)
+		init_rnn_state(&rnn[c], state[c]);
+
+	rng_state = 1;
+	*gains_sum = 0.0f;
+
+	const double start = now();
+	for (size_t f = 0; f < frames; f++) {
+		for (int c = 0; c < CHANNELS; c++) {
+			for (int i = 0; i < FEATURES; i++)
+				input[i] = random_float();
+
+			if (reference)
+				ref_compute_rnn(&rnn[c], gains, &vad, input);
+			else
+				compute_rnn(&rnn[c], gains, &vad, input);
+
+			*gains_sum += gains[f % 22];
+		}
+	}
+	return now() - start;
+}
+
+int main(int argc, char *argv[])
+{
+	double seconds = 3600.0;
+	float *signal[CHANNELS];
+	DenoiseState *states[CHANNELS];
+	float frame[FRAME_SIZE];
+
+	if (argc == 2)
+		seconds = strtod(argv[1], NULL);
+	if (seconds <= 0.0) {
+		fprintf(stderr, "Usage: %s [seconds]\n", argv[0]);
+		return 1;
+	}
+
+	const size_t frames = (size_t)(seconds * SAMPLE_RATE / FRAME_SIZE);
+
+	for (int c = 0; c < CHANNELS; c++) {
+		signal[c] = generate_signal(c);
+		states[c] = rnnoise_create(NULL);
+	}
+
+	printf("Denoising %.0f seconds of %d Hz stereo audio (%zu frames per channel)\n", seconds, SAMPLE_RATE,
+	       frames);
+
+	double start = now();
+	for (size_t f = 0; f < frames; f++) {
+		for (int c = 0; c < CHANNELS; c++) {
+			memcpy(frame, signal[c] + (f % SIGNAL_FRAMES) * FRAME_SIZE, sizeof(frame));
+			rnnoise_process_frame(states[c], frame, frame);
+		}
+	}
+	const double denoise_time = now() - start;
+
+	float gains_new, gains_ref;
+	const double network_time = run_network(frames, false, &gains_new);
+	const double reference_time = run_network(frames, true, &gains_ref);
+	const double before_time = denoise_time - network_time + reference_time;
+
+	printf("%-28s %10s %12s\n", "", "time (s)", "realtime x");
+	printf("%-28s %10.2f %12.1f\n", "denoiser", denoise_time, seconds / denoise_time);
+	printf("%-28s %10.2f %12.1f\n", "network", network_time, seconds / network_time);
+	printf("%-28s %10.2f %12.1f\n", "network, original layers", reference_time, seconds / reference_time);
+	printf("%-28s %10.2f %12.1f\n", "denoiser, original layers", before_time, seconds / before_time);
+
+	if (gains_new != gains_ref)
+		printf("warning: the network output differs from the original layers (%f vs %f)\n", gains_new,
+		       gains_ref);
+
+	for (int c = 0; c < CHANNELS; c++) {
+		rnnoise_destroy(states[c]);
+		free(signal[c]);
+	}
+
+	return gains_new == gains_ref ? 0 : 1;
+}